@@ -64,6 +64,36 @@
 #define APP_VBUS_POLL_ADC_INPUT                 (CY_USBPD_ADC_INPUT_AMUX_B)
 #endif /* defined(CY_DEVICE_CCG3) */
 
+/*
+ * Interrupt priorities (0 = highest, 3 = lowest). Each can be overridden per
+ * build from the DEFINES list in the Makefile. The PD stack expects the USBPD
+ * and WDT interrupts to share the highest priority; changing this should be
+ * validated against the ISR_STATS_ENABLE measurements.
+ */
+#ifndef APP_USBPD_INTR0_PRIORITY
+#define APP_USBPD_INTR0_PRIORITY                (0u)
+#endif /* APP_USBPD_INTR0_PRIORITY */
+
+#ifndef APP_USBPD_INTR1_PRIORITY
+#define APP_USBPD_INTR1_PRIORITY                (0u)
+#endif /* APP_USBPD_INTR1_PRIORITY */
+
+#ifndef APP_WDT_INTR_PRIORITY
+#define APP_WDT_INTR_PRIORITY                   (0u)
+#endif /* APP_WDT_INTR_PRIORITY */
+
+#ifndef APP_SWITCH_INTR_PRIORITY
+#define APP_SWITCH_INTR_PRIORITY                (3u)
+#endif /* APP_SWITCH_INTR_PRIORITY */
+
+/*
+ * Enable/Disable the interrupt latency and duration statistics of the USBPD
+ * and WDT handlers.
+ */
+#ifndef ISR_STATS_ENABLE
+#define ISR_STATS_ENABLE                        (0u)
+#endif /* ISR_STATS_ENABLE */
+
 /*
  * Enable/Disable firmware active LED operation.
  *
@@ -126,6 +156,408 @@
 /* Voltage step increment */
 #define PPS_STEP                               (100U)
 
+/*
+ * Efficiency search settle timer ID
+ */
+#define EFF_SEARCH_TIMER_ID                    (CY_PDUTILS_TIMER_USER_START_ID + 3u)
+
+/*
+ * Energy accounting sample timer ID
+ */
+#define ENERGY_TIMER_ID                        (CY_PDUTILS_TIMER_USER_START_ID + 4u)
+
+/*
+ * VBUS measurement pipeline sample timer ID
+ */
+#define VBUS_MEAS_TIMER_ID                     (CY_PDUTILS_TIMER_USER_START_ID + 5u)
+
+/*
+ * Sink FET soft-start timer ID of port 0. Port 1 uses the next ID.
+ */
+#define SINK_FET_TIMER_ID                      (CY_PDUTILS_TIMER_USER_START_ID + 6u)
+
+/*
+ * PPS current probing settle timer ID
+ */
+#define CUR_PROBE_TIMER_ID                     (CY_PDUTILS_TIMER_USER_START_ID + 8u)
+
+/*
+ * Direct battery charging settle timer ID
+ */
+#define BATT_CHG_TIMER_ID                      (CY_PDUTILS_TIMER_USER_START_ID + 9u)
+
+
+/*
+ * Nominal number of timestamp ticks per millisecond. Timestamps are taken from
+ * the free running WDT counter which is clocked by the ILO (40 kHz nominal).
+ */
+#define TIMESTAMP_TICKS_PER_MS                 (40u)
+
+/*
+ * Timestamp refresh timer ID
+ */
+#define TIMESTAMP_TIMER_ID                     (CY_PDUTILS_TIMER_USER_START_ID + 10u)
+
+/*
+ * Interval (ms) at which the timestamp is extended from the WDT interrupt
+ * while a port is attached or another module holds the timestamp. Must be
+ * shorter than the 16-bit WDT counter wrap, which is 65536 /
+ * TIMESTAMP_TICKS_PER_MS ms.
+ */
+#define TIMESTAMP_REFRESH_PERIOD               (1000u)
+
+/*
+ * Enable/Disable VCONN Swap for cable discovery. Only the VCONN source may
+ * talk to the cable, so when the source supplies VCONN the sink requests
+ * VCONN Swap before SOP' Discover Identity. Requires a VCONN supply, which
+ * sink only boards usually lack, so it is only enabled by the boards that
+ * have one.
+ */
+#ifndef CABLE_VCONN_SWAP_ENABLE
+#define CABLE_VCONN_SWAP_ENABLE                (0u)
+#endif /* CABLE_VCONN_SWAP_ENABLE */
+
+/*
+ * Enable/Disable the EPR AVS power governor. Requires CY_PD_EPR_ENABLE and
+ * CY_PD_EPR_AVS_ENABLE in the PD stack configuration.
+ */
+#define EPR_GOV_ENABLE                         (1u)
+
+/*
+ * Voltage (mV) requested from the EPR AVS APDO. Rounded down to 100mV.
+ */
+#define EPR_GOV_TARGET_VOLT                    (36000u)
+
+/*
+ * Operating current (mA) requested from the EPR AVS APDO.
+ */
+#define EPR_GOV_TARGET_CUR                     (2000u)
+
+/*
+ * Time (ms) allowed for EPR mode entry before falling back to SPR PPS.
+ */
+#define EPR_GOV_ENTRY_TIMEOUT                  (1000u)
+
+/*
+ * Time (ms) allowed for the source to accept the EPR AVS request before
+ * falling back to SPR PPS.
+ */
+#define EPR_GOV_AVS_TIMEOUT                    (1000u)
+
+/*
+ * Arbitration policy between the legacy charging (BC 1.2, Apple, QC, AFC)
+ * and the USB PD power paths. See en_power_arb_policy_t in power_arb.h.
+ */
+#define POWER_ARB_POLICY                       (POWER_ARB_FASTEST)
+
+/*
+ * Enable/Disable the startup fast path. When enabled, the LED timers are
+ * started once the first explicit contract is established or after
+ * BOOT_DEFER_TIMEOUT, whichever happens first. Connect detection is always
+ * started before the application modules are initialized, and the
+ * instrumentation watchdog before connect detection.
+ */
+#define APP_BOOT_FAST_PATH                     (1u)
+
+/*
+ * Maximum time (ms) after boot that non-critical work is deferred while
+ * waiting for the first explicit contract.
+ */
+#define BOOT_DEFER_TIMEOUT                     (3000u)
+
+/*
+ * Enable/Disable the binary event trace. The trace only stores fixed size
+ * records in a RAM ring buffer and is cheap enough to be left enabled in
+ * production builds.
+ */
+#define TRACE_ENABLE                           (1u)
+
+/*
+ * Number of records held in the trace ring buffer. Must be a power of 2.
+ */
+#define TRACE_BUF_DEPTH                        (32u)
+
+/*
+ * Enable/Disable capture of the source capabilities, sink capabilities and
+ * contract requests seen by the PPS module. The capture buffer can be dumped
+ * and replayed against the PDO selection logic off target, see
+ * test/capture_replay.c.
+ */
+#ifndef PD_CAPTURE_ENABLE
+#define PD_CAPTURE_ENABLE                      (0u)
+#endif /* PD_CAPTURE_ENABLE */
+
+/*
+ * Size of the capture buffer in bytes.
+ */
+#define PD_CAPTURE_BUF_SIZE                    (1024u)
+
+/*
+ * Enable/Disable the charger fingerprint cache. When enabled, the PPS module
+ * resumes from the last good operating point of a known charger on re-attach
+ * instead of restarting the sweep from 5V.
+ */
+#define CHARGER_CACHE_ENABLE                   (1u)
+
+/*
+ * Number of chargers remembered by the fingerprint cache.
+ */
+#define CHARGER_CACHE_SIZE                     (4u)
+
+/*
+ * Delay (ms) between the first explicit contract with a known charger and
+ * the request for its cached operating point.
+ */
+#define PPS_FAST_START_DELAY                   (10u)
+
+/*
+ * Enable/Disable persistence of the charger fingerprint cache in flash. The
+ * last PROFILE_STORE_ROW_COUNT flash rows are used and must be kept free of
+ * code and data by the linker script before enabling this feature.
+ */
+#ifndef PROFILE_STORE_ENABLE
+#define PROFILE_STORE_ENABLE                   (0u)
+#endif /* PROFILE_STORE_ENABLE */
+
+/*
+ * Number of flash rows used by the profile store. Rows are written in a round
+ * robin manner to spread the wear.
+ */
+#define PROFILE_STORE_ROW_COUNT                (4u)
+
+/*
+ * Minimum interval (ms) between two flash writes of the profile store, and
+ * the retry interval after a failed write. Writes are only done while the
+ * PD stack is idle between AMSs.
+ */
+#define PROFILE_STORE_WRITE_INTERVAL           (600000u)
+
+/*
+ * Enable/Disable the efficiency search. When enabled, the PPS sweep is replaced
+ * by a hill-climb of the PPS voltage towards the setpoint with the lowest input
+ * power for the present load. Requires a source reporting the output current
+ * in PPS_Status.
+ */
+#ifndef EFF_SEARCH_ENABLE
+#define EFF_SEARCH_ENABLE                      (0u)
+#endif /* EFF_SEARCH_ENABLE */
+
+/*
+ * Efficiency search voltage step (mV). Requests are converted to 50mV units
+ * before the PPS RDO encodes them in 20mV units, so the step must be a
+ * multiple of 100mV to be taken exactly.
+ */
+#define EFF_SEARCH_STEP                        (100u)
+
+/*
+ * Minimum input power reduction (mW) for a step to be taken as an improvement.
+ * Must be above the 50mA resolution of the PPS_Status output current.
+ */
+#define EFF_SEARCH_HYST                        (250u)
+
+/*
+ * Time (ms) allowed for the load to settle on a new setpoint before the input
+ * power is measured. Must be shorter than PPS_REQ_TIMER.
+ */
+#define EFF_SEARCH_SETTLE_TIME                 (500u)
+
+/*
+ * Interval (ms) between two efficiency search runs.
+ */
+#define EFF_SEARCH_PERIOD                      (60000u)
+
+/*
+ * Enable/Disable the per session energy (mWh) and charge (mAh) accounting.
+ */
+#define ENERGY_ENABLE                          (1u)
+
+/*
+ * Energy accounting sample period (ms).
+ */
+#define ENERGY_SAMPLE_PERIOD                   (1000u)
+
+/*
+ * Enable/Disable the background VBUS measurement pipeline. The pipeline runs
+ * while a source is attached: the timer wakes the device every
+ * VBUS_MEAS_PERIOD and the main loop then makes 2^VBUS_MEAS_OVERSAMPLE_SHIFT
+ * blocking ADC conversions. The CPU time spent is reported in the load field
+ * of the published block.
+ */
+#ifndef VBUS_MEAS_ENABLE
+#define VBUS_MEAS_ENABLE                       (1u)
+#endif /* VBUS_MEAS_ENABLE */
+
+/*
+ * VBUS measurement pipeline sample period (ms). A block is published every
+ * VBUS_MEAS_PERIOD * VBUS_MEAS_DECIMATION ms.
+ */
+#define VBUS_MEAS_PERIOD                       (10u)
+
+/*
+ * Number of ADC conversions averaged per sample, as a power of 2.
+ */
+#define VBUS_MEAS_OVERSAMPLE_SHIFT             (2u)
+
+/*
+ * IIR filter coefficient as a power of 2: y += (x - y) / 2^VBUS_MEAS_IIR_SHIFT.
+ */
+#define VBUS_MEAS_IIR_SHIFT                    (3u)
+
+/*
+ * Number of samples per published block.
+ */
+#define VBUS_MEAS_DECIMATION                   (10u)
+
+/*
+ * Enable/Disable the binary UART telemetry link. Requires the CYBSP_UART SCB
+ * to be configured as a UART (pins, clock and baud rate) in the device
+ * configurator.
+ */
+#ifndef TELEMETRY_ENABLE
+#define TELEMETRY_ENABLE                       (0u)
+#endif /* TELEMETRY_ENABLE */
+
+/*
+ * Size of the telemetry transmit ring in bytes. Must be a power of 2.
+ */
+#define TELEMETRY_RING_SIZE                    (512u)
+
+/*
+ * Interval (ms) between two VBUS telemetry frames.
+ */
+#define TELEMETRY_PERIOD                       (100u)
+
+/*
+ * Telemetry UART interrupt priority.
+ */
+#define TELEMETRY_INTR_PRIORITY                (3u)
+
+/*
+ * Number of sink FET soft-start steps, 0 to turn the FET on at once. In step
+ * n the FET is pulsed on for n ms. Only available when the FET is driven by
+ * GPIO (CY_APP_SINK_FET_CTRL_GPIO_EN).
+ */
+#define SINK_FET_SOFT_START_STEPS              (0u)
+
+/*
+ * Time (ms) the sink FET is held off between two soft-start steps.
+ */
+#define SINK_FET_SOFT_START_OFF_TIME           (1u)
+
+/*
+ * Enable PPS current probing. Once the first PPS contract is in place the
+ * voltage is held and the requested current is binary searched for the highest
+ * value the source delivers in constant voltage mode. Cannot be used together
+ * with EFF_SEARCH_ENABLE.
+ */
+#ifndef CUR_PROBE_ENABLE
+#define CUR_PROBE_ENABLE                       (0u)
+#endif /* CUR_PROBE_ENABLE */
+
+/*
+ * Time (ms) allowed for a trial current to settle before the PPS status is read.
+ */
+#define CUR_PROBE_SETTLE_TIME                  (500u)
+
+/*
+ * Largest VBUS droop (mV) below the requested voltage accepted for a trial
+ * current to hold.
+ */
+#define CUR_PROBE_DROOP_MAX                    (300u)
+
+/*
+ * Width (mV) of the voltage bands the probed current is cached for.
+ */
+#define CUR_PROBE_BAND_WIDTH                   (1000u)
+
+/*
+ * Enable direct battery charging through the PPS source. The source regulates
+ * the charge current in current limit and the sink FET connects VBUS straight
+ * to the battery. Cannot be used together with EFF_SEARCH_ENABLE or
+ * CUR_PROBE_ENABLE.
+ */
+#ifndef BATT_CHG_ENABLE
+#define BATT_CHG_ENABLE                        (0u)
+#endif /* BATT_CHG_ENABLE */
+
+/*
+ * Constant current phase charge current in mA.
+ */
+#define BATT_CHG_CUR                           (2000u)
+
+/*
+ * Battery termination (constant voltage phase) voltage in mV.
+ */
+#define BATT_CHG_TERM_VOLT                     (8400u)
+
+/*
+ * Termination current in mA. Charging ends when the current drops below it in
+ * the constant voltage phase.
+ */
+#define BATT_CHG_TERM_CUR                      (200u)
+
+/*
+ * PPS voltage step (mV) used to reach current limit in the constant current
+ * phase.
+ */
+#define BATT_CHG_VOLT_STEP                     (100u)
+
+/*
+ * Headroom (mV) above the termination voltage allowed for the cable and FET
+ * drop in the constant current phase.
+ */
+#define BATT_CHG_VOLT_MARGIN                   (500u)
+
+/*
+ * Headroom (mA) kept above the measured current when tapering the current
+ * limit in the constant voltage phase.
+ */
+#define BATT_CHG_CUR_MARGIN                    (100u)
+
+/*
+ * Time (ms) allowed for a new setpoint to settle before the PPS status is read.
+ */
+#define BATT_CHG_SETTLE_TIME                   (500u)
+
+/*
+ * Headroom (mV) above the battery voltage that the constant current phase
+ * starts from, so that VBUS is never below the battery.
+ */
+#define BATT_CHG_START_MARGIN                  (200u)
+
+/*
+ * Charge safety timeout in minutes, counted from the start of the constant
+ * current phase. The sink FET is latched off when it expires.
+ */
+#ifndef BATT_CHG_MAX_TIME
+#define BATT_CHG_MAX_TIME                      (240u)
+#endif /* BATT_CHG_MAX_TIME */
+
+/*
+ * Enable the extended source capabilities cache. Get_Source_Cap_Extended is
+ * sent once per attach and the source PDP and load step capability bound the
+ * requested current.
+ */
+#define SRC_CAP_EXT_ENABLE                     (1u)
+
+/*
+ * Derating (%) of the source PDP applied when the source reports no overload
+ * (peak current) capability.
+ */
+#define SRC_CAP_EXT_NO_PEAK_DERATE             (10u)
+
+/*
+ * Enable batched runtime sink capability updates. Sink PDO edits are staged
+ * with snk_cap_begin/snk_cap_set_* and applied by snk_cap_commit with a single
+ * renegotiation.
+ */
+#define SNK_CAP_EDIT_ENABLE                    (1u)
+
+/*
+ * Enable the PD message and AMS statistics: request responses, PS_RDY
+ * latency, resets and PPS keepalives per port.
+ */
+#define PD_STATS_ENABLE                        (1u)
 
 /*
  * 5.0V Vbus voltage in 1mV units
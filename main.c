@@ -65,6 +65,36 @@
 #include "mtbcfg_ezpd.h"
 #include "cy_app_fault_handlers.h"
 #include "pps.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "trace.h"
+#include "pd_capture.h"
+#include "profile_store.h"
+#include "boot_timeline.h"
+#include "power_arb.h"
+#include "epr_gov.h"
+#include "cable_limit.h"
+#include "src_cap_ext.h"
+#include "snk_cap.h"
+#include "pd_stats.h"
+#include "energy.h"
+#include "vbus_meas.h"
+#include "telemetry.h"
+#include "isr_stats.h"
+#include "sleep_stats.h"
+#include "fault_timeline.h"
+#include "sink_fet.h"
+#include "batt_chg.h"
+
+/*
+ * pps_task and the tasks built on it (energy accounting, VBUS measurement,
+ * telemetry, EPR governor and profile store) keep a single instance of state
+ * and serve port 0 only; their event handlers ignore port 1. On a dual port
+ * device, port 1 runs the stack policy and the per port tasks only.
+ */
+#if PMG1_PD_DUALPORT_ENABLE
+#pragma message("PPS, energy, VBUS measurement, telemetry, EPR governor and profile store run on port 0 only")
+#endif /* PMG1_PD_DUALPORT_ENABLE */
 
 /*******************************************************************************
 * Structure definitions
@@ -105,7 +135,7 @@ static cy_stc_user_led_status gl_userLedStatus[NO_OF_TYPEC_PORTS] =
 const cy_stc_sysint_t User_Switch_intr_config =
 {
     .intrSrc = CYBSP_USER_BTN_IRQ,   /* Source of interrupt signal */
-    .intrPriority = 3u,             /* Interrupt priority */
+    .intrPriority = APP_SWITCH_INTR_PRIORITY, /* Interrupt priority */
 };
 
 const cy_stc_pdstack_dpm_params_t pdstack_port0_dpm_params =
@@ -170,32 +200,32 @@ bool mux_ctrl_init(uint8_t port)
 const cy_stc_sysint_t wdt_interrupt_config =
 {
     .intrSrc = (IRQn_Type)srss_interrupt_wdt_IRQn,
-    .intrPriority = 0U,
+    .intrPriority = APP_WDT_INTR_PRIORITY,
 };
 
 const cy_stc_sysint_t usbpd_port0_intr0_config =
 {
     .intrSrc = (IRQn_Type)mtb_usbpd_port0_IRQ,
-    .intrPriority = 0U,
+    .intrPriority = APP_USBPD_INTR0_PRIORITY,
 };
 
 const cy_stc_sysint_t usbpd_port0_intr1_config =
 {
     .intrSrc = (IRQn_Type)mtb_usbpd_port0_DS_IRQ,
-    .intrPriority = 0U,
+    .intrPriority = APP_USBPD_INTR1_PRIORITY,
 };
 
 #if PMG1_PD_DUALPORT_ENABLE
 const cy_stc_sysint_t usbpd_port1_intr0_config =
 {
     .intrSrc = (IRQn_Type)mtb_usbpd_port1_IRQ,
-    .intrPriority = 0U,
+    .intrPriority = APP_USBPD_INTR0_PRIORITY,
 };
 
 const cy_stc_sysint_t usbpd_port1_intr1_config =
 {
     .intrSrc = (IRQn_Type)mtb_usbpd_port1_DS_IRQ,
-    .intrPriority = 0U,
+    .intrPriority = APP_USBPD_INTR1_PRIORITY,
 };
 #endif /* PMG1_PD_DUALPORT_ENABLE */
 
@@ -222,7 +252,7 @@ cy_stc_pdstack_context_t *get_pdstack_context(uint8_t portIdx)
 ********************************************************************************
 * Summary:
 *   Solution PD Event Handler
-*   Handles the Extended message event
+*   Forwards the event to all handlers subscribed in the app_evt.c table
 *
 * Parameters:
 *  ctx - PD Stack Context
@@ -235,9 +265,7 @@ cy_stc_pdstack_context_t *get_pdstack_context(uint8_t portIdx)
 *******************************************************************************/
 void sln_pd_event_handler(cy_stc_pdstack_context_t* ctx, cy_en_pdstack_app_evt_t evt, const void *data)
 {
-    (void)ctx;
-    (void)evt;
-    (void)data;
+    app_evt_dispatch(ctx, evt, data);
 }
 
 /*******************************************************************************
@@ -276,6 +304,9 @@ void instrumentation_cb(uint8_t port, uint8_t evt)
 *******************************************************************************/
 static void wdt_interrupt_handler(void)
 {
+    ISR_STATS_ENTER(ISR_ID_WDT);
+    SLEEP_STATS_WAKE(SLEEP_WAKE_WDT);
+
     /* Clear WDT pending interrupt */
     Cy_WDT_ClearInterrupt();
 
@@ -284,8 +315,13 @@ static void wdt_interrupt_handler(void)
     Cy_WDT_SetMatch((Cy_WDT_GetCount() + gl_TimerCtx.multiplier));
 #endif /* (TIMER_TICKLESS_ENABLE == 0) */
 
+    /* Keep the extended timestamp up to date across WDT counter wraps. */
+    (void)timestamp_get_ticks();
+
     /* Invoke the timer handler. */
     Cy_PdUtils_SwTimer_InterruptHandler (&(gl_TimerCtx));
+
+    ISR_STATS_EXIT(ISR_ID_WDT);
 }
 
 /*******************************************************************************
@@ -303,7 +339,10 @@ static void wdt_interrupt_handler(void)
 *******************************************************************************/
 static void cy_usbpd0_intr0_handler(void)
 {
+    ISR_STATS_ENTER(ISR_ID_USBPD0_INTR0);
+    SLEEP_STATS_WAKE(SLEEP_WAKE_USBPD0);
     Cy_USBPD_Intr0Handler(&gl_UsbPdPort0Ctx);
+    ISR_STATS_EXIT(ISR_ID_USBPD0_INTR0);
 }
 
 /*******************************************************************************
@@ -321,7 +360,10 @@ static void cy_usbpd0_intr0_handler(void)
 *******************************************************************************/
 static void cy_usbpd0_intr1_handler(void)
 {
+    ISR_STATS_ENTER(ISR_ID_USBPD0_INTR1);
+    SLEEP_STATS_WAKE(SLEEP_WAKE_USBPD0);
     Cy_USBPD_Intr1Handler(&gl_UsbPdPort0Ctx);
+    ISR_STATS_EXIT(ISR_ID_USBPD0_INTR1);
 }
 
 #if PMG1_PD_DUALPORT_ENABLE
@@ -340,7 +382,10 @@ static void cy_usbpd0_intr1_handler(void)
 *******************************************************************************/
 static void cy_usbpd1_intr0_handler(void)
 {
+    ISR_STATS_ENTER(ISR_ID_USBPD1_INTR0);
+    SLEEP_STATS_WAKE(SLEEP_WAKE_USBPD1);
     Cy_USBPD_Intr0Handler(&gl_UsbPdPort1Ctx);
+    ISR_STATS_EXIT(ISR_ID_USBPD1_INTR0);
 }
 
 /*******************************************************************************
@@ -358,7 +403,10 @@ static void cy_usbpd1_intr0_handler(void)
 *******************************************************************************/
 static void cy_usbpd1_intr1_handler(void)
 {
+    ISR_STATS_ENTER(ISR_ID_USBPD1_INTR1);
+    SLEEP_STATS_WAKE(SLEEP_WAKE_USBPD1);
     Cy_USBPD_Intr1Handler(&gl_UsbPdPort1Ctx);
+    ISR_STATS_EXIT(ISR_ID_USBPD1_INTR1);
 }
 #endif /* PMG1_PD_DUALPORT_ENABLE */
 
@@ -427,6 +475,40 @@ void led_timer_cb (
 
     Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, callbackContext, id, user_led->blinkRate, led_timer_cb);
 }
+
+/*******************************************************************************
+* Function Name: led_evt_handler
+********************************************************************************
+* Summary:
+*  Re-evaluates the LED blink rate as soon as the connection state changes
+*  instead of waiting for the current blink period to expire. Receives events
+*  only once start_non_critical_tasks has started the LED timers.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void led_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    cy_timer_id_t id = (cy_timer_id_t)LED_TIMER_ID;
+
+    (void)evt;
+    (void)data;
+
+#if PMG1_PD_DUALPORT_ENABLE
+    if (ctx->port != 0u)
+    {
+        id = (cy_timer_id_t)LED2_TIMER_ID;
+    }
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+
+    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)ctx, id, 1u, led_timer_cb);
+}
 #endif /* APP_FW_LED_ENABLE */
 
 
@@ -483,8 +565,8 @@ const cy_stc_pdstack_app_cbk_t app_callback =
     .vbus_discharge_off = Cy_App_VbusDischargeOff,
     .psnk_set_voltage = Cy_App_Sink_SetVoltage,
     .psnk_set_current = Cy_App_Sink_SetCurrent,
-    .psnk_enable = Cy_App_Sink_Enable,
-    .psnk_disable = Cy_App_Sink_Disable,
+    .psnk_enable = sink_fet_enable,
+    .psnk_disable = sink_fet_disable,
     .eval_src_cap = Cy_App_Pdo_EvalSrcCap,
     .eval_dr_swap = Cy_App_Swap_EvalDrSwap,
     .eval_pr_swap = Cy_App_Swap_EvalPrSwap,
@@ -528,18 +610,7 @@ cy_stc_pdstack_app_cbk_t* app_get_callback_ptr(cy_stc_pdstack_context_t * contex
 *******************************************************************************/
 void soln_sink_fet_off(cy_stc_pdstack_context_t * context)
 {
-#if CY_APP_SINK_FET_CTRL_GPIO_EN
-    if (context->port == 0u)
-    {
-        Cy_GPIO_Clr (PFET_SNK_CTRL_P0_PORT, PFET_SNK_CTRL_P0_PIN);
-    }
-#if PMG1_PD_DUALPORT_ENABLE
-    else
-    {
-        Cy_GPIO_Clr (PFET_SNK_CTRL_P1_PORT, PFET_SNK_CTRL_P1_PIN);
-    }
-#endif /* PMG1_PD_DUALPORT_ENABLE */
-#endif /* CY_APP_SINK_FET_CTRL_GPIO_EN */
+    sink_fet_off(context);
 }
 
 /*******************************************************************************
@@ -557,19 +628,31 @@ void soln_sink_fet_off(cy_stc_pdstack_context_t * context)
 *******************************************************************************/
 void soln_sink_fet_on(cy_stc_pdstack_context_t * context)
 {
-#if CY_APP_SINK_FET_CTRL_GPIO_EN
-    if (context->port == 0u)
-    {
-        Cy_GPIO_Set (PFET_SNK_CTRL_P0_PORT, PFET_SNK_CTRL_P0_PIN);
-    }
-#if PMG1_PD_DUALPORT_ENABLE
-    else
-    {
-        Cy_GPIO_Set (PFET_SNK_CTRL_P1_PORT, PFET_SNK_CTRL_P1_PIN);
-    }
-#endif /* PMG1_PD_DUALPORT_ENABLE */
-#endif /* CY_APP_SINK_FET_CTRL_GPIO_EN */
+    sink_fet_on(context);
+}
+
+#if BATT_CHG_ENABLE
+/*******************************************************************************
+* Function Name: batt_chg_get_batt_volt
+********************************************************************************
+* Summary:
+*  Returns the battery voltage the charging cycle starts from. Called from the
+*  main loop at the start of each charging cycle. This reads the VBUS ADC,
+*  which sees the battery through the sink path; boards with a dedicated
+*  battery sense divider should read that channel here instead.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  Battery voltage in mV
+*
+*******************************************************************************/
+uint16_t batt_chg_get_batt_volt(cy_stc_pdstack_context_t * context)
+{
+    return Cy_App_VbusGetValue(context);
 }
+#endif /* BATT_CHG_ENABLE */
 
 /*******************************************************************************
 * Function Name: User_Switch_Interrupt_Handler
@@ -583,11 +666,46 @@ void User_Switch_Interrupt_Handler(void)
 {
     /* Set Switch press flag to 1 */
     SwitchPressFlag = 1;
+    SLEEP_STATS_WAKE(SLEEP_WAKE_SWITCH);
 
     /* Clear the Interrupt */
     Cy_GPIO_ClearInterrupt(CYBSP_USER_BTN_PORT, CYBSP_USER_BTN_NUM);
 }
 
+/*******************************************************************************
+* Function Name: start_non_critical_tasks
+********************************************************************************
+* Summary:
+*  Starts the tasks which are not required to establish a contract: the
+*  firmware active LEDs. The instrumentation watchdog is started before the
+*  DPM so that a hang is detected during the boot as well.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void start_non_critical_tasks(void)
+{
+#if APP_FW_LED_ENABLE
+    /* Start a timer that will blink the FW ACTIVE LED. */
+    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)&gl_PdStackPort0Ctx, (cy_timer_id_t)LED_TIMER_ID,
+            LED_TIMER_PERIOD_DETACHED, led_timer_cb);
+#if PMG1_PD_DUALPORT_ENABLE
+    /* Start a timer that will blink the FW ACTIVE LED. */
+    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)&gl_PdStackPort1Ctx, (cy_timer_id_t)LED2_TIMER_ID,
+            LED_TIMER_PERIOD_DETACHED, led_timer_cb);
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+
+#if APP_BOOT_FAST_PATH
+    /* The LEDs follow the connection state from now on. */
+    app_evt_enable(APP_EVT_SLOT_LED);
+#endif /* APP_BOOT_FAST_PATH */
+#endif /* APP_FW_LED_ENABLE */
+}
+
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************
@@ -616,6 +734,7 @@ int main(void)
     {
         CY_ASSERT(0);
     }
+    boot_mark(BOOT_PHASE_BSP_INIT);
 
     /*
      * Register the interrupt handler for the watchdog timer. This timer is used to
@@ -629,6 +748,9 @@ int main(void)
 
     /* Initialize the soft timer module. */
     Cy_PdUtils_SwTimer_Init(&gl_TimerCtx, &timerConfig);
+    timestamp_cycles_init();
+    timestamp_init();
+    boot_mark(BOOT_PHASE_TIMER_INIT);
 
     /* Enable global interrupts */
     __enable_irq();
@@ -667,6 +789,7 @@ int main(void)
     Cy_SysInt_Init(&usbpd_port1_intr1_config, &cy_usbpd1_intr1_handler);
     NVIC_EnableIRQ(usbpd_port1_intr1_config.intrSrc);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
+    boot_mark(BOOT_PHASE_INTR_INIT);
 
     /* Initialize the USBPD driver */
 #if defined(CY_DEVICE_CCG3)
@@ -680,6 +803,7 @@ int main(void)
             (cy_stc_usbpd_config_t *)&mtb_usbpd_port1_config, get_dpm_port1_connect_stat);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
 #endif
+    boot_mark(BOOT_PHASE_USBPD_INIT);
 
     /* Initialize the Device Policy Manager. */
     Cy_PdStack_Dpm_Init(&gl_PdStackPort0Ctx,
@@ -697,20 +821,23 @@ int main(void)
                        &pdstack_port1_dpm_params,
                        &gl_TimerCtx);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
+    boot_mark(BOOT_PHASE_DPM_INIT);
 
     /* Perform application level initialization. */
     Cy_App_Init(&gl_PdStackPort0Ctx, &port0_app_params);
 #if PMG1_PD_DUALPORT_ENABLE
     Cy_App_Init(&gl_PdStackPort1Ctx, &port1_app_params);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
+    boot_mark(BOOT_PHASE_APP_INIT);
 
     /* Initialize the fault configuration values */
     Cy_App_Fault_InitVars(&gl_PdStackPort0Ctx);
 #if PMG1_PD_DUALPORT_ENABLE
     Cy_App_Fault_InitVars(&gl_PdStackPort1Ctx);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
+    boot_mark(BOOT_PHASE_FAULT_INIT);
 
-    /* Start any timers or tasks associated with application instrumentation. */
+    /* Start any timers or tasks associated with application instrumentation, including the watchdog. */
     Cy_App_Instrumentation_Start();
 
     /* Start the device policy manager operation. This will initialize the USB-PD block and enable connect detection. */
@@ -718,18 +845,20 @@ int main(void)
 #if PMG1_PD_DUALPORT_ENABLE
     Cy_PdStack_Dpm_Start(&gl_PdStackPort1Ctx);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
+    boot_mark(BOOT_PHASE_DPM_START);
 
-#if APP_FW_LED_ENABLE
-    /* Start a timer that will blink the FW ACTIVE LED. */
-    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)&gl_PdStackPort0Ctx, (cy_timer_id_t)LED_TIMER_ID,
-            LED_TIMER_PERIOD_DETACHED, led_timer_cb);
-#if PMG1_PD_DUALPORT_ENABLE
-    /* Start a timer that will blink the FW ACTIVE LED. */
-    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)&gl_PdStackPort1Ctx, (cy_timer_id_t)LED2_TIMER_ID,
-            LED_TIMER_PERIOD_DETACHED, led_timer_cb);
-#endif /* PMG1_PD_DUALPORT_ENABLE */
+    /*
+     * Initialize the application modules while the Type-C debounce runs. The DPM task only processes the attach
+     * from the main loop, so the charger profiles are restored before the first contract.
+     * The event subscribers are fixed at compile time in app_evt.c.
+     */
+    pd_stats_init();
+    telemetry_init();
+    profile_store_init();
 
-#endif /* APP_FW_LED_ENABLE */
+#if !APP_BOOT_FAST_PATH
+    start_non_critical_tasks();
+#endif /* !APP_BOOT_FAST_PATH */
 
     /* Start a timer for PPS contract periodic request. */
     Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)&gl_PdStackPort0Ctx, (cy_timer_id_t)PPS_TIMER_ID,
@@ -754,28 +883,83 @@ int main(void)
         Cy_App_Task(&gl_PdStackPort1Ctx);
 #endif /* PMG1_PD_DUALPORT_ENABLE */
 
+        /* Arbitrate between the legacy charging and USB PD power paths. */
+        power_arb_task(&gl_PdStackPort0Ctx);
+#if PMG1_PD_DUALPORT_ENABLE
+        power_arb_task(&gl_PdStackPort1Ctx);
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+
+        /* Discover the cable capabilities where the sink is allowed to. */
+        cable_limit_task(&gl_PdStackPort0Ctx);
+#if PMG1_PD_DUALPORT_ENABLE
+        cable_limit_task(&gl_PdStackPort1Ctx);
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+
+        /* Fetch the extended source capabilities once per attach. */
+        src_cap_ext_task(&gl_PdStackPort0Ctx);
+#if PMG1_PD_DUALPORT_ENABLE
+        src_cap_ext_task(&gl_PdStackPort1Ctx);
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+
+        /* Renegotiate once after committed sink capability changes. */
+        snk_cap_task(&gl_PdStackPort0Ctx);
+#if PMG1_PD_DUALPORT_ENABLE
+        snk_cap_task(&gl_PdStackPort1Ctx);
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+
+        /* The tasks below run on port 0 only, also on a dual port device. */
+
+        /* Run the PPS request posted by the PPS timer. */
+        pps_task();
+
+        /* Integrate the energy samples posted by the energy timer. */
+        energy_task(&gl_PdStackPort0Ctx);
+
+        /* Filter the VBUS sample posted by the measurement timer. */
+        vbus_meas_task(&gl_PdStackPort0Ctx);
+
+        /* Report the contract, PPS status and VBUS to the host logger. */
+        telemetry_task(&gl_PdStackPort0Ctx);
+
+        /* Run the EPR AVS power governor. */
+        epr_gov_task(&gl_PdStackPort0Ctx);
+
         /* Perform tasks associated with instrumentation. */
         Cy_App_Instrumentation_Task();
 
+#if APP_BOOT_FAST_PATH
+        /* Start the non-critical tasks once the first contract is in place. */
+        if (boot_deferred_start_due())
+        {
+            start_non_critical_tasks();
+        }
+#endif /* APP_BOOT_FAST_PATH */
+
+        /* Save the learned charger profiles when the port is idle. */
+        profile_store_task(&gl_PdStackPort0Ctx);
+
         /* Check if switch is pressed */
         if (SwitchPressFlag)
         {
-            /* Send Get PPS Status Message to Source */
-            Cy_PdStack_Dpm_SendPdCommand(&gl_PdStackPort0Ctx, CY_PDSTACK_DPM_CMD_GET_PPS_STATUS, NULL, false, NULL);
-            
+            /* Post a Get PPS Status Message to Source, sent by pps_task with the other requests */
+            pps_status_request(PPS_STATUS_REQ_SWITCH, NULL);
+
             /* Clear the flag */
             SwitchPressFlag = 0;
         }
 
 #if SYS_DEEPSLEEP_ENABLE
         /* If possible, enter deep sleep mode for power saving. */
-        Cy_App_SystemSleep(&gl_PdStackPort0Ctx,
+        if (sleep_stats_try_sleep(&gl_PdStackPort0Ctx,
 #if PMG1_PD_DUALPORT_ENABLE
                 &gl_PdStackPort1Ctx
 #else
                 NULL
 #endif /* PMG1_PD_DUALPORT_ENABLE */
-                );
+                ))
+        {
+            trace_log_coalesce(TRACE_EVT_SLEEP, 0u, 0u);
+        }
 #endif /* SYS_DEEPSLEEP_ENABLE */
     }
 }
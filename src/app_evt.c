@@ -0,0 +1,312 @@
+/*******************************************************************************
+* File Name: app_evt.c
+*
+* Description:
+*  This file contains the application event dispatch table. The table is built
+*  at compile time from the handlers of the enabled modules and
+*  sln_pd_event_handler fans each event out to them.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "app_evt.h"
+#include "pps.h"
+#include "trace.h"
+#include "pd_capture.h"
+#include "boot_timeline.h"
+#include "power_arb.h"
+#include "epr_gov.h"
+#include "cable_limit.h"
+#include "src_cap_ext.h"
+#include "pd_stats.h"
+#include "energy.h"
+#include "vbus_meas.h"
+#include "fault_timeline.h"
+#include "sink_fet.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+
+#if (APP_EVT_SLOT_COUNT > 16u)
+#error "APP_EVT_SLOT_COUNT exceeds the width of the subscriber mask"
+#endif
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Subscriber mask bit of each handler, 0 if the handler is not built */
+#define APP_EVT_PPS                             APP_EVT_BIT(APP_EVT_SLOT_PPS)
+#define APP_EVT_BOOT                            APP_EVT_BIT(APP_EVT_SLOT_BOOT)
+#define APP_EVT_CABLE                           APP_EVT_BIT(APP_EVT_SLOT_CABLE)
+#define APP_EVT_FAULT                           APP_EVT_BIT(APP_EVT_SLOT_FAULT)
+#define APP_EVT_SINK_FET                        APP_EVT_BIT(APP_EVT_SLOT_SINK_FET)
+#define APP_EVT_TIMESTAMP                       APP_EVT_BIT(APP_EVT_SLOT_TIMESTAMP)
+
+#if TRACE_ENABLE
+#define APP_EVT_TRACE                           APP_EVT_BIT(APP_EVT_SLOT_TRACE)
+#else
+#define APP_EVT_TRACE                           (0u)
+#endif /* TRACE_ENABLE */
+
+#if PD_CAPTURE_ENABLE
+#define APP_EVT_CAPTURE                         APP_EVT_BIT(APP_EVT_SLOT_CAPTURE)
+#else
+#define APP_EVT_CAPTURE                         (0u)
+#endif /* PD_CAPTURE_ENABLE */
+
+#if BATTERY_CHARGING_ENABLE
+#define APP_EVT_POWER_ARB                       APP_EVT_BIT(APP_EVT_SLOT_POWER_ARB)
+#else
+#define APP_EVT_POWER_ARB                       (0u)
+#endif /* BATTERY_CHARGING_ENABLE */
+
+#if EPR_GOV_BUILD
+#define APP_EVT_EPR_GOV                         APP_EVT_BIT(APP_EVT_SLOT_EPR_GOV)
+#else
+#define APP_EVT_EPR_GOV                         (0u)
+#endif /* EPR_GOV_BUILD */
+
+#if SRC_CAP_EXT_ENABLE
+#define APP_EVT_SRC_CAP_EXT                     APP_EVT_BIT(APP_EVT_SLOT_SRC_CAP_EXT)
+#else
+#define APP_EVT_SRC_CAP_EXT                     (0u)
+#endif /* SRC_CAP_EXT_ENABLE */
+
+#if PD_STATS_ENABLE
+#define APP_EVT_PD_STATS                        APP_EVT_BIT(APP_EVT_SLOT_PD_STATS)
+#else
+#define APP_EVT_PD_STATS                        (0u)
+#endif /* PD_STATS_ENABLE */
+
+#if ENERGY_ENABLE
+#define APP_EVT_ENERGY                          APP_EVT_BIT(APP_EVT_SLOT_ENERGY)
+#else
+#define APP_EVT_ENERGY                          (0u)
+#endif /* ENERGY_ENABLE */
+
+#if VBUS_MEAS_ENABLE
+#define APP_EVT_VBUS_MEAS                       APP_EVT_BIT(APP_EVT_SLOT_VBUS_MEAS)
+#else
+#define APP_EVT_VBUS_MEAS                       (0u)
+#endif /* VBUS_MEAS_ENABLE */
+
+#if APP_FW_LED_ENABLE
+#define APP_EVT_LED                             APP_EVT_BIT(APP_EVT_SLOT_LED)
+#else
+#define APP_EVT_LED                             (0u)
+#endif /* APP_FW_LED_ENABLE */
+
+/*
+ * Handlers which only receive events once they are enabled with
+ * app_evt_enable. With the boot fast path, the LED handler is enabled together
+ * with the LED timers so that it cannot start them before the first contract.
+ */
+#if APP_BOOT_FAST_PATH
+#define APP_EVT_DEFERRED                        APP_EVT_LED
+#else
+#define APP_EVT_DEFERRED                        (0u)
+#endif /* APP_BOOT_FAST_PATH */
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Handler of each slot. The bit position in the subscriber mask is the index in this table. */
+static const app_evt_handler_t gl_app_evt_handlers[APP_EVT_SLOT_COUNT] =
+{
+    [APP_EVT_SLOT_PPS]          = pps_evt_handler,
+#if TRACE_ENABLE
+    [APP_EVT_SLOT_TRACE]        = trace_evt_handler,
+#endif /* TRACE_ENABLE */
+#if PD_CAPTURE_ENABLE
+    [APP_EVT_SLOT_CAPTURE]      = capture_evt_handler,
+#endif /* PD_CAPTURE_ENABLE */
+    [APP_EVT_SLOT_BOOT]         = boot_evt_handler,
+#if BATTERY_CHARGING_ENABLE
+    [APP_EVT_SLOT_POWER_ARB]    = power_arb_evt_handler,
+#endif /* BATTERY_CHARGING_ENABLE */
+#if EPR_GOV_BUILD
+    [APP_EVT_SLOT_EPR_GOV]      = epr_gov_evt_handler,
+#endif /* EPR_GOV_BUILD */
+    [APP_EVT_SLOT_CABLE]        = cable_evt_handler,
+#if SRC_CAP_EXT_ENABLE
+    [APP_EVT_SLOT_SRC_CAP_EXT]  = src_cap_ext_evt_handler,
+#endif /* SRC_CAP_EXT_ENABLE */
+#if PD_STATS_ENABLE
+    [APP_EVT_SLOT_PD_STATS]     = pd_stats_evt_handler,
+#endif /* PD_STATS_ENABLE */
+#if ENERGY_ENABLE
+    [APP_EVT_SLOT_ENERGY]       = energy_evt_handler,
+#endif /* ENERGY_ENABLE */
+#if VBUS_MEAS_ENABLE
+    [APP_EVT_SLOT_VBUS_MEAS]    = vbus_evt_handler,
+#endif /* VBUS_MEAS_ENABLE */
+    [APP_EVT_SLOT_FAULT]        = fault_evt_handler,
+    [APP_EVT_SLOT_SINK_FET]     = sink_fet_evt_handler,
+#if APP_FW_LED_ENABLE
+    [APP_EVT_SLOT_LED]          = led_evt_handler,
+#endif /* APP_FW_LED_ENABLE */
+    [APP_EVT_SLOT_TIMESTAMP]    = timestamp_evt_handler,
+};
+
+/* Handlers which currently receive events */
+static volatile uint16_t gl_app_evt_active = (uint16_t)~APP_EVT_DEFERRED;
+
+/* Subscriber mask for each event ID */
+static const uint16_t gl_app_evt_table[APP_EVT_TABLE_SIZE] =
+{
+    [APP_EVT_CONNECT] =
+        APP_EVT_TIMESTAMP | APP_EVT_TRACE | APP_EVT_CAPTURE | APP_EVT_POWER_ARB | APP_EVT_CABLE |
+        APP_EVT_ENERGY | APP_EVT_VBUS_MEAS | APP_EVT_LED,
+    [APP_EVT_DISCONNECT] =
+        APP_EVT_PPS | APP_EVT_TRACE | APP_EVT_CAPTURE | APP_EVT_EPR_GOV | APP_EVT_SRC_CAP_EXT |
+        APP_EVT_CABLE | APP_EVT_ENERGY | APP_EVT_VBUS_MEAS | APP_EVT_SINK_FET | APP_EVT_PD_STATS |
+        APP_EVT_LED | APP_EVT_TIMESTAMP,
+    [APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE] =
+        APP_EVT_PPS | APP_EVT_TRACE | APP_EVT_BOOT | APP_EVT_POWER_ARB | APP_EVT_EPR_GOV |
+        APP_EVT_PD_STATS | APP_EVT_FAULT | APP_EVT_SINK_FET | APP_EVT_LED,
+    [APP_EVT_HARD_RESET_RCVD] =
+        APP_EVT_PPS | APP_EVT_TRACE | APP_EVT_EPR_GOV | APP_EVT_CABLE | APP_EVT_PD_STATS | APP_EVT_FAULT,
+    [APP_EVT_HARD_RESET_SENT] =
+        APP_EVT_PPS | APP_EVT_TRACE | APP_EVT_EPR_GOV | APP_EVT_CABLE | APP_EVT_PD_STATS | APP_EVT_FAULT,
+    [APP_EVT_SOFT_RESET_SENT] =
+        APP_EVT_TRACE | APP_EVT_PD_STATS,
+    [APP_EVT_TYPE_C_ERROR_RECOVERY] =
+        APP_EVT_PPS | APP_EVT_TRACE | APP_EVT_PD_STATS | APP_EVT_FAULT,
+    [APP_EVT_VBUS_OVP_FAULT] =
+        APP_EVT_TRACE | APP_EVT_FAULT,
+    [APP_EVT_VBUS_UVP_FAULT] =
+        APP_EVT_TRACE | APP_EVT_FAULT,
+    [APP_EVT_VBUS_OCP_FAULT] =
+        APP_EVT_TRACE | APP_EVT_FAULT,
+    [APP_EVT_VBUS_SCP_FAULT] =
+        APP_EVT_TRACE | APP_EVT_FAULT,
+    /* Instrumentation events, such as a watchdog reset or a runaway task */
+    [APP_TOTAL_EVENTS + 0u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 1u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 2u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 3u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 4u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 5u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 6u] = APP_EVT_TRACE,
+    [APP_TOTAL_EVENTS + 7u] = APP_EVT_TRACE,
+};
+
+/* Every instrumentation event has an entry above */
+typedef char app_evt_inst_check_t[(APP_EVT_INST_EVENT_COUNT == 8u) ? 1 : -1];
+
+/*******************************************************************************
+* Function Name: app_evt_dispatch
+********************************************************************************
+* Summary:
+*  Invokes all handlers subscribed to an event. The event ID directly indexes
+*  the subscriber mask table, so the cost is bounded by APP_EVT_SLOT_COUNT
+*  handler calls regardless of the number of events.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void app_evt_dispatch(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    uint16_t mask;
+    uint8_t idx = 0u;
+
+    if ((uint32_t)evt >= APP_EVT_TABLE_SIZE)
+    {
+        return;
+    }
+
+    mask = gl_app_evt_table[evt] & gl_app_evt_active;
+    while (mask != 0u)
+    {
+        if ((mask & 1u) != 0u)
+        {
+            gl_app_evt_handlers[idx](ctx, evt, data);
+        }
+        mask >>= 1u;
+        idx++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_evt_enable
+********************************************************************************
+* Summary:
+*  Enables a handler which does not receive events from boot. Must be called
+*  from the main loop.
+*
+* Parameters:
+*  slot - Handler slot
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void app_evt_enable(uint8_t slot)
+{
+    if (slot < APP_EVT_SLOT_COUNT)
+    {
+        gl_app_evt_active |= APP_EVT_BIT(slot);
+    }
+}
+
+/*******************************************************************************
+* Function Name: app_evt_contract_ok
+********************************************************************************
+* Summary:
+*  Checks the data of an APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE event
+*
+* Parameters:
+*  data - Event data
+*
+* Return:
+*  true if the requested contract was established
+*
+*******************************************************************************/
+bool app_evt_contract_ok(const void *data)
+{
+    const cy_stc_pdstack_pd_contract_info_t *contract = (const cy_stc_pdstack_pd_contract_info_t *)data;
+
+    return ((contract != NULL) && (contract->status == CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL));
+}
+
+/* [] END OF FILE */
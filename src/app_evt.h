@@ -0,0 +1,124 @@
+/*******************************************************************************
+* File Name: app_evt.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  application event dispatch layer used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_APP_EVT_H_
+#define SRC_APP_EVT_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Handler slots. The slot is the bit position of the handler in the per-event
+ * subscriber mask. Slots of handlers which are not built stay unused.
+ */
+#define APP_EVT_SLOT_PPS                        (0u)
+#define APP_EVT_SLOT_TRACE                      (1u)
+#define APP_EVT_SLOT_CAPTURE                    (2u)
+#define APP_EVT_SLOT_BOOT                       (3u)
+#define APP_EVT_SLOT_POWER_ARB                  (4u)
+#define APP_EVT_SLOT_EPR_GOV                    (5u)
+#define APP_EVT_SLOT_CABLE                      (6u)
+#define APP_EVT_SLOT_SRC_CAP_EXT                (7u)
+#define APP_EVT_SLOT_PD_STATS                   (8u)
+#define APP_EVT_SLOT_ENERGY                     (9u)
+#define APP_EVT_SLOT_VBUS_MEAS                  (10u)
+#define APP_EVT_SLOT_FAULT                      (11u)
+#define APP_EVT_SLOT_SINK_FET                   (12u)
+#define APP_EVT_SLOT_LED                        (13u)
+#define APP_EVT_SLOT_TIMESTAMP                  (14u)
+
+/*
+ * Number of handler slots. Each slot occupies one bit of the per-event
+ * subscriber mask, so this value must not exceed 16.
+ */
+#define APP_EVT_SLOT_COUNT                      (15u)
+
+/*
+ * Subscriber mask bit of a handler slot
+ */
+#define APP_EVT_BIT(slot)                       ((uint16_t)(1u << (slot)))
+
+/*
+ * Number of instrumentation events forwarded through instrumentation_cb. These
+ * events are offset by APP_TOTAL_EVENTS before being dispatched and are
+ * recorded in the trace as faults.
+ */
+#define APP_EVT_INST_EVENT_COUNT                (8u)
+
+/*
+ * Total number of entries in the dispatch table.
+ */
+#define APP_EVT_TABLE_SIZE                      ((uint32_t)APP_TOTAL_EVENTS + APP_EVT_INST_EVENT_COUNT)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef app_evt_handler_t
+ * @brief Application event handler. Handlers may be invoked from interrupt
+ * context and must return quickly.
+ */
+typedef void (*app_evt_handler_t)(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+void app_evt_dispatch(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void app_evt_enable(uint8_t slot);
+bool app_evt_contract_ok(const void *data);
+
+#if APP_FW_LED_ENABLE
+void led_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+#endif /* APP_FW_LED_ENABLE */
+
+#endif /* SRC_APP_EVT_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,334 @@
+/*******************************************************************************
+* File Name: batt_chg.c
+*
+* Description:
+*  This file contains the PPS direct battery charging. The PPS source regulates
+*  the charge current in current limit (CC) and the voltage is held at the
+*  battery termination voltage (CV) while the current tapers.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "batt_chg.h"
+#include "pps.h"
+#include "sink_fet.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdutils_sw_timer.h"
+#include "cy_pdstack_dpm.h"
+#include "cy_app.h"
+
+#if BATT_CHG_ENABLE
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+#if (EFF_SEARCH_ENABLE || CUR_PROBE_ENABLE)
+#error "BATT_CHG_ENABLE cannot be used together with EFF_SEARCH_ENABLE or CUR_PROBE_ENABLE"
+#endif /* (EFF_SEARCH_ENABLE || CUR_PROBE_ENABLE) */
+
+/* Charge safety timeout in timestamp ticks */
+#define BATT_CHG_MAX_TICKS                      ((uint32_t)BATT_CHG_MAX_TIME * 60000u * TIMESTAMP_TICKS_PER_MS)
+
+#if (BATT_CHG_MAX_TIME > (0xFFFFFFFFu / (60000u * TIMESTAMP_TICKS_PER_MS)))
+#error "BATT_CHG_MAX_TIME exceeds the timestamp range"
+#endif
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Charging status */
+static stc_batt_chg_stat_t gl_batt;
+
+/* Set when the measurement fields hold the response to the last request */
+static volatile bool gl_batt_meas_valid;
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/*******************************************************************************
+* Function Name: batt_status_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Get_PPS_Status command, invoked once the PPS
+*  module has stored the status. Stores VBUS, the output current and the
+*  current limit flag for the next charging step. VBUS is taken from the ADC
+*  when the source does not report its output voltage.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void batt_status_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    const stc_pps_status_t *status;
+
+    if ((resp != CY_PDSTACK_RES_RCVD) || (pkt == NULL) || (pkt->hdr.hdr.dataSize < 4u))
+    {
+        return;
+    }
+
+    status = pps_get_status();
+    if (status->outVolt != PPS_STATUS_VOLT_NOT_SUPP)
+    {
+        gl_batt.measVolt = status->outVolt * 20u;
+    }
+    else
+    {
+        gl_batt.measVolt = Cy_App_VbusGetValue(ctx);
+    }
+    gl_batt.measCur = (status->outCur != PPS_STATUS_CUR_NOT_SUPP) ? (status->outCur * 50u) : 0u;
+    gl_batt.omf = ((status->flags & PPS_STATUS_OMF_MASK) != 0u);
+    gl_batt_meas_valid = true;
+}
+
+/*******************************************************************************
+* Function Name: batt_settle_cb
+********************************************************************************
+* Summary:
+*  Posts a PPS status request once the new setpoint has settled. The message
+*  is sent from pps_task.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void batt_settle_cb(cy_timer_id_t id, void *callbackContext)
+{
+    (void)id;
+    (void)callbackContext;
+
+    pps_status_request(PPS_STATUS_REQ_BATT, batt_status_cb);
+}
+
+/*******************************************************************************
+* Function Name: batt_chg_stop
+********************************************************************************
+* Summary:
+*  Ends the charging cycle and latches the sink FET off until detach
+*
+* Parameters:
+*  context - PD Stack Context
+*  state - BATT_CHG_DONE or BATT_CHG_TIMEOUT
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void batt_chg_stop(cy_stc_pdstack_context_t *context, en_batt_chg_state_t state)
+{
+    gl_batt.state = state;
+    gl_batt.doneTs = timestamp_get_ticks();
+    gl_batt.cur = BATT_CHG_TERM_CUR;
+    sink_fet_latch_off(context);
+}
+
+/*******************************************************************************
+* Function Name: batt_chg_step
+********************************************************************************
+* Summary:
+*  Computes the next PPS request of the charging cycle. Called from pps_task
+*  on every PPS request period with the last requested setpoint.
+*
+*  CC starts BATT_CHG_START_MARGIN above the battery voltage with the current
+*  limit set to BATT_CHG_CUR, and the voltage is raised by BATT_CHG_VOLT_STEP
+*  until the source reports current limit (OMF). While in current limit the
+*  voltage is held and follows the battery. Once VBUS reaches
+*  BATT_CHG_TERM_VOLT the voltage is held there (CV) and the current limit
+*  tracks the tapering current. Charging ends when the reported current drops
+*  below BATT_CHG_TERM_CUR, which includes a source that does not report its
+*  output current, or when BATT_CHG_MAX_TIME expires. The sink FET is then
+*  latched off until detach.
+*
+* Parameters:
+*  context - PD Stack Context
+*  volt - Voltage in mV, updated with the voltage to request
+*  cur - Current in mA, updated with the current to request
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void batt_chg_step(cy_stc_pdstack_context_t *context, uint16_t *volt, uint16_t *cur)
+{
+    uint16_t limit = pps_get_cur_limit(context, *volt);
+    uint16_t max_volt = BATT_CHG_TERM_VOLT + BATT_CHG_VOLT_MARGIN;
+    uint32_t start_volt;
+
+    /* Not in a PPS contract yet */
+    if (limit == 0u)
+    {
+        return;
+    }
+
+    if (((gl_batt.state == BATT_CHG_CC) || (gl_batt.state == BATT_CHG_CV)) &&
+        ((timestamp_get_ticks() - gl_batt.ccTs) >= BATT_CHG_MAX_TICKS))
+    {
+        batt_chg_stop(context, BATT_CHG_TIMEOUT);
+    }
+
+    switch (gl_batt.state)
+    {
+        case BATT_CHG_IDLE:
+            gl_batt.state = BATT_CHG_CC;
+            gl_batt.ccTs = timestamp_get_ticks();
+            start_volt = batt_chg_get_batt_volt(context) + BATT_CHG_START_MARGIN;
+            /* Round up to the voltage step, the PPS request resolution */
+            start_volt = ((start_volt + BATT_CHG_VOLT_STEP - 1u) / BATT_CHG_VOLT_STEP) * BATT_CHG_VOLT_STEP;
+            gl_batt.volt = (start_volt > *volt) ? (uint16_t)start_volt : *volt;
+            if (gl_batt.volt > max_volt)
+            {
+                gl_batt.volt = max_volt;
+            }
+            gl_batt.cur = BATT_CHG_CUR;
+            break;
+
+        case BATT_CHG_CC:
+            if (!gl_batt_meas_valid)
+            {
+                break;
+            }
+            if (gl_batt.measVolt >= BATT_CHG_TERM_VOLT)
+            {
+                gl_batt.state = BATT_CHG_CV;
+                gl_batt.cvTs = timestamp_get_ticks();
+                gl_batt.volt = BATT_CHG_TERM_VOLT;
+            }
+            else if ((!gl_batt.omf) && (gl_batt.volt < max_volt))
+            {
+                /* Source still in CV: raise the voltage towards current limit */
+                gl_batt.volt += BATT_CHG_VOLT_STEP;
+                if (gl_batt.volt > max_volt)
+                {
+                    gl_batt.volt = max_volt;
+                }
+            }
+            else
+            {
+                /* Do Nothing */
+            }
+            break;
+
+        case BATT_CHG_CV:
+            if (!gl_batt_meas_valid)
+            {
+                break;
+            }
+            if (gl_batt.measCur < BATT_CHG_TERM_CUR)
+            {
+                batt_chg_stop(context, BATT_CHG_DONE);
+            }
+            else if ((gl_batt.measCur + BATT_CHG_CUR_MARGIN) < gl_batt.cur)
+            {
+                /* Taper the current limit with the battery current */
+                gl_batt.cur = gl_batt.measCur + BATT_CHG_CUR_MARGIN;
+            }
+            else
+            {
+                /* Do Nothing */
+            }
+            break;
+
+        default:
+            /* Charge done or timed out, keep the PPS contract alive */
+            break;
+    }
+
+    *volt = gl_batt.volt;
+    *cur = (gl_batt.cur < limit) ? gl_batt.cur : limit;
+
+    gl_batt_meas_valid = false;
+    if ((gl_batt.state == BATT_CHG_CC) || (gl_batt.state == BATT_CHG_CV))
+    {
+        Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, (void *)context, (cy_timer_id_t)BATT_CHG_TIMER_ID,
+                BATT_CHG_SETTLE_TIME, batt_settle_cb);
+    }
+}
+
+/*******************************************************************************
+* Function Name: batt_chg_reset
+********************************************************************************
+* Summary:
+*  Stops the charging cycle. Called by the PPS module when the contract is
+*  lost. The next PPS contract starts a new cycle from CC.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void batt_chg_reset(void)
+{
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)BATT_CHG_TIMER_ID);
+    gl_batt.state = BATT_CHG_IDLE;
+    gl_batt_meas_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: batt_chg_get_stat
+********************************************************************************
+* Summary:
+*  Returns the charging status
+*
+* Parameters:
+*  None
+*
+* Return:
+*  const stc_batt_chg_stat_t* - Charging status
+*
+*******************************************************************************/
+const stc_batt_chg_stat_t *batt_chg_get_stat(void)
+{
+    return &gl_batt;
+}
+
+#endif /* BATT_CHG_ENABLE */
+
+/* [] END OF FILE */
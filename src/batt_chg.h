@@ -0,0 +1,101 @@
+/*******************************************************************************
+* File Name: batt_chg.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  PPS direct battery charging used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_BATT_CHG_H_
+#define SRC_BATT_CHG_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_batt_chg_state_t
+ * @brief Direct charging states.
+ */
+typedef enum {
+    BATT_CHG_IDLE                    = 0, /**< Not charging, waiting for a PPS contract */
+    BATT_CHG_CC,                          /**< Constant current, source in current limit */
+    BATT_CHG_CV,                          /**< Constant voltage at the termination voltage */
+    BATT_CHG_DONE,                        /**< Charge terminated */
+    BATT_CHG_TIMEOUT,                     /**< Charge stopped by the safety timeout */
+} en_batt_chg_state_t;
+
+/**
+ * @typedef stc_batt_chg_stat_t
+ * @brief Direct charging status.
+ */
+typedef struct {
+    en_batt_chg_state_t state;           /**< Current state */
+    uint16_t volt;                       /**< Requested PPS voltage in mV */
+    uint16_t cur;                        /**< Requested PPS current limit in mA */
+    uint16_t measVolt;                   /**< Last measured VBUS in mV */
+    uint16_t measCur;                    /**< Last reported output current in mA, 0 if not reported */
+    bool omf;                            /**< Source was in current limit in the last status */
+    uint32_t ccTs;                       /**< Start of the CC phase in timestamp ticks */
+    uint32_t cvTs;                       /**< Start of the CV phase in timestamp ticks */
+    uint32_t doneTs;                     /**< Charge termination or timeout in timestamp ticks */
+} stc_batt_chg_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if BATT_CHG_ENABLE
+/* Provided by the application: battery voltage in mV */
+uint16_t batt_chg_get_batt_volt(cy_stc_pdstack_context_t *context);
+
+void batt_chg_step(cy_stc_pdstack_context_t *context, uint16_t *volt, uint16_t *cur);
+void batt_chg_reset(void);
+const stc_batt_chg_stat_t *batt_chg_get_stat(void);
+#else
+#define batt_chg_reset()                        ((void)0)
+#endif /* BATT_CHG_ENABLE */
+
+#endif /* SRC_BATT_CHG_H_ */
+
+/* [] END OF FILE */
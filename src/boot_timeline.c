@@ -0,0 +1,177 @@
+/*******************************************************************************
+* File Name: boot_timeline.c
+*
+* Description:
+*  This file contains the boot timeline. The completion time of each boot phase
+*  is recorded in timestamp ticks since reset, up to the first explicit contract.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "boot_timeline.h"
+#include "timestamp.h"
+#include "app_evt.h"
+#include "config.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Completion timestamp of each boot phase, 0 if not reached yet */
+static uint32_t gl_boot_timeline[BOOT_PHASE_COUNT];
+
+/*******************************************************************************
+* Function Name: boot_evt_handler
+********************************************************************************
+* Summary:
+*  Marks the first explicit contract in the boot timeline
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void boot_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)ctx;
+    (void)evt;
+
+    if (app_evt_contract_ok(data))
+    {
+        boot_mark(BOOT_PHASE_FIRST_CONTRACT);
+    }
+}
+
+/*******************************************************************************
+* Function Name: boot_mark
+********************************************************************************
+* Summary:
+*  Records the completion time of a boot phase. Only the first occurrence of
+*  each phase is recorded. With the boot fast path, the timestamp is held from
+*  connect detection to the deferred start so that BOOT_DEFER_TIMEOUT is
+*  measured across WDT counter wraps.
+*
+* Parameters:
+*  phase - Boot phase
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void boot_mark(en_boot_phase_t phase)
+{
+    uint32_t ts;
+
+    if ((phase < BOOT_PHASE_COUNT) && (gl_boot_timeline[phase] == 0u))
+    {
+        ts = timestamp_get_ticks();
+        /* 0 means not reached */
+        gl_boot_timeline[phase] = (ts != 0u) ? ts : 1u;
+
+#if APP_BOOT_FAST_PATH
+        if (phase == BOOT_PHASE_DPM_START)
+        {
+            timestamp_hold(TIMESTAMP_HOLD_BOOT, true);
+        }
+        else if (phase == BOOT_PHASE_DEFERRED_START)
+        {
+            timestamp_hold(TIMESTAMP_HOLD_BOOT, false);
+        }
+        else
+        {
+            /* No effect on the timestamp */
+        }
+#endif /* APP_BOOT_FAST_PATH */
+    }
+}
+
+/*******************************************************************************
+* Function Name: boot_get_timeline
+********************************************************************************
+* Summary:
+*  Returns the boot timeline, indexed by en_boot_phase_t
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Completion timestamps in ticks, see TIMESTAMP_TICKS_PER_MS
+*
+*******************************************************************************/
+const uint32_t *boot_get_timeline(void)
+{
+    return gl_boot_timeline;
+}
+
+/*******************************************************************************
+* Function Name: boot_deferred_start_due
+********************************************************************************
+* Summary:
+*  Checks whether the deferred non-critical work should be started now, i.e.
+*  the first explicit contract has been established or BOOT_DEFER_TIMEOUT has
+*  elapsed since connect detection was enabled. Returns true only once.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the deferred work should be started
+*
+*******************************************************************************/
+bool boot_deferred_start_due(void)
+{
+    if ((gl_boot_timeline[BOOT_PHASE_DEFERRED_START] != 0u) || (gl_boot_timeline[BOOT_PHASE_DPM_START] == 0u))
+    {
+        return false;
+    }
+
+    if ((gl_boot_timeline[BOOT_PHASE_FIRST_CONTRACT] != 0u) ||
+        ((timestamp_get_ticks() - gl_boot_timeline[BOOT_PHASE_DPM_START]) >=
+                (BOOT_DEFER_TIMEOUT * TIMESTAMP_TICKS_PER_MS)))
+    {
+        boot_mark(BOOT_PHASE_DEFERRED_START);
+        return true;
+    }
+
+    return false;
+}
+
+/* [] END OF FILE */
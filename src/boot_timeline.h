@@ -0,0 +1,84 @@
+/*******************************************************************************
+* File Name: boot_timeline.h
+*
+* Description:
+*  This file contains the boot phase IDs and function prototypes of the boot
+*  timeline used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_BOOT_TIMELINE_H_
+#define SRC_BOOT_TIMELINE_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_boot_phase_t
+ * @brief Boot phases. Each phase is marked when it completes.
+ */
+typedef enum {
+    BOOT_PHASE_BSP_INIT              = 0, /**< cybsp_init */
+    BOOT_PHASE_TIMER_INIT,                /**< WDT interrupt and soft timer */
+    BOOT_PHASE_INTR_INIT,                 /**< User switch, instrumentation and USBPD interrupts */
+    BOOT_PHASE_USBPD_INIT,                /**< Cy_USBPD_Init */
+    BOOT_PHASE_DPM_INIT,                  /**< Cy_PdStack_Dpm_Init */
+    BOOT_PHASE_APP_INIT,                  /**< Cy_App_Init */
+    BOOT_PHASE_FAULT_INIT,                /**< Cy_App_Fault_InitVars */
+    BOOT_PHASE_DPM_START,                 /**< Cy_PdStack_Dpm_Start, connect detection enabled */
+    BOOT_PHASE_FIRST_CONTRACT,            /**< First explicit contract */
+    BOOT_PHASE_DEFERRED_START,            /**< Non-critical work started */
+    BOOT_PHASE_COUNT                      /**< Number of boot phases */
+} en_boot_phase_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+void boot_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void boot_mark(en_boot_phase_t phase);
+const uint32_t *boot_get_timeline(void);
+bool boot_deferred_start_due(void);
+
+#endif /* SRC_BOOT_TIMELINE_H_ */
+
+/* [] END OF FILE */
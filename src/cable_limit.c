@@ -0,0 +1,243 @@
+/*******************************************************************************
+* File Name: cable_limit.c
+*
+* Description:
+*  This file contains the cable current limit. The limit is taken from an
+*  externally supplied cable rating, from the eMarker of the cable or from the
+*  default cable capability, in that order.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "cable_limit.h"
+#include "app_evt.h"
+#include "config.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Externally supplied cable rating of each port in mA, 0 if not set */
+static uint16_t gl_cable_rating[NO_OF_TYPEC_PORTS];
+
+/* Set when cable discovery should be attempted on a port */
+static volatile bool gl_cable_disc_pending[NO_OF_TYPEC_PORTS];
+
+/* Set once VCONN Swap has been requested for cable discovery on a port */
+static volatile bool gl_cable_vconn_swap[NO_OF_TYPEC_PORTS];
+
+/*******************************************************************************
+* Function Name: cable_evt_handler
+********************************************************************************
+* Summary:
+*  Schedules SOP' cable discovery after the first explicit contract. A hard
+*  reset gives VCONN back to the source and drops any outstanding VCONN Swap,
+*  so discovery is scheduled again; a detach cancels it.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cable_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)data;
+
+    if ((evt == APP_EVT_CONNECT) || (evt == APP_EVT_HARD_RESET_RCVD) || (evt == APP_EVT_HARD_RESET_SENT))
+    {
+        gl_cable_disc_pending[ctx->port] = true;
+        gl_cable_vconn_swap[ctx->port] = false;
+    }
+    else if (evt == APP_EVT_DISCONNECT)
+    {
+        gl_cable_disc_pending[ctx->port] = false;
+        gl_cable_vconn_swap[ctx->port] = false;
+    }
+    else
+    {
+        /* Not subscribed */
+    }
+}
+
+#if CABLE_VCONN_SWAP_ENABLE
+/*******************************************************************************
+* Function Name: cable_vconn_swap_cb
+********************************************************************************
+* Summary:
+*  Gives up cable discovery for this attach if the source does not accept
+*  VCONN Swap
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Response packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void cable_vconn_swap_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    if ((resp != CY_PDSTACK_RES_RCVD) || (pkt == NULL) || (pkt->msg != (uint8_t)CY_PD_CTRL_MSG_ACCEPT))
+    {
+        gl_cable_disc_pending[ctx->port] = false;
+    }
+}
+#endif /* CABLE_VCONN_SWAP_ENABLE */
+
+/*******************************************************************************
+* Function Name: cable_limit_task
+********************************************************************************
+* Summary:
+*  Initiates SOP' Discover Identity once per attach. A sink may only talk to
+*  the cable while it is the VCONN source and has an explicit contract, so the
+*  attempt is deferred until both are true. When the source supplies VCONN,
+*  VCONN Swap is requested first. Must be called from the main loop.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cable_limit_task(cy_stc_pdstack_context_t *context)
+{
+    uint8_t port = context->port;
+
+    if (!gl_cable_disc_pending[port] || !context->dpmConfig.contractExist)
+    {
+        return;
+    }
+
+    if (context->dpmStat.emcaPresent)
+    {
+        gl_cable_disc_pending[port] = false;
+        return;
+    }
+
+    if (!context->dpmConfig.vconnLogical)
+    {
+#if CABLE_VCONN_SWAP_ENABLE
+        if (!gl_cable_vconn_swap[port])
+        {
+            if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP, NULL, false,
+                        cable_vconn_swap_cb) == CY_PDSTACK_STAT_SUCCESS)
+            {
+                gl_cable_vconn_swap[port] = true;
+            }
+        }
+#else
+        gl_cable_disc_pending[port] = false;
+#endif /* CABLE_VCONN_SWAP_ENABLE */
+        return;
+    }
+
+    if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY, NULL, false, NULL) ==
+            CY_PDSTACK_STAT_SUCCESS)
+    {
+        gl_cable_disc_pending[port] = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cable_limit_set_rating
+********************************************************************************
+* Summary:
+*  Sets the cable current rating of a port, e.g. for captive cables whose
+*  rating is known by design. The rating takes precedence over the eMarker.
+*
+* Parameters:
+*  port - Port index
+*  cur - Cable current rating in mA, 0 to use the eMarker
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cable_limit_set_rating(uint8_t port, uint16_t cur)
+{
+    if (port < NO_OF_TYPEC_PORTS)
+    {
+        gl_cable_rating[port] = cur;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cable_limit_get_max_cur
+********************************************************************************
+* Summary:
+*  Returns the maximum current the attached cable can carry
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  uint16_t - Current in mA
+*
+*******************************************************************************/
+uint16_t cable_limit_get_max_cur(const cy_stc_pdstack_context_t *context)
+{
+    if (gl_cable_rating[context->port] != 0u)
+    {
+        return gl_cable_rating[context->port];
+    }
+
+    if (context->dpmStat.emcaPresent)
+    {
+        if (context->dpmStat.cblVdo.std_cbl_vdo.vbusCur == CABLE_VDO_VBUS_CUR_5A)
+        {
+            return 5000u;
+        }
+        if (context->dpmStat.cblVdo.std_cbl_vdo.vbusCur == CABLE_VDO_VBUS_CUR_3A)
+        {
+            return 3000u;
+        }
+    }
+
+    /* Cable without an eMarker: DPM default cable capability in 10mA units */
+    return (uint16_t)(context->dpmStat.dpmDefCableCap * 10u);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* File Name: cable_limit.h
+*
+* Description:
+*  This file contains the function prototypes of the cable current limit used
+*  in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_CABLE_LIMIT_H_
+#define SRC_CABLE_LIMIT_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * VBUS current handling capability encoding of the passive/active cable VDO.
+ */
+#define CABLE_VDO_VBUS_CUR_3A                   (1u)
+#define CABLE_VDO_VBUS_CUR_5A                   (2u)
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+void cable_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void cable_limit_task(cy_stc_pdstack_context_t *context);
+void cable_limit_set_rating(uint8_t port, uint16_t cur);
+uint16_t cable_limit_get_max_cur(const cy_stc_pdstack_context_t *context);
+
+#endif /* SRC_CABLE_LIMIT_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,288 @@
+/*******************************************************************************
+* File Name: charger_cache.c
+*
+* Description:
+*  This file contains the charger fingerprint cache. Chargers are identified by
+*  a hash of their SPR source capabilities and SCEDB identity and kept in
+*  least recently used order.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "charger_cache.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* FNV-1a hash parameters */
+#define FNV_OFFSET_BASIS                        (0x811C9DC5u)
+#define FNV_PRIME                               (0x01000193u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Cache entries, most recently used first */
+static stc_charger_entry_t gl_charger_cache[CHARGER_CACHE_SIZE];
+
+/* Number of valid entries */
+static uint8_t gl_charger_cache_cnt;
+
+/*******************************************************************************
+* Function Name: fnv_update
+********************************************************************************
+* Summary:
+*  Adds a 32-bit word to an FNV-1a hash
+*
+* Parameters:
+*  hash - Current hash value
+*  val - Word to be added
+*
+* Return:
+*  uint32_t - Updated hash value
+*
+*******************************************************************************/
+static uint32_t fnv_update(uint32_t hash, uint32_t val)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < 4u; idx++)
+    {
+        hash ^= (val & 0xFFu);
+        hash *= FNV_PRIME;
+        val >>= 8u;
+    }
+
+    return hash;
+}
+
+/*******************************************************************************
+* Function Name: move_to_front
+********************************************************************************
+* Summary:
+*  Moves a cache entry to the most recently used position
+*
+* Parameters:
+*  idx - Index of the entry
+*
+* Return:
+*  stc_charger_entry_t - Entry at its new position
+*
+*******************************************************************************/
+static stc_charger_entry_t *move_to_front(uint8_t idx)
+{
+    stc_charger_entry_t entry;
+
+    if (idx != 0u)
+    {
+        entry = gl_charger_cache[idx];
+        memmove(&gl_charger_cache[1], &gl_charger_cache[0], idx * sizeof(stc_charger_entry_t));
+        gl_charger_cache[0] = entry;
+    }
+
+    return &gl_charger_cache[0];
+}
+
+/*******************************************************************************
+* Function Name: charger_cache_key
+********************************************************************************
+* Summary:
+*  Computes the fingerprint of a charger
+*
+* Parameters:
+*  pdo - Source PDOs
+*  count - Number of PDOs
+*  vid - Vendor ID of the charger, 0 if unknown
+*  pid - Product ID of the charger, 0 if unknown
+*
+* Return:
+*  uint32_t - Fingerprint
+*
+*******************************************************************************/
+uint32_t charger_cache_key(const cy_pd_pd_do_t *pdo, uint8_t count, uint16_t vid, uint16_t pid)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    uint8_t idx;
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        hash = fnv_update(hash, pdo[idx].val);
+    }
+
+    return fnv_update(hash, ((uint32_t)vid << 16u) | pid);
+}
+
+/*******************************************************************************
+* Function Name: charger_cache_lookup
+********************************************************************************
+* Summary:
+*  Looks up a charger and marks it as most recently used
+*
+* Parameters:
+*  key - Charger fingerprint
+*
+* Return:
+*  stc_charger_entry_t - Cache entry, NULL if the charger is not known
+*
+*******************************************************************************/
+stc_charger_entry_t *charger_cache_lookup(uint32_t key)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < gl_charger_cache_cnt; idx++)
+    {
+        if (gl_charger_cache[idx].key == key)
+        {
+            return move_to_front(idx);
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: charger_cache_insert
+********************************************************************************
+* Summary:
+*  Returns the entry of a charger, creating it if necessary. When the cache
+*  is full, the least recently used entry is replaced.
+*
+* Parameters:
+*  key - Charger fingerprint
+*
+* Return:
+*  stc_charger_entry_t - Cache entry
+*
+*******************************************************************************/
+stc_charger_entry_t *charger_cache_insert(uint32_t key)
+{
+    stc_charger_entry_t *entry = charger_cache_lookup(key);
+
+    if (entry == NULL)
+    {
+        if (gl_charger_cache_cnt < CHARGER_CACHE_SIZE)
+        {
+            gl_charger_cache_cnt++;
+        }
+
+        /* The last slot is either unused or the least recently used entry */
+        entry = move_to_front(gl_charger_cache_cnt - 1u);
+        memset(entry, 0, sizeof(stc_charger_entry_t));
+        entry->key = key;
+    }
+
+    return entry;
+}
+
+/*******************************************************************************
+* Function Name: charger_cache_evict
+********************************************************************************
+* Summary:
+*  Removes the entry of a charger from the cache
+*
+* Parameters:
+*  key - Charger fingerprint
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void charger_cache_evict(uint32_t key)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < gl_charger_cache_cnt; idx++)
+    {
+        if (gl_charger_cache[idx].key == key)
+        {
+            gl_charger_cache_cnt--;
+            memmove(&gl_charger_cache[idx], &gl_charger_cache[idx + 1u],
+                    (gl_charger_cache_cnt - idx) * sizeof(stc_charger_entry_t));
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: charger_cache_export
+********************************************************************************
+* Summary:
+*  Copies the cache entries, most recently used first
+*
+* Parameters:
+*  entries - Destination buffer
+*  max - Capacity of the destination buffer
+*
+* Return:
+*  uint8_t - Number of entries copied
+*
+*******************************************************************************/
+uint8_t charger_cache_export(stc_charger_entry_t *entries, uint8_t max)
+{
+    uint8_t count = (gl_charger_cache_cnt < max) ? gl_charger_cache_cnt : max;
+
+    memcpy(entries, gl_charger_cache, count * sizeof(stc_charger_entry_t));
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: charger_cache_import
+********************************************************************************
+* Summary:
+*  Replaces the cache content, e.g. with entries restored from flash
+*
+* Parameters:
+*  entries - Entries, most recently used first
+*  count - Number of entries
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void charger_cache_import(const stc_charger_entry_t *entries, uint8_t count)
+{
+    if (count > CHARGER_CACHE_SIZE)
+    {
+        count = CHARGER_CACHE_SIZE;
+    }
+
+    memcpy(gl_charger_cache, entries, count * sizeof(stc_charger_entry_t));
+    gl_charger_cache_cnt = count;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/*******************************************************************************
+* File Name: charger_cache.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  charger fingerprint cache used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_CHARGER_CACHE_H_
+#define SRC_CHARGER_CACHE_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef stc_charger_entry_t
+ * @brief Operating point remembered for one charger.
+ */
+typedef struct {
+    uint32_t key;                        /**< Fingerprint of the source capabilities */
+    uint16_t volt;                       /**< Last accepted voltage in mV */
+    uint16_t cur;                        /**< Last accepted current in mA */
+    uint16_t maxPpsVolt;                 /**< Maximum PPS voltage of the charger in mV */
+    uint16_t maxCur;                     /**< Probed sustainable current at volt in mA, 0 if not probed */
+    uint8_t objPos;                      /**< Object position of the last accepted PDO */
+} stc_charger_entry_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+uint32_t charger_cache_key(const cy_pd_pd_do_t *pdo, uint8_t count, uint16_t vid, uint16_t pid);
+stc_charger_entry_t *charger_cache_lookup(uint32_t key);
+stc_charger_entry_t *charger_cache_insert(uint32_t key);
+void charger_cache_evict(uint32_t key);
+uint8_t charger_cache_export(stc_charger_entry_t *entries, uint8_t max);
+void charger_cache_import(const stc_charger_entry_t *entries, uint8_t count);
+
+#endif /* SRC_CHARGER_CACHE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+* File Name: crc16.c
+*
+* Description:
+*  This file contains a table-less CRC-16/CCITT-FALSE routine (polynomial
+*  0x1021) used to protect stored and transmitted records.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "crc16.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+#define CRC16_POLY                              (0x1021u)
+
+/*******************************************************************************
+* Function Name: crc16_update
+********************************************************************************
+* Summary:
+*  Adds a block of data to a CRC-16 calculation
+*
+* Parameters:
+*  crc - Current CRC value, CRC16_INIT for a new calculation
+*  data - Data
+*  len - Length of data in bytes
+*
+* Return:
+*  uint16_t - Updated CRC value
+*
+*******************************************************************************/
+uint16_t crc16_update(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    uint8_t bit;
+
+    while (len-- != 0u)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8u);
+        for (bit = 0u; bit < 8u; bit++)
+        {
+            if ((crc & 0x8000u) != 0u)
+            {
+                crc = (uint16_t)((crc << 1u) ^ CRC16_POLY);
+            }
+            else
+            {
+                crc = (uint16_t)(crc << 1u);
+            }
+        }
+    }
+
+    return crc;
+}
+
+/* [] END OF FILE */
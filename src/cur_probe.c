@@ -0,0 +1,360 @@
+/*******************************************************************************
+* File Name: cur_probe.c
+*
+* Description:
+*  This file contains the PPS current probing. The operating current requested
+*  at the present PPS voltage is binary searched for the highest value at which
+*  the source stays in constant voltage mode, and the result is cached per
+*  voltage band until detach.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "cur_probe.h"
+#include "pps.h"
+#include "src_cap_ext.h"
+#include "cy_pdl.h"
+#include "cy_pdutils_sw_timer.h"
+#include "cy_pdstack_dpm.h"
+#include "cy_app.h"
+
+#if CUR_PROBE_ENABLE
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+#if EFF_SEARCH_ENABLE
+#error "CUR_PROBE_ENABLE and EFF_SEARCH_ENABLE cannot be used together"
+#endif /* EFF_SEARCH_ENABLE */
+
+/* No band is being probed */
+#define CUR_PROBE_NO_BAND                       (0xFFu)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Highest current (mA) holding constant voltage mode per band, 0 if not probed */
+static uint16_t gl_probe_cur[CUR_PROBE_BANDS];
+
+/* Band being probed */
+static uint8_t gl_probe_band = CUR_PROBE_NO_BAND;
+
+/* Search interval and current trial (mA), voltage of the trial (mV) */
+static uint16_t gl_probe_lo;
+static uint16_t gl_probe_hi;
+static uint16_t gl_probe_trial;
+static uint16_t gl_probe_volt;
+
+/* Outcome of the current trial: 0 pending, 1 holds, -1 fails */
+static volatile int8_t gl_probe_result;
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/*******************************************************************************
+* Function Name: probe_status_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Get_PPS_Status command, invoked once the PPS
+*  module has stored the status. The trial fails if the source reports current
+*  limit (OMF) or VBUS has drooped by more than CUR_PROBE_DROOP_MAX below the
+*  requested voltage.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void probe_status_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    const stc_pps_status_t *status;
+    uint16_t volt;
+
+    if ((resp != CY_PDSTACK_RES_RCVD) || (pkt == NULL) || (pkt->hdr.hdr.dataSize < 4u))
+    {
+        return;
+    }
+
+    status = pps_get_status();
+    if (status->outVolt != PPS_STATUS_VOLT_NOT_SUPP)
+    {
+        volt = status->outVolt * 20u;
+    }
+    else
+    {
+        volt = Cy_App_VbusGetValue(ctx);
+    }
+
+    if (((status->flags & PPS_STATUS_OMF_MASK) != 0u) || ((volt + CUR_PROBE_DROOP_MAX) < gl_probe_volt))
+    {
+        gl_probe_result = -1;
+    }
+    else
+    {
+        gl_probe_result = 1;
+    }
+}
+
+/*******************************************************************************
+* Function Name: probe_settle_cb
+********************************************************************************
+* Summary:
+*  Posts a PPS status request once the trial current has settled. The
+*  message is sent from pps_task.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void probe_settle_cb(cy_timer_id_t id, void *callbackContext)
+{
+    (void)id;
+    (void)callbackContext;
+
+    pps_status_request(PPS_STATUS_REQ_PROBE, probe_status_cb);
+}
+
+/*******************************************************************************
+* Function Name: probe_trial
+********************************************************************************
+* Summary:
+*  Starts the evaluation of the trial current that is about to be requested.
+*  The step above the last current that held is limited to the load step the
+*  source reports in its extended capabilities.
+*
+* Parameters:
+*  context - PD Stack Context
+*  cur - Trial current in mA
+*
+* Return:
+*  uint16_t - Trial current in mA
+*
+*******************************************************************************/
+static uint16_t probe_trial(cy_stc_pdstack_context_t *context, uint16_t cur)
+{
+    uint8_t step_pct = src_cap_ext_get_load_step(context);
+    uint16_t step_max = (uint16_t)(((uint32_t)gl_probe_lo * step_pct) / 100u);
+
+    /* Do not step the load by more than the source can regulate through */
+    if ((step_pct < 100u) && (cur > gl_probe_lo) && ((cur - gl_probe_lo) > step_max))
+    {
+        cur = gl_probe_lo + ((step_max > CUR_PROBE_RES) ? step_max : CUR_PROBE_RES);
+    }
+
+    gl_probe_trial = cur;
+    gl_probe_result = 0;
+    Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, (void *)context, (cy_timer_id_t)CUR_PROBE_TIMER_ID,
+            CUR_PROBE_SETTLE_TIME, probe_settle_cb);
+
+    return cur;
+}
+
+/*******************************************************************************
+* Function Name: cur_probe_step
+********************************************************************************
+* Summary:
+*  Returns the operating current to request at the given PPS voltage. Called
+*  on every PPS request period. The first trial of a band is the highest
+*  current allowed by the source, sink and cable. If it does not hold, the
+*  search continues between the last current that held and the last one that
+*  failed until they are within CUR_PROBE_RES.
+*
+* Parameters:
+*  context - PD Stack Context
+*  volt - PPS voltage in mV
+*  cur - Default current in mA, the lower bound of the search
+*
+* Return:
+*  uint16_t - Current to request in mA
+*
+*******************************************************************************/
+uint16_t cur_probe_step(cy_stc_pdstack_context_t *context, uint16_t volt, uint16_t cur)
+{
+    uint8_t band = (uint8_t)(volt / CUR_PROBE_BAND_WIDTH);
+    uint16_t limit = pps_get_cur_limit(context, volt);
+    uint16_t step;
+
+    if (band >= CUR_PROBE_BANDS)
+    {
+        band = CUR_PROBE_BANDS - 1u;
+    }
+
+    /* Not in a PPS contract, nothing to probe against */
+    if (limit == 0u)
+    {
+        return cur;
+    }
+    if (cur > limit)
+    {
+        cur = limit;
+    }
+
+    if (gl_probe_cur[band] != 0u)
+    {
+        return (gl_probe_cur[band] < limit) ? gl_probe_cur[band] : limit;
+    }
+
+    if ((band != gl_probe_band) || (volt != gl_probe_volt))
+    {
+        /* Start (or restart on a voltage change) the search of this band */
+        gl_probe_band = band;
+        gl_probe_volt = volt;
+        gl_probe_lo = cur;
+        gl_probe_hi = limit;
+        return probe_trial(context, limit);
+    }
+
+    if (gl_probe_result == 0)
+    {
+        /* No answer yet, keep the trial current and measure again */
+        return probe_trial(context, gl_probe_trial);
+    }
+
+    if (gl_probe_result > 0)
+    {
+        gl_probe_lo = gl_probe_trial;
+    }
+    else
+    {
+        gl_probe_hi = (gl_probe_trial > (gl_probe_lo + CUR_PROBE_RES)) ? (gl_probe_trial - CUR_PROBE_RES) : gl_probe_lo;
+    }
+
+    if (gl_probe_hi < (gl_probe_lo + CUR_PROBE_RES))
+    {
+        gl_probe_cur[band] = gl_probe_lo;
+        gl_probe_band = CUR_PROBE_NO_BAND;
+        return gl_probe_lo;
+    }
+
+    /* Midpoint rounded down to the current resolution, at least one step above lo */
+    step = (uint16_t)((((gl_probe_hi - gl_probe_lo) >> 1u) / CUR_PROBE_RES) * CUR_PROBE_RES);
+    if (step < CUR_PROBE_RES)
+    {
+        step = CUR_PROBE_RES;
+    }
+
+    return probe_trial(context, gl_probe_lo + step);
+}
+
+/*******************************************************************************
+* Function Name: cur_probe_reset
+********************************************************************************
+* Summary:
+*  Aborts the search in progress. The cached currents are kept across hard
+*  resets and cleared on detach. Called by the PPS module.
+*
+* Parameters:
+*  detach - true if the source has been detached
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cur_probe_reset(bool detach)
+{
+    uint8_t i;
+
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)CUR_PROBE_TIMER_ID);
+    gl_probe_band = CUR_PROBE_NO_BAND;
+
+    if (detach)
+    {
+        for (i = 0u; i < CUR_PROBE_BANDS; i++)
+        {
+            gl_probe_cur[i] = 0u;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: cur_probe_get
+********************************************************************************
+* Summary:
+*  Returns the cached current of the band holding a voltage
+*
+* Parameters:
+*  volt - Voltage in mV
+*
+* Return:
+*  uint16_t - Current in mA, 0 if the band has not been probed
+*
+*******************************************************************************/
+uint16_t cur_probe_get(uint16_t volt)
+{
+    uint8_t band = (uint8_t)(volt / CUR_PROBE_BAND_WIDTH);
+
+    return gl_probe_cur[(band < CUR_PROBE_BANDS) ? band : (CUR_PROBE_BANDS - 1u)];
+}
+
+/*******************************************************************************
+* Function Name: cur_probe_seed
+********************************************************************************
+* Summary:
+*  Sets the sustainable current of a voltage band from an earlier session
+*  with the same charger, so that the band is not probed again
+*
+* Parameters:
+*  volt - Voltage in mV
+*  cur - Sustainable current in mA, 0 if not known
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void cur_probe_seed(uint16_t volt, uint16_t cur)
+{
+    uint8_t band = (uint8_t)(volt / CUR_PROBE_BAND_WIDTH);
+
+    if (cur != 0u)
+    {
+        gl_probe_cur[(band < CUR_PROBE_BANDS) ? band : (CUR_PROBE_BANDS - 1u)] = cur;
+    }
+}
+
+#endif /* CUR_PROBE_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,85 @@
+/*******************************************************************************
+* File Name: cur_probe.h
+*
+* Description:
+*  This file contains the function prototypes of the PPS current probing used
+*  in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_CUR_PROBE_H_
+#define SRC_CUR_PROBE_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Number of voltage bands the probed current is cached for. Voltages above
+ * the last band share its entry.
+ */
+#define CUR_PROBE_BANDS                         (22u)
+
+/*
+ * Current resolution (mA) of the probing, the PPS operating current unit.
+ */
+#define CUR_PROBE_RES                           (50u)
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if CUR_PROBE_ENABLE
+uint16_t cur_probe_step(cy_stc_pdstack_context_t *context, uint16_t volt, uint16_t cur);
+void cur_probe_reset(bool detach);
+uint16_t cur_probe_get(uint16_t volt);
+void cur_probe_seed(uint16_t volt, uint16_t cur);
+#else
+#define cur_probe_reset(detach)                 ((void)0)
+#define cur_probe_get(volt)                     (0u)
+#define cur_probe_seed(volt, cur)               ((void)0)
+#endif /* CUR_PROBE_ENABLE */
+
+#endif /* SRC_CUR_PROBE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,344 @@
+/*******************************************************************************
+* File Name: eff_search.c
+*
+* Description:
+*  This file contains the efficiency search. The PPS voltage is hill-climbed in
+*  fine steps towards the setpoint that draws the least input power for the
+*  present load, and the search is re-run periodically to follow load and
+*  temperature changes.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "eff_search.h"
+#include "pps.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdutils_sw_timer.h"
+#include "cy_pdstack_dpm.h"
+#include "cy_app.h"
+
+#if EFF_SEARCH_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Search status */
+static stc_eff_search_stat_t gl_eff;
+
+/* Input power (mW) measured at the present setpoint */
+static uint32_t gl_eff_pwr;
+
+/* Set when gl_eff_pwr holds a measurement of the present setpoint */
+static volatile bool gl_eff_pwr_valid;
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/*******************************************************************************
+* Function Name: eff_status_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Get_PPS_Status command, invoked once the PPS
+*  module has stored the status. Computes the input power from the output
+*  current reported by the source and the output voltage, falling back to the
+*  VBUS ADC when the source does not report the voltage.
+*  Samples taken while the source is in current limit are dropped because the
+*  load is then not at its constant output point.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void eff_status_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    const stc_pps_status_t *status;
+    uint32_t volt;
+
+    if ((resp != CY_PDSTACK_RES_RCVD) || (pkt == NULL) || (pkt->hdr.hdr.dataSize < 4u))
+    {
+        return;
+    }
+
+    status = pps_get_status();
+    if ((status->outCur == PPS_STATUS_CUR_NOT_SUPP) || ((status->flags & PPS_STATUS_OMF_MASK) != 0u))
+    {
+        return;
+    }
+
+    if (status->outVolt != PPS_STATUS_VOLT_NOT_SUPP)
+    {
+        volt = (uint32_t)status->outVolt * 20u;
+    }
+    else
+    {
+        volt = Cy_App_VbusGetValue(ctx);
+    }
+
+    gl_eff_pwr = (volt * ((uint32_t)status->outCur * 50u)) / 1000u;
+    gl_eff_pwr_valid = true;
+}
+
+/*******************************************************************************
+* Function Name: eff_settle_cb
+********************************************************************************
+* Summary:
+*  Requests the PPS status once the new setpoint has settled. Runs in the
+*  timer interrupt, so the message is sent from pps_task.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void eff_settle_cb(cy_timer_id_t id, void *callbackContext)
+{
+    (void)id;
+    (void)callbackContext;
+
+    pps_status_request(PPS_STATUS_REQ_EFF, eff_status_cb);
+}
+
+/*******************************************************************************
+* Function Name: eff_measure
+********************************************************************************
+* Summary:
+*  Starts the measurement of the setpoint that is about to be requested
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void eff_measure(cy_stc_pdstack_context_t *context)
+{
+    gl_eff_pwr_valid = false;
+    Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, (void *)context, (cy_timer_id_t)EFF_SEARCH_TIMER_ID,
+            EFF_SEARCH_SETTLE_TIME, eff_settle_cb);
+}
+
+/*******************************************************************************
+* Function Name: eff_finish
+********************************************************************************
+* Summary:
+*  Ends the present run and holds the best setpoint
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint16_t - Best setpoint in mV
+*
+*******************************************************************************/
+static uint16_t eff_finish(void)
+{
+    gl_eff.state = EFF_SEARCH_HOLD;
+    gl_eff_pwr_valid = false;
+    gl_eff.convTicks = timestamp_get_ticks() - gl_eff.runTs;
+    gl_eff.runCnt++;
+
+    return gl_eff.bestVolt;
+}
+
+/*******************************************************************************
+* Function Name: eff_search_step
+********************************************************************************
+* Summary:
+*  Returns the next PPS setpoint. Called on every PPS request period once the
+*  first PPS contract is in place. A run first steps the voltage down while the
+*  input power keeps dropping by more than EFF_SEARCH_HYST. If the very first
+*  step down does not help, the voltage is stepped up instead. The best
+*  setpoint is then held for EFF_SEARCH_PERIOD.
+*
+* Parameters:
+*  context - PD Stack Context
+*  volt - Present setpoint in mV
+*  min_volt - Lowest allowed setpoint in mV
+*  max_volt - Highest allowed setpoint in mV
+*
+* Return:
+*  uint16_t - Next setpoint in mV
+*
+*******************************************************************************/
+uint16_t eff_search_step(cy_stc_pdstack_context_t *context, uint16_t volt, uint16_t min_volt, uint16_t max_volt)
+{
+    uint16_t next = volt;
+    uint32_t pwr;
+
+    if (gl_eff.state == EFF_SEARCH_HOLD)
+    {
+        if ((timestamp_get_ticks() - gl_eff.runTs) < (EFF_SEARCH_PERIOD * TIMESTAMP_TICKS_PER_MS))
+        {
+            return gl_eff.bestVolt;
+        }
+        gl_eff.state = EFF_SEARCH_IDLE;
+        volt = gl_eff.bestVolt;
+        next = volt;
+    }
+
+    /* Keep the present setpoint until it has been measured */
+    if (!gl_eff_pwr_valid)
+    {
+        eff_measure(context);
+        return volt;
+    }
+    pwr = gl_eff_pwr;
+
+    switch (gl_eff.state)
+    {
+        case EFF_SEARCH_IDLE:
+            gl_eff.bestVolt = volt;
+            gl_eff.bestPwr = pwr;
+            gl_eff.startPwr = pwr;
+            gl_eff.runTs = timestamp_get_ticks();
+            gl_eff.steps = 0u;
+            gl_eff.state = EFF_SEARCH_DOWN;
+            next = volt - EFF_SEARCH_STEP;
+            break;
+
+        case EFF_SEARCH_DOWN:
+            gl_eff.steps++;
+            if ((pwr + EFF_SEARCH_HYST) < gl_eff.bestPwr)
+            {
+                gl_eff.bestVolt = volt;
+                gl_eff.bestPwr = pwr;
+                next = volt - EFF_SEARCH_STEP;
+            }
+            else if (gl_eff.steps == 1u)
+            {
+                gl_eff.state = EFF_SEARCH_UP;
+                next = gl_eff.bestVolt + EFF_SEARCH_STEP;
+            }
+            else
+            {
+                return eff_finish();
+            }
+            break;
+
+        case EFF_SEARCH_UP:
+            gl_eff.steps++;
+            if ((pwr + EFF_SEARCH_HYST) < gl_eff.bestPwr)
+            {
+                gl_eff.bestVolt = volt;
+                gl_eff.bestPwr = pwr;
+                next = volt + EFF_SEARCH_STEP;
+            }
+            else
+            {
+                return eff_finish();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if ((gl_eff.state == EFF_SEARCH_DOWN) && (next < min_volt))
+    {
+        /* Lower limit reached: try the other direction only if no step down was taken */
+        if (gl_eff.steps != 0u)
+        {
+            return eff_finish();
+        }
+        gl_eff.state = EFF_SEARCH_UP;
+        next = gl_eff.bestVolt + EFF_SEARCH_STEP;
+    }
+
+    if (next > max_volt)
+    {
+        return eff_finish();
+    }
+
+    eff_measure(context);
+
+    return next;
+}
+
+/*******************************************************************************
+* Function Name: eff_search_reset
+********************************************************************************
+* Summary:
+*  Resets the search. Called by the PPS module on detach and hard reset.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void eff_search_reset(void)
+{
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)EFF_SEARCH_TIMER_ID);
+    gl_eff.state = EFF_SEARCH_IDLE;
+    gl_eff.runCnt = 0u;
+    gl_eff_pwr_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: eff_search_get_stat
+********************************************************************************
+* Summary:
+*  Returns the search status
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_eff_search_stat_t - Search status
+*
+*******************************************************************************/
+const stc_eff_search_stat_t *eff_search_get_stat(void)
+{
+    return &gl_eff;
+}
+
+#endif /* EFF_SEARCH_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name: eff_search.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  efficiency search used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_EFF_SEARCH_H_
+#define SRC_EFF_SEARCH_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_eff_search_state_t
+ * @brief Efficiency search states.
+ */
+typedef enum {
+    EFF_SEARCH_IDLE                  = 0, /**< No search started since attach */
+    EFF_SEARCH_DOWN,                      /**< Stepping the voltage down */
+    EFF_SEARCH_UP,                        /**< Stepping the voltage up */
+    EFF_SEARCH_HOLD,                      /**< Holding the best setpoint until the next run */
+} en_eff_search_state_t;
+
+/**
+ * @typedef stc_eff_search_stat_t
+ * @brief Efficiency search status.
+ */
+typedef struct {
+    en_eff_search_state_t state;         /**< Current state */
+    uint16_t bestVolt;                   /**< Setpoint with the lowest input power in mV */
+    uint32_t bestPwr;                    /**< Input power at bestVolt in mW */
+    uint32_t startPwr;                   /**< Input power at the start of the last run in mW */
+    uint32_t runTs;                      /**< Timestamp of the start of the last run */
+    uint32_t convTicks;                  /**< Ticks taken by the last run to converge */
+    uint16_t steps;                      /**< Setpoints tried by the last run */
+    uint16_t runCnt;                     /**< Number of completed runs since attach */
+} stc_eff_search_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if EFF_SEARCH_ENABLE
+uint16_t eff_search_step(cy_stc_pdstack_context_t *context, uint16_t volt, uint16_t min_volt, uint16_t max_volt);
+void eff_search_reset(void);
+const stc_eff_search_stat_t *eff_search_get_stat(void);
+#else
+#define eff_search_reset()                      ((void)0)
+#endif /* EFF_SEARCH_ENABLE */
+
+#endif /* SRC_EFF_SEARCH_H_ */
+
+/* [] END OF FILE */
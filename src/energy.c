@@ -0,0 +1,325 @@
+/*******************************************************************************
+* File Name: energy.c
+*
+* Description:
+*  This file contains the energy and charge accounting. VBUS voltage and sink
+*  current are sampled at a fixed rate while a source is attached and integrated
+*  in 64-bit fixed point accumulators.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "energy.h"
+#include "pps.h"
+#include "app_evt.h"
+#include "cy_pdl.h"
+#include "cy_pdutils_sw_timer.h"
+#include "cy_pdstack_dpm.h"
+#include "cy_app.h"
+
+#if ENERGY_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Sum of mV * mA over all samples */
+static uint64_t gl_energy_acc;
+
+/* Sum of mA over all samples */
+static uint64_t gl_charge_acc;
+
+/* Number of samples */
+static uint32_t gl_energy_samples;
+
+/* Sample periods elapsed and not yet integrated by energy_task */
+static volatile uint8_t gl_energy_due;
+
+/* Set when a PPS_Status has been received since the last sample */
+static volatile bool gl_energy_status_new;
+
+/* Sample periods since the last PPS_Status was received */
+static uint8_t gl_energy_status_age;
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/* USB PD context */
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: energy_scale
+********************************************************************************
+* Summary:
+*  Multiplies an accumulator by a Q32 scale factor and rounds to the nearest
+*  integer. The accumulator is split in 32-bit halves so that the products
+*  cannot overflow.
+*
+* Parameters:
+*  acc - Accumulator
+*  scale - Q32 scale factor
+*
+* Return:
+*  uint32_t - Scaled value
+*
+*******************************************************************************/
+static uint32_t energy_scale(uint64_t acc, uint64_t scale)
+{
+    return (uint32_t)(((acc >> 32u) * scale) + ((((acc & 0xFFFFFFFFu) * scale) + 0x80000000u) >> 32u));
+}
+
+/*******************************************************************************
+* Function Name: energy_sink_cur
+********************************************************************************
+* Summary:
+*  Returns the sink current. The output current reported in PPS_Status is used
+*  while it is no older than ENERGY_STATUS_MAX_AGE sample periods, otherwise
+*  the operating current of the explicit contract.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  uint32_t - Current in mA, 0 without an explicit contract
+*
+*******************************************************************************/
+static uint32_t energy_sink_cur(cy_stc_pdstack_context_t *context)
+{
+    const stc_pps_status_t *status = pps_get_status();
+
+    if (gl_energy_status_new)
+    {
+        gl_energy_status_new = false;
+        gl_energy_status_age = 0u;
+    }
+    else if (gl_energy_status_age < ENERGY_STATUS_MAX_AGE)
+    {
+        gl_energy_status_age++;
+    }
+
+    if (!context->dpmConfig.contractExist)
+    {
+        return 0u;
+    }
+
+    if ((gl_energy_status_age < ENERGY_STATUS_MAX_AGE) && (status->valid) &&
+        (status->outCur != PPS_STATUS_CUR_NOT_SUPP))
+    {
+        return (uint32_t)status->outCur * 50u;
+    }
+
+    return (uint32_t)context->dpmStat.contract.curPwr * 10u;
+}
+
+/*******************************************************************************
+* Function Name: energy_status_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Get_PPS_Status command, invoked once the PPS
+*  module has stored the status
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void energy_status_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    (void)ctx;
+
+    if ((resp == CY_PDSTACK_RES_RCVD) && (pkt != NULL) && (pkt->hdr.hdr.dataSize >= 4u))
+    {
+        gl_energy_status_new = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: energy_timer_cb
+********************************************************************************
+* Summary:
+*  Posts one sample to energy_task and, under a PPS contract, a Get_PPS_Status
+*  request for the next one. The VBUS ADC is not read here because this
+*  callback runs in the timer interrupt.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void energy_timer_cb(cy_timer_id_t id, void *callbackContext)
+{
+    cy_stc_pdstack_context_t *context = (cy_stc_pdstack_context_t *)callbackContext;
+    const cy_pd_pd_do_t *pdo = &context->dpmStat.srcSelPdo;
+
+    if (gl_energy_due != UINT8_MAX)
+    {
+        gl_energy_due++;
+    }
+
+    if ((context->dpmConfig.contractExist) && (pdo->pps_src.supplyType == CY_PDSTACK_PDO_AUGMENTED) &&
+        (pdo->pps_src.apdoType == CY_PDSTACK_APDO_PPS))
+    {
+        pps_status_request(PPS_STATUS_REQ_ENERGY, energy_status_cb);
+    }
+
+    Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, callbackContext, id, ENERGY_SAMPLE_PERIOD, energy_timer_cb);
+}
+
+/*******************************************************************************
+* Function Name: energy_task
+********************************************************************************
+* Summary:
+*  Adds the samples posted by the energy timer to the accumulators. Must be
+*  called from the main loop.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void energy_task(cy_stc_pdstack_context_t *context)
+{
+    uint32_t intr_state;
+    uint32_t due;
+    uint32_t cur;
+    uint32_t volt;
+
+    if (gl_energy_due == 0u)
+    {
+        return;
+    }
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    due = gl_energy_due;
+    gl_energy_due = 0u;
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    /* Samples missed by a long main loop pass take the present reading */
+    cur = energy_sink_cur(context);
+    volt = Cy_App_VbusGetValue(context);
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    gl_energy_acc += (uint64_t)volt * cur * due;
+    gl_charge_acc += (uint64_t)cur * due;
+    gl_energy_samples += due;
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: energy_evt_handler
+********************************************************************************
+* Summary:
+*  Starts the accounting on attach and clears it on detach
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void energy_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)data;
+
+    if (ctx->port != gl_PdStackPort0Ctx.port)
+    {
+        return;
+    }
+
+    /* Stop sampling before the accumulators are cleared */
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)ENERGY_TIMER_ID);
+
+    gl_energy_acc = 0u;
+    gl_charge_acc = 0u;
+    gl_energy_samples = 0u;
+    gl_energy_due = 0u;
+    gl_energy_status_new = false;
+    gl_energy_status_age = ENERGY_STATUS_MAX_AGE;
+
+    if (evt == APP_EVT_CONNECT)
+    {
+        Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, (void *)ctx, (cy_timer_id_t)ENERGY_TIMER_ID,
+                ENERGY_SAMPLE_PERIOD, energy_timer_cb);
+    }
+}
+
+/*******************************************************************************
+* Function Name: energy_get_snapshot
+********************************************************************************
+* Summary:
+*  Returns the energy and charge delivered since attach. The accumulators are
+*  copied with interrupts disabled and converted outside the critical section.
+*
+* Parameters:
+*  snapshot - Filled with the energy, charge and sample count
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void energy_get_snapshot(stc_energy_snapshot_t *snapshot)
+{
+    uint64_t energy;
+    uint64_t charge;
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    energy = gl_energy_acc;
+    charge = gl_charge_acc;
+    snapshot->samples = gl_energy_samples;
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    snapshot->energy = energy_scale(energy, ENERGY_MWH_SCALE);
+    snapshot->charge = energy_scale(charge, ENERGY_MAH_SCALE);
+}
+
+#endif /* ENERGY_ENABLE */
+
+/* [] END OF FILE */
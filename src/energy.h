@@ -0,0 +1,100 @@
+/*******************************************************************************
+* File Name: energy.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  energy and charge accounting used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_ENERGY_H_
+#define SRC_ENERGY_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Q32 scale factors converting the accumulators to mWh and mAh. Each sample
+ * contributes mV * mA (uW) or mA for ENERGY_SAMPLE_PERIOD ms, so
+ * mWh = acc * ENERGY_SAMPLE_PERIOD / 3.6e9 and mAh = acc * ENERGY_SAMPLE_PERIOD / 3.6e6.
+ * The division is folded into the constants so that the conversion only takes
+ * a multiply and a shift at run time.
+ */
+#define ENERGY_MWH_SCALE                        ((((uint64_t)ENERGY_SAMPLE_PERIOD << 32u) + 1800000000u) / 3600000000u)
+#define ENERGY_MAH_SCALE                        ((((uint64_t)ENERGY_SAMPLE_PERIOD << 32u) + 1800000u) / 3600000u)
+
+/*
+ * Number of sample periods an output current reported in PPS_Status stays in
+ * use without a newer one. Older readings are replaced by the operating
+ * current of the contract.
+ */
+#define ENERGY_STATUS_MAX_AGE                   (2u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef stc_energy_snapshot_t
+ * @brief Energy and charge delivered since attach.
+ */
+typedef struct {
+    uint32_t energy;                     /**< Energy in mWh */
+    uint32_t charge;                     /**< Charge in mAh */
+    uint32_t samples;                    /**< Number of samples integrated */
+} stc_energy_snapshot_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if ENERGY_ENABLE
+void energy_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void energy_task(cy_stc_pdstack_context_t *context);
+void energy_get_snapshot(stc_energy_snapshot_t *snapshot);
+#else
+#define energy_task(context)                    ((void)0)
+#endif /* ENERGY_ENABLE */
+
+#endif /* SRC_ENERGY_H_ */
+
+/* [] END OF FILE */
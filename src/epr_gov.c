@@ -0,0 +1,329 @@
+/*******************************************************************************
+* File Name: epr_gov.c
+*
+* Description:
+*  This file contains the EPR AVS power governor. It enters EPR mode when both
+*  ports support it, requests a high voltage AVS operating point and falls back
+*  to the SPR PPS sweep when EPR is not available or is exited.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "epr_gov.h"
+#include "pps.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+
+#if EPR_GOV_BUILD
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* AVS voltage step in mV */
+#define EPR_GOV_AVS_STEP                        (100u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Governor status */
+static stc_epr_gov_stat_t gl_epr_gov;
+
+/* Set when a new explicit contract has been established */
+static volatile bool gl_contract_done;
+
+/* Set when the source rejected a request */
+static volatile bool gl_contract_rejected;
+
+/* USB PD context */
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: epr_gov_evt_handler
+********************************************************************************
+* Summary:
+*  Tracks contract completion and rejection, and resets the governor on detach
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void epr_gov_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    if (ctx->port != gl_PdStackPort0Ctx.port)
+    {
+        return;
+    }
+
+    if (evt == APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE)
+    {
+        if (app_evt_contract_ok(data))
+        {
+            gl_contract_done = true;
+        }
+        else
+        {
+            gl_contract_rejected = true;
+        }
+    }
+    else if (evt == APP_EVT_DISCONNECT)
+    {
+        gl_epr_gov.state = EPR_GOV_IDLE;
+        gl_contract_done = false;
+        gl_contract_rejected = false;
+    }
+    else
+    {
+        /* A hard reset exits EPR mode; the task falls back on !eprActive */
+    }
+}
+
+/*******************************************************************************
+* Function Name: src_epr_capable
+********************************************************************************
+* Summary:
+*  Checks whether both the source and the sink support EPR mode
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  true if EPR mode can be entered
+*
+*******************************************************************************/
+static bool src_epr_capable(cy_stc_pdstack_context_t *context)
+{
+    const cy_stc_pdstack_pd_packet_t *srcCap = context->dpmStat.srcCapP;
+
+    return ((srcCap != NULL) && (srcCap->len != 0u) &&
+            (context->dpmConfig.specRevSopLive >= CY_PD_REV3) &&
+            (srcCap->dat[0].fixed_src.eprModeCapable != 0u) &&
+            (context->dpmExtStat.epr.snkEnable != 0u));
+}
+
+/*******************************************************************************
+* Function Name: avs_contract_active
+********************************************************************************
+* Summary:
+*  Checks whether the current contract is with an EPR AVS APDO
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  true if the selected source PDO is an EPR AVS APDO
+*
+*******************************************************************************/
+static bool avs_contract_active(cy_stc_pdstack_context_t *context)
+{
+    return ((context->dpmStat.srcSelPdo.epr_avs_src.supplyType == CY_PDSTACK_PDO_AUGMENTED) &&
+            (context->dpmStat.srcSelPdo.epr_avs_src.apdoType == CY_PDSTACK_APDO_AVS));
+}
+
+/*******************************************************************************
+* Function Name: fall_back
+********************************************************************************
+* Summary:
+*  Gives control back to the SPR PPS sweep until the next attach
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void fall_back(void)
+{
+    gl_epr_gov.state = EPR_GOV_FALLBACK;
+    gl_epr_gov.fallbackCnt++;
+}
+
+/*******************************************************************************
+* Function Name: epr_gov_task
+********************************************************************************
+* Summary:
+*  Runs the governor state machine. Must be called from the main loop.
+*  The PD stack sends the EPR_KeepAlive messages while EPR mode is active; the
+*  governor falls back to SPR PPS when EPR mode is exited for any reason.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void epr_gov_task(cy_stc_pdstack_context_t *context)
+{
+    bool contract_done = gl_contract_done;
+    bool contract_rejected = gl_contract_rejected;
+
+    gl_contract_done = false;
+    gl_contract_rejected = false;
+
+    switch (gl_epr_gov.state)
+    {
+        case EPR_GOV_IDLE:
+            if (contract_done && !context->dpmExtStat.eprActive)
+            {
+                if (!src_epr_capable(context))
+                {
+                    fall_back();
+                }
+                else if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SNK_EPR_MODE_ENTRY,
+                            NULL, false, NULL) == CY_PDSTACK_STAT_SUCCESS)
+                {
+                    gl_epr_gov.entryReqTs = timestamp_get_ticks();
+                    gl_epr_gov.entryLatency = 0u;
+                    gl_epr_gov.state = EPR_GOV_ENTRY_PENDING;
+                }
+                else
+                {
+                    /* Retry after the next contract */
+                }
+            }
+            break;
+
+        case EPR_GOV_ENTRY_PENDING:
+            if (context->dpmExtStat.eprActive)
+            {
+                gl_epr_gov.entryLatency = timestamp_get_ticks() - gl_epr_gov.entryReqTs;
+
+                /* AVS voltages are requested in 100mV steps */
+                gl_epr_gov.avsVolt = (uint16_t)((EPR_GOV_TARGET_VOLT / EPR_GOV_AVS_STEP) * EPR_GOV_AVS_STEP);
+                gl_epr_gov.avsCur = EPR_GOV_TARGET_CUR;
+                if (pps_request_contract(EPR_ADJUSTABLE_VOLTAGE_SUPPLY, gl_epr_gov.avsVolt, gl_epr_gov.avsCur) ==
+                        CY_PDSTACK_STAT_SUCCESS)
+                {
+                    gl_epr_gov.avsReqTs = timestamp_get_ticks();
+                    gl_epr_gov.state = EPR_GOV_AVS_REQUESTED;
+                }
+                else
+                {
+                    /* No AVS APDO can supply the target operating point */
+                    fall_back();
+                }
+            }
+            else if ((timestamp_get_ticks() - gl_epr_gov.entryReqTs) >= (EPR_GOV_ENTRY_TIMEOUT * TIMESTAMP_TICKS_PER_MS))
+            {
+                fall_back();
+            }
+            else
+            {
+                /* Wait for EPR mode entry */
+            }
+            break;
+
+        case EPR_GOV_AVS_REQUESTED:
+            if (contract_done && context->dpmExtStat.eprActive && avs_contract_active(context))
+            {
+                gl_epr_gov.state = EPR_GOV_AVS_ACTIVE;
+            }
+            else if (contract_rejected || !context->dpmExtStat.eprActive ||
+                    ((timestamp_get_ticks() - gl_epr_gov.avsReqTs) >= (EPR_GOV_AVS_TIMEOUT * TIMESTAMP_TICKS_PER_MS)))
+            {
+                /* Rejected, answered with Wait or EPR mode exited */
+                fall_back();
+            }
+            else
+            {
+                /* Wait for the source to accept the AVS request */
+            }
+            break;
+
+        case EPR_GOV_AVS_ACTIVE:
+            if (!context->dpmExtStat.eprActive)
+            {
+                fall_back();
+            }
+            break;
+
+        default:
+            /* Stay in fallback until detach */
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: epr_gov_is_active
+********************************************************************************
+* Summary:
+*  Checks whether the governor controls the contract
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if EPR mode entry or the AVS request is in progress, or an AVS contract
+*  is in use
+*
+*******************************************************************************/
+bool epr_gov_is_active(void)
+{
+    return ((gl_epr_gov.state == EPR_GOV_ENTRY_PENDING) || (gl_epr_gov.state == EPR_GOV_AVS_REQUESTED) ||
+            (gl_epr_gov.state == EPR_GOV_AVS_ACTIVE));
+}
+
+/*******************************************************************************
+* Function Name: epr_gov_get_stat
+********************************************************************************
+* Summary:
+*  Returns the governor status, including the EPR mode entry latency
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_epr_gov_stat_t - Governor status
+*
+*******************************************************************************/
+const stc_epr_gov_stat_t *epr_gov_get_stat(void)
+{
+    return &gl_epr_gov;
+}
+
+#endif /* EPR_GOV_BUILD */
+
+/* [] END OF FILE */
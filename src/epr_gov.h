@@ -0,0 +1,107 @@
+/*******************************************************************************
+* File Name: epr_gov.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  EPR AVS power governor used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_EPR_GOV_H_
+#define SRC_EPR_GOV_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * The governor is only built when the PD stack supports EPR AVS.
+ */
+#define EPR_GOV_BUILD                           (EPR_GOV_ENABLE && CY_PD_EPR_ENABLE && CY_PD_EPR_AVS_ENABLE)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_epr_gov_state_t
+ * @brief EPR governor states.
+ */
+typedef enum {
+    EPR_GOV_IDLE                     = 0, /**< Waiting for an SPR contract */
+    EPR_GOV_ENTRY_PENDING,                /**< EPR mode entry requested */
+    EPR_GOV_AVS_REQUESTED,                /**< EPR AVS request sent, waiting for the source */
+    EPR_GOV_AVS_ACTIVE,                   /**< EPR AVS contract in use */
+    EPR_GOV_FALLBACK,                     /**< EPR not available, SPR PPS in use until detach */
+} en_epr_gov_state_t;
+
+/**
+ * @typedef stc_epr_gov_stat_t
+ * @brief EPR governor status.
+ */
+typedef struct {
+    en_epr_gov_state_t state;            /**< Current state */
+    uint32_t entryReqTs;                 /**< Timestamp of the EPR mode entry request */
+    uint32_t entryLatency;               /**< Ticks from entry request to EPR mode active, 0 if not entered */
+    uint32_t avsReqTs;                   /**< Timestamp of the AVS request */
+    uint16_t avsVolt;                    /**< Requested AVS voltage in mV */
+    uint16_t avsCur;                     /**< Requested AVS current in mA */
+    uint8_t fallbackCnt;                 /**< Number of fallbacks to SPR PPS */
+} stc_epr_gov_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if EPR_GOV_BUILD
+void epr_gov_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void epr_gov_task(cy_stc_pdstack_context_t *context);
+bool epr_gov_is_active(void);
+const stc_epr_gov_stat_t *epr_gov_get_stat(void);
+#else
+#define epr_gov_task(context)                   ((void)0)
+#define epr_gov_is_active()                     (false)
+#endif /* EPR_GOV_BUILD */
+
+#endif /* SRC_EPR_GOV_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,162 @@
+/*******************************************************************************
+* File Name: fault_timeline.c
+*
+* Description:
+*  This file contains the fault response timeline. The time at which a VBUS
+*  fault is detected, the sink path is turned off, the port recovers and the
+*  PPS operating point is restored is recorded for the last fault.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "fault_timeline.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Timeline of the last fault */
+static stc_fault_timeline_t gl_fault_tl;
+
+/*******************************************************************************
+* Function Name: fault_evt_handler
+********************************************************************************
+* Summary:
+*  Starts a new timeline on a VBUS fault and records the recovery and the
+*  first explicit contract after it
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fault_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    switch (evt)
+    {
+        case APP_EVT_VBUS_OVP_FAULT:
+        case APP_EVT_VBUS_UVP_FAULT:
+        case APP_EVT_VBUS_OCP_FAULT:
+        case APP_EVT_VBUS_SCP_FAULT:
+            gl_fault_tl.faultCnt++;
+            gl_fault_tl.evt = (uint8_t)evt;
+            gl_fault_tl.port = ctx->port;
+            (void)memset(gl_fault_tl.ts, 0, sizeof(gl_fault_tl.ts));
+            fault_timeline_mark(FAULT_PHASE_DETECT);
+            break;
+
+        case APP_EVT_HARD_RESET_RCVD:
+        case APP_EVT_HARD_RESET_SENT:
+        case APP_EVT_TYPE_C_ERROR_RECOVERY:
+            fault_timeline_mark(FAULT_PHASE_RECOVERY);
+            break;
+
+        case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+            if (app_evt_contract_ok(data))
+            {
+                fault_timeline_mark(FAULT_PHASE_CONTRACT);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: fault_timeline_mark
+********************************************************************************
+* Summary:
+*  Records the time a phase of the fault response was reached. Phases are
+*  only recorded once per fault and only while a fault is being handled;
+*  calls at any other time are ignored.
+*
+* Parameters:
+*  phase - Phase reached
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void fault_timeline_mark(en_fault_phase_t phase)
+{
+    uint32_t ts;
+
+    if ((phase != FAULT_PHASE_DETECT) &&
+        ((gl_fault_tl.ts[FAULT_PHASE_DETECT] == 0u) || (gl_fault_tl.ts[FAULT_PHASE_RESTORED] != 0u) ||
+         (gl_fault_tl.ts[phase] != 0u)))
+    {
+        return;
+    }
+
+    /* The contract and restore phases only count once the port has recovered */
+    if ((phase > FAULT_PHASE_RECOVERY) && (gl_fault_tl.ts[(uint32_t)phase - 1u] == 0u))
+    {
+        return;
+    }
+
+    ts = timestamp_get_ticks();
+    gl_fault_tl.ts[phase] = (ts != 0u) ? ts : 1u;
+}
+
+/*******************************************************************************
+* Function Name: fault_timeline_get
+********************************************************************************
+* Summary:
+*  Returns the timeline of the last fault
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_fault_timeline_t - Fault timeline
+*
+*******************************************************************************/
+const stc_fault_timeline_t *fault_timeline_get(void)
+{
+    return &gl_fault_tl;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/*******************************************************************************
+* File Name: fault_timeline.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  fault response timeline used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_FAULT_TIMELINE_H_
+#define SRC_FAULT_TIMELINE_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_fault_phase_t
+ * @brief Phases of the response to a VBUS fault.
+ */
+typedef enum {
+    FAULT_PHASE_DETECT               = 0, /**< Fault reported by the fault handlers */
+    FAULT_PHASE_FET_OFF,                  /**< Sink path disabled */
+    FAULT_PHASE_RECOVERY,                 /**< Hard reset or Type-C error recovery */
+    FAULT_PHASE_CONTRACT,                 /**< First explicit contract after the recovery */
+    FAULT_PHASE_RESTORED,                 /**< PPS operating point restored */
+    FAULT_PHASE_COUNT                     /**< Number of phases */
+} en_fault_phase_t;
+
+/**
+ * @typedef stc_fault_timeline_t
+ * @brief Timeline of the last fault. Each phase holds the timestamp at which
+ * it was reached, 0 if it has not been reached (yet).
+ */
+typedef struct {
+    uint32_t faultCnt;                   /**< Number of faults since boot */
+    uint8_t evt;                         /**< Application event that reported the last fault */
+    uint8_t port;                        /**< Port of the last fault */
+    uint32_t ts[FAULT_PHASE_COUNT];      /**< Timestamp of each phase */
+} stc_fault_timeline_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+void fault_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void fault_timeline_mark(en_fault_phase_t phase);
+const stc_fault_timeline_t *fault_timeline_get(void);
+
+#endif /* SRC_FAULT_TIMELINE_H_ */
+
+/* [] END OF FILE */
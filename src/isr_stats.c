@@ -0,0 +1,199 @@
+/*******************************************************************************
+* File Name: isr_stats.c
+*
+* Description:
+*  This file contains the interrupt latency and duration statistics. Handler
+*  durations are measured with the SysTick cycle counter. The WDT entry latency
+*  is derived from the WDT match value. The USBPD entry latency is bounded by
+*  the time the interrupt was seen pending behind another instrumented handler.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "isr_stats.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cybsp.h"
+
+#if ISR_STATS_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Interrupt line of each instrumented handler */
+static const IRQn_Type gl_isr_irqn[ISR_ID_COUNT] =
+{
+    (IRQn_Type)srss_interrupt_wdt_IRQn,
+    (IRQn_Type)mtb_usbpd_port0_IRQ,
+    (IRQn_Type)mtb_usbpd_port0_DS_IRQ,
+#if PMG1_PD_DUALPORT_ENABLE
+    (IRQn_Type)mtb_usbpd_port1_IRQ,
+    (IRQn_Type)mtb_usbpd_port1_DS_IRQ,
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+};
+
+/* Handler statistics */
+static stc_isr_stat_t gl_isr_stat[ISR_ID_COUNT];
+
+/* Cycle count from which an interrupt has been pending, 0 if not seen pending */
+static uint32_t gl_isr_pend_start[ISR_ID_COUNT];
+
+/*******************************************************************************
+* Function Name: isr_stats_enter
+********************************************************************************
+* Summary:
+*  Records the entry into an interrupt handler
+*
+* Parameters:
+*  id - Handler
+*
+* Return:
+*  uint32_t - Entry cycle count, to be passed to isr_stats_exit
+*
+*******************************************************************************/
+uint32_t isr_stats_enter(en_isr_id_t id)
+{
+    uint32_t now = timestamp_get_cycles();
+    uint32_t latency = 0u;
+
+    if (id == ISR_ID_WDT)
+    {
+        /* WDT ticks elapsed since the match, converted to CPU cycles */
+        latency = (uint16_t)(Cy_WDT_GetCount() - Cy_WDT_GetMatch()) *
+            (Cy_SysClk_ClkSysGetFrequency() / (TIMESTAMP_TICKS_PER_MS * 1000u));
+    }
+    else if (gl_isr_pend_start[id] != 0u)
+    {
+        latency = TIMESTAMP_CYCLES_DELTA(gl_isr_pend_start[id], now);
+        gl_isr_pend_start[id] = 0u;
+    }
+
+    if (latency > gl_isr_stat[id].maxLatency)
+    {
+        gl_isr_stat[id].maxLatency = latency;
+    }
+
+    return now;
+}
+
+/*******************************************************************************
+* Function Name: isr_stats_exit
+********************************************************************************
+* Summary:
+*  Records the exit from an interrupt handler. Other instrumented interrupts
+*  found pending are charged with the time since the start of this handler,
+*  which is an upper bound of the time they were held off by it.
+*
+* Parameters:
+*  id - Handler
+*  start - Value returned by isr_stats_enter
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void isr_stats_exit(en_isr_id_t id, uint32_t start)
+{
+    uint32_t duration = TIMESTAMP_CYCLES_DELTA(start, timestamp_get_cycles());
+    uint8_t i;
+
+    gl_isr_stat[id].count++;
+    gl_isr_stat[id].totalDuration += duration;
+    if (duration > gl_isr_stat[id].maxDuration)
+    {
+        gl_isr_stat[id].maxDuration = duration;
+    }
+
+    for (i = 0u; i < (uint8_t)ISR_ID_COUNT; i++)
+    {
+        if ((i != (uint8_t)id) && (gl_isr_pend_start[i] == 0u) && (NVIC_GetPendingIRQ(gl_isr_irqn[i]) != 0u))
+        {
+            gl_isr_pend_start[i] = (start != 0u) ? start : 1u;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: isr_stats_get
+********************************************************************************
+* Summary:
+*  Copies the statistics of all handlers
+*
+* Parameters:
+*  stats - Array of ISR_ID_COUNT entries
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void isr_stats_get(stc_isr_stat_t *stats)
+{
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    (void)memcpy(stats, gl_isr_stat, sizeof(gl_isr_stat));
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: isr_stats_clear
+********************************************************************************
+* Summary:
+*  Clears the statistics of all handlers
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void isr_stats_clear(void)
+{
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    (void)memset(gl_isr_stat, 0, sizeof(gl_isr_stat));
+    (void)memset(gl_isr_pend_start, 0, sizeof(gl_isr_pend_start));
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+#endif /* ISR_STATS_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,110 @@
+/*******************************************************************************
+* File Name: isr_stats.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  interrupt latency and duration statistics used in the USB PD Sink PPS Code
+*  example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_ISR_STATS_H_
+#define SRC_ISR_STATS_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Instrumentation hooks placed at the very start and end of an interrupt
+ * handler. They compile to nothing when ISR_STATS_ENABLE is 0.
+ */
+#if ISR_STATS_ENABLE
+#define ISR_STATS_ENTER(id)                     uint32_t isr_stats_start = isr_stats_enter(id)
+#define ISR_STATS_EXIT(id)                      isr_stats_exit((id), isr_stats_start)
+#else
+#define ISR_STATS_ENTER(id)
+#define ISR_STATS_EXIT(id)
+#endif /* ISR_STATS_ENABLE */
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_isr_id_t
+ * @brief Instrumented interrupt handlers.
+ */
+typedef enum {
+    ISR_ID_WDT                       = 0, /**< WDT (soft timer) interrupt */
+    ISR_ID_USBPD0_INTR0,                  /**< USBPD port 0 interrupt 0 */
+    ISR_ID_USBPD0_INTR1,                  /**< USBPD port 0 interrupt 1 (deep sleep) */
+#if PMG1_PD_DUALPORT_ENABLE
+    ISR_ID_USBPD1_INTR0,                  /**< USBPD port 1 interrupt 0 */
+    ISR_ID_USBPD1_INTR1,                  /**< USBPD port 1 interrupt 1 (deep sleep) */
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+    ISR_ID_COUNT                          /**< Number of instrumented handlers */
+} en_isr_id_t;
+
+/**
+ * @typedef stc_isr_stat_t
+ * @brief Statistics of one interrupt handler. All times are in CPU cycles.
+ */
+typedef struct {
+    uint32_t count;                      /**< Number of invocations */
+    uint32_t maxLatency;                 /**< Longest entry latency observed */
+    uint32_t maxDuration;                /**< Longest handler duration */
+    uint32_t totalDuration;              /**< Sum of all handler durations, wraps */
+} stc_isr_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if ISR_STATS_ENABLE
+uint32_t isr_stats_enter(en_isr_id_t id);
+void isr_stats_exit(en_isr_id_t id, uint32_t start);
+void isr_stats_get(stc_isr_stat_t *stats);
+void isr_stats_clear(void);
+#endif /* ISR_STATS_ENABLE */
+
+#endif /* SRC_ISR_STATS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,417 @@
+/*******************************************************************************
+* File Name: pd_capture.c
+*
+* Description:
+*  This file contains the capture of source capabilities and contract requests
+*  evaluated by the PPS module.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "pd_capture.h"
+#include "app_evt.h"
+#include "cy_pdl.h"
+
+#if PD_CAPTURE_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Capture buffer */
+static stc_pd_capture_t gl_pd_capture =
+{
+    .magic = PD_CAPTURE_MAGIC,
+    .len = 0u,
+    .dropped = 0u
+};
+
+/*
+ * Last captured source and sink capabilities records. Each evaluation records
+ * the capabilities it used; a record identical to the previous one of the
+ * same type is implied instead of repeated.
+ */
+static uint8_t gl_last_src_rec[2u + (PD_CAPTURE_MAX_PDO * 4u)];
+static uint8_t gl_last_src_len;
+static uint8_t gl_last_snk_rec[3u + (PD_CAPTURE_MAX_PDO * 4u)];
+static uint8_t gl_last_snk_len;
+
+/*
+ * Last request record and the capture length right after it or after the
+ * repeat record that follows it. A request identical to the last one with
+ * no other record in between only increments the repeat count, so that the
+ * periodic PPS keepalive does not fill the buffer.
+ */
+static uint8_t gl_last_req_rec[PD_CAPTURE_REQ_SIZE];
+static uint16_t gl_last_req_end;
+static uint16_t gl_repeat_pos;
+
+/*******************************************************************************
+* Function Name: capture_put
+********************************************************************************
+* Summary:
+*  Appends one record to the capture buffer
+*
+* Parameters:
+*  type - Record type
+*  payload - Record payload
+*  len - Payload length in bytes
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void capture_put(en_pd_capture_rec_t type, const uint8_t *payload, uint8_t len)
+{
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    if (((uint32_t)gl_pd_capture.len + 2u + len) > PD_CAPTURE_BUF_SIZE)
+    {
+        gl_pd_capture.dropped++;
+    }
+    else
+    {
+        gl_pd_capture.buf[gl_pd_capture.len++] = (uint8_t)type;
+        gl_pd_capture.buf[gl_pd_capture.len++] = len;
+        if (len != 0u)
+        {
+            memcpy(&gl_pd_capture.buf[gl_pd_capture.len], payload, len);
+            gl_pd_capture.len += len;
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: capture_put_pdos
+********************************************************************************
+* Summary:
+*  Serializes PDOs in little endian byte order
+*
+* Parameters:
+*  dst - Destination buffer
+*  pdo - PDOs
+*  count - Number of PDOs
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void capture_put_pdos(uint8_t *dst, const cy_pd_pd_do_t *pdo, uint8_t count)
+{
+    uint8_t idx;
+
+    for (idx = 0u; idx < count; idx++)
+    {
+        dst[(idx * 4u)] = (uint8_t)pdo[idx].val;
+        dst[(idx * 4u) + 1u] = (uint8_t)(pdo[idx].val >> 8u);
+        dst[(idx * 4u) + 2u] = (uint8_t)(pdo[idx].val >> 16u);
+        dst[(idx * 4u) + 3u] = (uint8_t)(pdo[idx].val >> 24u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: capture_put_changed
+********************************************************************************
+* Summary:
+*  Appends a capabilities record unless it is identical to the previous record
+*  of the same type
+*
+* Parameters:
+*  type - Record type
+*  payload - Record payload
+*  len - Payload length in bytes
+*  last - Previous payload of this type
+*  last_len - Length of the previous payload
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void capture_put_changed(en_pd_capture_rec_t type, const uint8_t *payload, uint8_t len,
+                                uint8_t *last, uint8_t *last_len)
+{
+    if ((len == *last_len) && (memcmp(last, payload, len) == 0))
+    {
+        return;
+    }
+
+    memcpy(last, payload, len);
+    *last_len = len;
+    capture_put(type, payload, len);
+}
+
+/*******************************************************************************
+* Function Name: capture_evt_handler
+********************************************************************************
+* Summary:
+*  Marks session boundaries in the capture on attach and detach
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void capture_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)ctx;
+    (void)data;
+
+    gl_last_src_len = 0u;
+    gl_last_snk_len = 0u;
+    gl_last_req_end = 0u;
+    capture_put((evt == APP_EVT_CONNECT) ? PD_CAPTURE_REC_ATTACH : PD_CAPTURE_REC_DETACH, NULL, 0u);
+}
+
+/*******************************************************************************
+* Function Name: pd_capture_src_cap
+********************************************************************************
+* Summary:
+*  Records the source capabilities of a contract evaluation
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  srcCap - Source capabilities message
+*  count - Number of PDOs used from the message
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_capture_src_cap(const cy_stc_pdstack_context_t *ctx, const cy_stc_pdstack_pd_packet_t *srcCap,
+                        uint8_t count)
+{
+    uint8_t payload[sizeof(gl_last_src_rec)];
+
+    if (count > PD_CAPTURE_MAX_PDO)
+    {
+        count = PD_CAPTURE_MAX_PDO;
+    }
+
+    payload[0] = 0u;
+#if CY_PD_EPR_ENABLE
+    if (ctx->dpmExtStat.eprActive)
+    {
+        payload[0] |= PD_CAPTURE_SRC_EPR_ACTIVE;
+    }
+#endif /* CY_PD_EPR_ENABLE */
+    if (srcCap->hdr.hdr.extd)
+    {
+        payload[0] |= PD_CAPTURE_SRC_EXTD;
+    }
+    payload[1] = (uint8_t)ctx->dpmConfig.specRevSopLive;
+    capture_put_pdos(&payload[2], srcCap->dat, count);
+
+    capture_put_changed(PD_CAPTURE_REC_SRC_CAP, payload, (uint8_t)(2u + (count * 4u)),
+            gl_last_src_rec, &gl_last_src_len);
+}
+
+/*******************************************************************************
+* Function Name: pd_capture_snk_cap
+********************************************************************************
+* Summary:
+*  Records the sink capabilities and the request flags of a contract
+*  evaluation
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_capture_snk_cap(const cy_stc_pdstack_context_t *ctx)
+{
+    uint8_t payload[sizeof(gl_last_snk_rec)];
+    uint8_t spr_cnt = ctx->dpmStat.curSnkPdocount;
+    uint8_t epr_cnt = 0u;
+
+    if (spr_cnt > CY_PD_MAX_NO_OF_PDO)
+    {
+        spr_cnt = CY_PD_MAX_NO_OF_PDO;
+    }
+
+    payload[0] = 0u;
+    if (ctx->dpmStat.snkUsbCommEn)
+    {
+        payload[0] |= PD_CAPTURE_SNK_USB_COMM;
+    }
+    if (ctx->dpmStat.snkUsbSuspEn)
+    {
+        payload[0] |= PD_CAPTURE_SNK_NO_USB_SUSP;
+    }
+    capture_put_pdos(&payload[3], ctx->dpmStat.curSnkPdo, spr_cnt);
+
+#if CY_PD_EPR_ENABLE
+    if (ctx->dpmExtStat.epr.snkEnable)
+    {
+        payload[0] |= PD_CAPTURE_SNK_EPR_CAPABLE;
+    }
+    if (ctx->dpmExtStat.eprActive)
+    {
+        payload[0] |= PD_CAPTURE_SNK_EPR_ACTIVE;
+        epr_cnt = ctx->dpmExtStat.curEprSnkPdoCount;
+        if (epr_cnt > (PD_CAPTURE_MAX_PDO - CY_PD_MAX_NO_OF_PDO))
+        {
+            epr_cnt = PD_CAPTURE_MAX_PDO - CY_PD_MAX_NO_OF_PDO;
+        }
+        capture_put_pdos(&payload[3u + (spr_cnt * 4u)], ctx->dpmExtStat.curEprSnkPdo, epr_cnt);
+    }
+#endif /* CY_PD_EPR_ENABLE */
+
+    payload[1] = spr_cnt;
+    payload[2] = epr_cnt;
+
+    capture_put_changed(PD_CAPTURE_REC_SNK_CAP, payload, (uint8_t)(3u + ((spr_cnt + epr_cnt) * 4u)),
+            gl_last_snk_rec, &gl_last_snk_len);
+}
+
+/*******************************************************************************
+* Function Name: pd_capture_request
+********************************************************************************
+* Summary:
+*  Records a contract request and its outcome. A request identical to the
+*  previous record is counted in a repeat record instead.
+*
+* Parameters:
+*  volt - Requested voltage in mV
+*  cur - Requested current in mA, before the cable and PDP limits
+*  cable_cur - Cable current limit in mA
+*  pdp_cur - Source PDP current limit in mA at the requested voltage
+*  supply_type - Requested supply type
+*  obj_pos - Selected object position, 0 if no PDO matched
+*  status - Status returned by the DPM, failure if nothing was sent
+*  rdo - Request data object sent, 0 if nothing was sent
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_capture_request(uint16_t volt, uint16_t cur, uint16_t cable_cur, uint16_t pdp_cur, uint8_t supply_type,
+                        uint8_t obj_pos, cy_en_pdstack_status_t status, uint32_t rdo)
+{
+    uint8_t payload[PD_CAPTURE_REQ_SIZE];
+    uint8_t count[2] = { 1u, 0u };
+    uint32_t intr_state;
+    uint16_t repeat;
+    uint16_t len;
+
+    payload[0] = (uint8_t)volt;
+    payload[1] = (uint8_t)(volt >> 8u);
+    payload[2] = (uint8_t)cur;
+    payload[3] = (uint8_t)(cur >> 8u);
+    payload[4] = (uint8_t)cable_cur;
+    payload[5] = (uint8_t)(cable_cur >> 8u);
+    payload[6] = (uint8_t)pdp_cur;
+    payload[7] = (uint8_t)(pdp_cur >> 8u);
+    payload[8] = supply_type;
+    payload[9] = obj_pos;
+    payload[10] = (uint8_t)status;
+    payload[11] = (uint8_t)rdo;
+    payload[12] = (uint8_t)(rdo >> 8u);
+    payload[13] = (uint8_t)(rdo >> 16u);
+    payload[14] = (uint8_t)(rdo >> 24u);
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    if ((gl_last_req_end != 0u) && (gl_last_req_end == gl_pd_capture.len) &&
+            (memcmp(gl_last_req_rec, payload, sizeof(payload)) == 0))
+    {
+        if (gl_repeat_pos == 0u)
+        {
+            /* First repeat of this request */
+            capture_put(PD_CAPTURE_REC_REPEAT, count, sizeof(count));
+            if (gl_pd_capture.len != gl_last_req_end)
+            {
+                gl_last_req_end = gl_pd_capture.len;
+                gl_repeat_pos = (uint16_t)(gl_last_req_end - sizeof(count));
+            }
+            Cy_SysLib_ExitCriticalSection(intr_state);
+            return;
+        }
+
+        repeat = (uint16_t)(gl_pd_capture.buf[gl_repeat_pos] | ((uint16_t)gl_pd_capture.buf[gl_repeat_pos + 1u] << 8u));
+        if (repeat != 0xFFFFu)
+        {
+            repeat++;
+            gl_pd_capture.buf[gl_repeat_pos] = (uint8_t)repeat;
+            gl_pd_capture.buf[gl_repeat_pos + 1u] = (uint8_t)(repeat >> 8u);
+            Cy_SysLib_ExitCriticalSection(intr_state);
+            return;
+        }
+
+        /* Repeat count saturated, the request is recorded again */
+    }
+
+    len = gl_pd_capture.len;
+    capture_put(PD_CAPTURE_REC_REQUEST, payload, sizeof(payload));
+    memcpy(gl_last_req_rec, payload, sizeof(payload));
+    gl_last_req_end = (gl_pd_capture.len != len) ? gl_pd_capture.len : 0u;
+    gl_repeat_pos = 0u;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: pd_capture_get
+********************************************************************************
+* Summary:
+*  Returns the capture buffer for export
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_pd_capture_t - Capture buffer
+*
+*******************************************************************************/
+const stc_pd_capture_t *pd_capture_get(void)
+{
+    return &gl_pd_capture;
+}
+
+#endif /* PD_CAPTURE_ENABLE */
+
+/* [] END OF FILE */
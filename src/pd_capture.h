@@ -0,0 +1,137 @@
+/*******************************************************************************
+* File Name: pd_capture.h
+*
+* Description:
+*  This file contains the capture format and function prototypes used to record
+*  source capabilities and contract requests in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_PD_CAPTURE_H_
+#define SRC_PD_CAPTURE_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Marker placed at the start of the capture buffer ("CAP3" in little endian).
+ */
+#define PD_CAPTURE_MAGIC                        (0x33504143u)
+
+/*
+ * Maximum number of PDOs in a capabilities record (7 SPR + 6 EPR).
+ */
+#define PD_CAPTURE_MAX_PDO                      (13u)
+
+/*
+ * Payload size of a request record.
+ */
+#define PD_CAPTURE_REQ_SIZE                     (15u)
+
+/*
+ * Source capabilities record flags.
+ */
+#define PD_CAPTURE_SRC_EPR_ACTIVE               (0x01u)     /* EPR mode active */
+#define PD_CAPTURE_SRC_EXTD                     (0x02u)     /* Received as an extended message */
+
+/*
+ * Sink capabilities record flags.
+ */
+#define PD_CAPTURE_SNK_EPR_ACTIVE               (0x01u)     /* EPR mode active */
+#define PD_CAPTURE_SNK_USB_COMM                 (0x02u)     /* USB communication capable */
+#define PD_CAPTURE_SNK_NO_USB_SUSP              (0x04u)     /* No USB suspend */
+#define PD_CAPTURE_SNK_EPR_CAPABLE              (0x08u)     /* EPR mode capable */
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_pd_capture_rec_t
+ * @brief Capture record types. Each record starts with a one byte type and
+ * a one byte payload length, followed by the little endian payload.
+ */
+typedef enum {
+    PD_CAPTURE_REC_ATTACH            = 0x01, /**< Session start. No payload */
+    PD_CAPTURE_REC_DETACH            = 0x02, /**< Session end. No payload */
+    PD_CAPTURE_REC_SRC_CAP           = 0x03, /**< Source caps. flags (1), spec rev (1), PDOs (4 each) */
+    PD_CAPTURE_REC_REQUEST           = 0x04, /**< Request. volt mV (2), cur mA (2), cable limit mA (2),
+                                                  PDP limit mA (2), supply type (1), object position (1),
+                                                  DPM status (1), RDO (4) */
+    PD_CAPTURE_REC_SNK_CAP           = 0x05, /**< Sink caps. flags (1), SPR count (1), EPR count (1),
+                                                  PDOs (4 each) */
+    PD_CAPTURE_REC_REPEAT            = 0x06, /**< Preceding request repeated with an identical record.
+                                                  count (2) */
+} en_pd_capture_rec_t;
+
+/**
+ * @typedef stc_pd_capture_t
+ * @brief Capture buffer. Records are appended until the buffer is full.
+ */
+typedef struct {
+    uint32_t magic;                          /**< PD_CAPTURE_MAGIC */
+    uint16_t len;                            /**< Number of bytes used in buf */
+    uint16_t dropped;                        /**< Number of records dropped because the buffer was full */
+    uint8_t buf[PD_CAPTURE_BUF_SIZE];        /**< Record stream */
+} stc_pd_capture_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if PD_CAPTURE_ENABLE
+void capture_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void pd_capture_src_cap(const cy_stc_pdstack_context_t *ctx, const cy_stc_pdstack_pd_packet_t *srcCap,
+                        uint8_t count);
+void pd_capture_snk_cap(const cy_stc_pdstack_context_t *ctx);
+void pd_capture_request(uint16_t volt, uint16_t cur, uint16_t cable_cur, uint16_t pdp_cur, uint8_t supply_type,
+                        uint8_t obj_pos, cy_en_pdstack_status_t status, uint32_t rdo);
+const stc_pd_capture_t *pd_capture_get(void);
+#else
+#define pd_capture_src_cap(ctx, srcCap, count)                              ((void)0)
+#define pd_capture_snk_cap(ctx)                                             ((void)0)
+#define pd_capture_request(volt, cur, cable_cur, pdp_cur, supply_type, obj_pos, status, rdo) ((void)0)
+#endif /* PD_CAPTURE_ENABLE */
+
+#endif /* SRC_PD_CAPTURE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,343 @@
+/*******************************************************************************
+* File Name: pd_stats.c
+*
+* Description:
+*  This file contains the PD message and AMS statistics. The counters are
+*  updated from the PD event path and the request response callback, and read
+*  as a snapshot copied with interrupts disabled.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "pd_stats.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+
+#if PD_STATS_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Counters per port */
+static stc_pd_stats_t gl_pd_stats[NO_OF_TYPEC_PORTS];
+
+/* Time of the last Accept per port, 0 if no contract is pending */
+static uint32_t gl_pd_accept_ts[NO_OF_TYPEC_PORTS];
+
+/* RDO of the application Request waiting for its outcome per port, 0 if none */
+static uint32_t gl_pd_req_rdo[NO_OF_TYPEC_PORTS];
+
+/* RDO of the present contract per port, 0 if there is none */
+static uint32_t gl_pd_contract_rdo[NO_OF_TYPEC_PORTS];
+
+/*******************************************************************************
+* Function Name: pd_stats_contract_lost
+********************************************************************************
+* Summary:
+*  Forgets the present contract and the Request waiting for its outcome
+*
+* Parameters:
+*  port - Port index
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void pd_stats_contract_lost(uint8_t port)
+{
+    gl_pd_accept_ts[port] = 0u;
+    gl_pd_req_rdo[port] = 0u;
+    gl_pd_contract_rdo[port] = 0u;
+}
+
+/*******************************************************************************
+* Function Name: pd_stats_evt_handler
+********************************************************************************
+* Summary:
+*  Counts the Requests that end with a contract negotiation, resets and
+*  error recoveries. The negotiation outcome is reported for the Requests of
+*  the application and for the Requests the stack sends by itself in response
+*  to Source_Capabilities.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_stats_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    stc_pd_stats_t *stats = &gl_pd_stats[ctx->port];
+    uint32_t latency;
+
+    switch (evt)
+    {
+        case APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE:
+            stats->reqSent++;
+            if (app_evt_contract_ok(data))
+            {
+                stats->accept++;
+                if (gl_pd_accept_ts[ctx->port] != 0u)
+                {
+                    latency = timestamp_get_ticks() - gl_pd_accept_ts[ctx->port];
+                    stats->psRdy++;
+                    stats->psRdyLatency = latency;
+                    stats->psRdySumLatency += latency;
+                    if (latency > stats->psRdyMaxLatency)
+                    {
+                        stats->psRdyMaxLatency = latency;
+                    }
+                }
+                /* A Request of the stack is not queued by the application */
+                gl_pd_contract_rdo[ctx->port] = (gl_pd_req_rdo[ctx->port] != 0u) ?
+                        gl_pd_req_rdo[ctx->port] : ctx->dpmStat.snkRdo.val;
+            }
+            else
+            {
+                stats->reject++;
+            }
+            gl_pd_accept_ts[ctx->port] = 0u;
+            gl_pd_req_rdo[ctx->port] = 0u;
+            break;
+
+        case APP_EVT_SOFT_RESET_SENT:
+            stats->softResetSent++;
+            break;
+
+        case APP_EVT_HARD_RESET_SENT:
+            stats->hardResetSent++;
+            pd_stats_contract_lost(ctx->port);
+            break;
+
+        case APP_EVT_HARD_RESET_RCVD:
+            stats->hardResetRcvd++;
+            pd_stats_contract_lost(ctx->port);
+            break;
+
+        case APP_EVT_TYPE_C_ERROR_RECOVERY:
+            stats->errRecovery++;
+            pd_stats_contract_lost(ctx->port);
+            break;
+
+        case APP_EVT_DISCONNECT:
+            pd_stats_contract_lost(ctx->port);
+            break;
+
+        default:
+            /* Do Nothing */
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: pd_stats_init
+********************************************************************************
+* Summary:
+*  Starts the counting window
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_stats_init(void)
+{
+    uint8_t port;
+
+    for (port = 0u; port < NO_OF_TYPEC_PORTS; port++)
+    {
+        gl_pd_stats[port].startTs = timestamp_get_ticks();
+    }
+}
+
+/*******************************************************************************
+* Function Name: pd_stats_req_queued
+********************************************************************************
+* Summary:
+*  Records the RDO of a Request handed to the stack by the application. A
+*  Request that repeats the RDO of the present contract, such as the periodic
+*  PPS request, is counted as a keepalive. The Request itself is counted once
+*  its outcome is known.
+*
+* Parameters:
+*  context - PD Stack Context
+*  rdo - Request data object
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_stats_req_queued(const cy_stc_pdstack_context_t *context, uint32_t rdo)
+{
+    if (rdo == gl_pd_contract_rdo[context->port])
+    {
+        gl_pd_stats[context->port].ppsKeepalive++;
+    }
+    gl_pd_req_rdo[context->port] = rdo;
+}
+
+/*******************************************************************************
+* Function Name: pd_stats_req_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Request command of the application. Accepted
+*  and rejected Requests are counted by the contract negotiation event; this
+*  counts the Requests answered with Wait and the Requests that failed. The
+*  PD PHY retries a message without GoodCRC by itself, so only the requests
+*  that failed after all retries are visible.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_stats_req_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    stc_pd_stats_t *stats = &gl_pd_stats[ctx->port];
+
+    switch (resp)
+    {
+        case CY_PDSTACK_RES_RCVD:
+            if (pkt == NULL)
+            {
+                break;
+            }
+            if (pkt->msg == (uint8_t)CY_PD_CTRL_MSG_ACCEPT)
+            {
+                gl_pd_accept_ts[ctx->port] = timestamp_get_ticks();
+            }
+            else if (pkt->msg == (uint8_t)CY_PD_CTRL_MSG_WAIT)
+            {
+                stats->reqSent++;
+                stats->wait++;
+                gl_pd_req_rdo[ctx->port] = 0u;
+            }
+            else
+            {
+                /* Do Nothing */
+            }
+            break;
+
+        case CY_PDSTACK_CMD_FAILED:
+            stats->reqSent++;
+            stats->reqTxFail++;
+            gl_pd_req_rdo[ctx->port] = 0u;
+            break;
+
+        case CY_PDSTACK_RES_TIMEOUT:
+            stats->reqSent++;
+            stats->reqTimeout++;
+            gl_pd_req_rdo[ctx->port] = 0u;
+            break;
+
+        default:
+            /* Do Nothing */
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: pd_stats_get_snapshot
+********************************************************************************
+* Summary:
+*  Returns a consistent copy of the counters of a port. The copy is taken with
+*  interrupts disabled and the keepalive rate is computed outside the critical
+*  section.
+*
+* Parameters:
+*  port - Port index
+*  snapshot - Filled with the counters
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_stats_get_snapshot(uint8_t port, stc_pd_stats_t *snapshot)
+{
+    uint32_t intr_state;
+    uint32_t secs;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    *snapshot = gl_pd_stats[port];
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    secs = (timestamp_get_ticks() - snapshot->startTs) / (TIMESTAMP_TICKS_PER_MS * 1000u);
+    snapshot->ppsKeepalivePerHour = (secs != 0u) ?
+            (uint32_t)(((uint64_t)snapshot->ppsKeepalive * 3600u) / secs) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: pd_stats_clear
+********************************************************************************
+* Summary:
+*  Clears the counters of a port and restarts the counting window
+*
+* Parameters:
+*  port - Port index
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pd_stats_clear(uint8_t port)
+{
+    uint32_t intr_state;
+    stc_pd_stats_t *stats = &gl_pd_stats[port];
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    (void)memset(stats, 0, sizeof(*stats));
+    stats->startTs = timestamp_get_ticks();
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+#endif /* PD_STATS_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,99 @@
+/*******************************************************************************
+* File Name: pd_stats.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  PD message and AMS statistics used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_PD_STATS_H_
+#define SRC_PD_STATS_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef stc_pd_stats_t
+ * @brief PD message and AMS counters of a port. Latencies are in timestamp ticks.
+ */
+typedef struct {
+    uint32_t reqSent;                    /**< Requests sent, including the Requests of the stack */
+    uint32_t accept;                     /**< Requests accepted */
+    uint32_t reject;                     /**< Requests rejected */
+    uint32_t wait;                       /**< Wait responses */
+    uint32_t reqTxFail;                  /**< Requests not acknowledged by GoodCRC after all retries */
+    uint32_t reqTimeout;                 /**< Requests without a response */
+    uint32_t psRdy;                      /**< Contracts completed (PS_RDY) after an Accept */
+    uint32_t psRdyLatency;               /**< Accept to PS_RDY, last contract */
+    uint32_t psRdyMaxLatency;            /**< Accept to PS_RDY, worst case */
+    uint32_t psRdySumLatency;            /**< Accept to PS_RDY, sum over psRdy contracts */
+    uint32_t softResetSent;              /**< Soft resets sent */
+    uint32_t hardResetSent;              /**< Hard resets sent */
+    uint32_t hardResetRcvd;              /**< Hard resets received */
+    uint32_t errRecovery;                /**< Type-C error recoveries */
+    uint32_t ppsKeepalive;               /**< Requests repeating the RDO of the present contract */
+    uint32_t ppsKeepalivePerHour;        /**< PPS keepalive rate, computed by the snapshot */
+    uint32_t startTs;                    /**< Start of the counting window */
+} stc_pd_stats_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if PD_STATS_ENABLE
+void pd_stats_init(void);
+void pd_stats_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void pd_stats_req_queued(const cy_stc_pdstack_context_t *context, uint32_t rdo);
+void pd_stats_req_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp, const cy_stc_pdstack_pd_packet_t *pkt);
+void pd_stats_get_snapshot(uint8_t port, stc_pd_stats_t *snapshot);
+void pd_stats_clear(uint8_t port);
+#else
+#define pd_stats_init()                         ((void)0)
+#define pd_stats_req_queued(context, rdo)       ((void)0)
+#define pd_stats_req_cb                         (NULL)
+#endif /* PD_STATS_ENABLE */
+
+#endif /* SRC_PD_STATS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,194 @@
+/*******************************************************************************
+* File Name: power_arb.c
+*
+* Description:
+*  This file contains the arbitration between the legacy charging and USB PD
+*  power paths and records the time to first power of each path.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "power_arb.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "config.h"
+#include "cy_pdl.h"
+#include "cy_app_battery_charging.h"
+
+#if BATTERY_CHARGING_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Arbitration statistics of each port */
+static stc_power_arb_stat_t gl_power_arb_stat[NO_OF_TYPEC_PORTS];
+
+/*******************************************************************************
+* Function Name: power_arb_evt_handler
+********************************************************************************
+* Summary:
+*  Records the attach time and the first explicit contract of each attach
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void power_arb_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    stc_power_arb_stat_t *stat = &gl_power_arb_stat[ctx->port];
+
+    if (evt == APP_EVT_CONNECT)
+    {
+        memset(stat, 0, sizeof(stc_power_arb_stat_t));
+        stat->attachTs = timestamp_get_ticks();
+    }
+    else if ((stat->pdTtp == 0u) && (stat->attachTs != 0u) && app_evt_contract_ok(data))
+    {
+        stat->pdTtp = timestamp_get_ticks() - stat->attachTs;
+        /* Contract current is in 10mA units and voltage in mV */
+        stat->pdPwr = ((uint32_t)ctx->dpmStat.contract.curPwr * 10u * ctx->dpmStat.contract.maxVolt) / 1000u;
+    }
+    else
+    {
+        /* Do Nothing */
+    }
+}
+
+/*******************************************************************************
+* Function Name: power_arb_task
+********************************************************************************
+* Summary:
+*  Detects power from the legacy charging path and applies the arbitration
+*  policy. Must be called from the main loop.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void power_arb_task(cy_stc_pdstack_context_t *context)
+{
+    stc_power_arb_stat_t *stat = &gl_power_arb_stat[context->port];
+    const cy_stc_bc_status_t *bc_stat;
+
+    if ((stat->attachTs == 0u) || !context->dpmConfig.attach)
+    {
+        return;
+    }
+
+    if (stat->legacyTtp == 0u)
+    {
+        bc_stat = Cy_App_Bc_GetStatus(context->ptrUsbPdContext);
+        if (!bc_stat->connected)
+        {
+            return;
+        }
+
+        switch (bc_stat->cur_mode)
+        {
+            case BC_CHARGE_DCP:
+            case BC_CHARGE_CDP:
+                stat->legacyPwr = (VSAFE_5V * POWER_ARB_BC_CUR) / 1000u;
+                break;
+
+            case BC_CHARGE_APPLE:
+                stat->legacyPwr = (VSAFE_5V * POWER_ARB_APPLE_CUR) / 1000u;
+                break;
+
+            case BC_CHARGE_QC2:
+            case BC_CHARGE_QC3:
+            case BC_CHARGE_AFC:
+                /* Negotiated operating point: voltage in mV and current in 10mA units */
+                stat->legacyPwr = ((uint32_t)bc_stat->cur_volt * bc_stat->cur_amp * 10u) / 1000u;
+                if (stat->legacyPwr == 0u)
+                {
+                    stat->legacyPwr = (VSAFE_5V * POWER_ARB_BC_CUR) / 1000u;
+                }
+                break;
+
+            default:
+                /* Not a charger: SDP or Type-C current only */
+                return;
+        }
+
+        stat->legacyTtp = timestamp_get_ticks() - stat->attachTs;
+        stat->legacyMode = (uint8_t)bc_stat->cur_mode;
+    }
+
+    if (stat->legacyStopped)
+    {
+        return;
+    }
+
+    if ((POWER_ARB_POLICY == POWER_ARB_PD_ONLY) ||
+        ((POWER_ARB_POLICY == POWER_ARB_HIGHEST_POWER) && (stat->pdTtp != 0u) && (stat->pdPwr >= stat->legacyPwr)))
+    {
+        (void)Cy_App_Bc_Stop(context->ptrUsbPdContext);
+        stat->legacyStopped = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: power_arb_get_stat
+********************************************************************************
+* Summary:
+*  Returns the arbitration statistics of a port
+*
+* Parameters:
+*  port - Port index
+*
+* Return:
+*  stc_power_arb_stat_t - Statistics of the current or last attach
+*
+*******************************************************************************/
+const stc_power_arb_stat_t *power_arb_get_stat(uint8_t port)
+{
+    return &gl_power_arb_stat[port];
+}
+
+#endif /* BATTERY_CHARGING_ENABLE */
+
+/* [] END OF FILE */
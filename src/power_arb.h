@@ -0,0 +1,108 @@
+/*******************************************************************************
+* File Name: power_arb.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  legacy charging vs. USB PD arbitration used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_POWER_ARB_H_
+#define SRC_POWER_ARB_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Nominal current (mA) assumed for a BC 1.2 DCP or CDP source, and for a QC or
+ * AFC charger which does not report its operating point.
+ */
+#define POWER_ARB_BC_CUR                        (1500u)
+
+/*
+ * Nominal current (mA) assumed for an Apple charger.
+ */
+#define POWER_ARB_APPLE_CUR                     (1000u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_power_arb_policy_t
+ * @brief Arbitration policy between the legacy charging and USB PD paths.
+ */
+typedef enum {
+    POWER_ARB_FASTEST                = 0, /**< Both paths run in parallel, the first one to provide power wins */
+    POWER_ARB_HIGHEST_POWER          = 1, /**< Legacy charging is stopped once PD provides at least as much power */
+    POWER_ARB_PD_ONLY                = 2, /**< Legacy charging is stopped as soon as it is detected */
+} en_power_arb_policy_t;
+
+/**
+ * @typedef stc_power_arb_stat_t
+ * @brief Time to first power and power of each path for the current attach.
+ */
+typedef struct {
+    uint32_t attachTs;                   /**< Attach timestamp in ticks */
+    uint32_t legacyTtp;                  /**< Ticks from attach to legacy charger detection, 0 if not detected */
+    uint32_t pdTtp;                      /**< Ticks from attach to the first explicit contract, 0 if none */
+    uint32_t legacyPwr;                  /**< Nominal legacy charging power in mW */
+    uint32_t pdPwr;                      /**< First PD contract power in mW */
+    uint8_t legacyMode;                  /**< Legacy charging mode (cy_en_bc_charge_mode_t) at detection */
+    bool legacyStopped;                  /**< Whether legacy charging was stopped by the policy */
+} stc_power_arb_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if BATTERY_CHARGING_ENABLE
+void power_arb_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void power_arb_task(cy_stc_pdstack_context_t *context);
+const stc_power_arb_stat_t *power_arb_get_stat(uint8_t port);
+#else
+#define power_arb_task(context)                 ((void)0)
+#endif /* BATTERY_CHARGING_ENABLE */
+
+#endif /* SRC_POWER_ARB_H_ */
+
+/* [] END OF FILE */
@@ -41,6 +41,7 @@
 /*******************************************************************************
  * Header files
  ******************************************************************************/
+#include <string.h>
 #include "pps.h"
 #include "cy_pdutils_sw_timer.h"
 #include "cy_pdl.h"
@@ -51,10 +52,26 @@
 #include "cy_pdutils.h"
 #include "config.h"
 #include "cy_app.h"
+#include "app_evt.h"
+#include "trace.h"
+#include "timestamp.h"
+#include "pd_capture.h"
+#include "charger_cache.h"
+#include "profile_store.h"
+#include "epr_gov.h"
+#include "cable_limit.h"
+#include "eff_search.h"
+#include "cur_probe.h"
+#include "batt_chg.h"
+#include "src_cap_ext.h"
+#include "pd_stats.h"
+#include "fault_timeline.h"
 
 /******************************************************************************
  * Macro definitions
  ******************************************************************************/
+/* Number of elements in an array */
+#define PPS_ARRAY_SIZE(arr)                     (sizeof(arr) / sizeof((arr)[0]))
 
 
 /******************************************************************************
@@ -66,154 +83,966 @@ static uint16_t gl_cur_voltage;
 /* Variable to store the min and max pps voltage */
 static uint16_t gl_max_pps_vol;
 
+/* Last PPS status received from the source */
+static stc_pps_status_t gl_pps_status;
+
+/* Voltage (mV) requested by the periodic PPS timer */
+static uint16_t gl_pps_req_volt;
+
+/* Set by pps_timer_cb when a PPS request is due */
+static volatile bool gl_pps_work_pending;
+
+/* Get_PPS_Status requesters waiting for pps_task, and those of the message in flight */
+static volatile uint8_t gl_pps_status_req;
+static volatile uint8_t gl_pps_status_sent;
+static cy_pdstack_dpm_pd_cmd_cbk_t gl_pps_status_req_cb[PPS_STATUS_REQ_COUNT];
+
+/* Longest time spent in pps_task in CPU cycles */
+static uint32_t gl_pps_task_max_cycles;
+
+/* Last PPS operating point (mV, mA) accepted by the source */
+static uint16_t gl_good_volt;
+static uint16_t gl_good_cur;
+
+/* PPS operating point requested and waiting for the contract to complete */
+static uint16_t gl_req_volt;
+static uint16_t gl_req_cur;
+
+/* Set from a hard reset or error recovery until the last good operating point is requested again */
+static bool gl_pps_recover;
+
+/* Set from a Type-C error recovery until the next explicit contract */
+static bool gl_pps_err_rec;
+
+/* Sink capabilities of each port, rebuilt after the sink capabilities change */
+static stc_pps_snk_cap_t gl_pps_snk_cap[NO_OF_TYPEC_PORTS];
+
+#if CHARGER_CACHE_ENABLE
+/* Fingerprint of the attached charger, 0 until the charger is identified */
+static uint32_t gl_charger_key;
+
+/* Identity of the attached charger, 0 if the source has no SCEDB */
+static uint16_t gl_charger_vid;
+static uint16_t gl_charger_pid;
+
+/* Set once the SCEDB exchange has given the identity or has failed */
+static bool gl_charger_id_done;
+
+/* Request sent to the source and waiting for the contract to complete */
+static stc_charger_entry_t gl_pend_req;
+
+/* Set while the cached operating point of a known charger is being requested */
+static bool gl_pps_cache_try;
+#endif /* CHARGER_CACHE_ENABLE */
+
 /* Timer context */
 extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
 
 /* USB PD context */
 extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
 
+/******************************************************************************
+ * Function prototypes
+ ******************************************************************************/
+#if CHARGER_CACHE_ENABLE
+static stc_charger_entry_t *pps_find_charger(cy_stc_pdstack_context_t *context);
+static void pps_cache_drop(void);
+static uint8_t get_src_pdo_count(cy_stc_pdstack_context_t *context, const cy_stc_pdstack_pd_packet_t* srcCap);
+#endif /* CHARGER_CACHE_ENABLE */
+
+/*******************************************************************************
+* Function Name: pps_evt_handler
+********************************************************************************
+* Summary:
+*  Restarts the PPS voltage sweep from 5V whenever the contract is lost.
+*  After a hard reset or error recovery, the last good PPS operating point is
+*  requested again as soon as the new explicit contract is in place.
+*  When the charger fingerprint cache is enabled, remembers the operating point
+*  of each completed PPS contract and requests the cached operating point of a
+*  known charger as soon as the first explicit contract is in place. A cached
+*  operating point that the source rejects is evicted.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+#if CHARGER_CACHE_ENABLE
+    stc_charger_entry_t *entry;
+#endif /* CHARGER_CACHE_ENABLE */
+
+    /* The stack reloads the sink capabilities of a port on the next attach */
+    if (evt == APP_EVT_DISCONNECT)
+    {
+        pps_snk_cap_changed(ctx);
+    }
+
+    if (ctx->port != gl_PdStackPort0Ctx.port)
+    {
+        return;
+    }
+
+    if (evt == APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE)
+    {
+        if (app_evt_contract_ok(data))
+        {
+            if (gl_req_volt != 0u)
+            {
+                gl_good_volt = gl_req_volt;
+                gl_good_cur = gl_req_cur;
+                fault_timeline_mark(FAULT_PHASE_RESTORED);
+            }
+            gl_pps_err_rec = false;
+
+            if (gl_pps_recover)
+            {
+                /* Restore the last good operating point without waiting for the PPS period */
+                gl_pps_work_pending = true;
+                gl_req_volt = 0u;
+                return;
+            }
+        }
+        gl_req_volt = 0u;
+
+#if CHARGER_CACHE_ENABLE
+        if (gl_pend_req.volt != 0u)
+        {
+            if (app_evt_contract_ok(data))
+            {
+                /* A charger not identified yet is remembered at a later PPS contract */
+                (void)pps_find_charger(ctx);
+                entry = (gl_charger_key != 0u) ? charger_cache_insert(gl_charger_key) : NULL;
+                if ((entry != NULL) && ((entry->volt != gl_pend_req.volt) || (entry->cur != gl_pend_req.cur) ||
+                    (entry->objPos != gl_pend_req.objPos) || (entry->maxPpsVolt != gl_max_pps_vol) ||
+                    (entry->maxCur != cur_probe_get(gl_pend_req.volt))))
+                {
+                    entry->volt = gl_pend_req.volt;
+                    entry->cur = gl_pend_req.cur;
+                    entry->objPos = gl_pend_req.objPos;
+                    entry->maxPpsVolt = gl_max_pps_vol;
+                    entry->maxCur = cur_probe_get(gl_pend_req.volt);
+                    profile_store_mark_dirty();
+                }
+                gl_pps_cache_try = false;
+            }
+            else if (gl_pps_cache_try)
+            {
+                pps_cache_drop();
+            }
+            gl_pend_req.volt = 0u;
+        }
+        else if (gl_max_pps_vol == 0u)
+        {
+            entry = pps_find_charger(ctx);
+            if ((entry != NULL) && (entry->volt != 0u))
+            {
+                /* Known charger: request its last operating point without waiting for the PPS period */
+                Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)ctx, (cy_timer_id_t)PPS_TIMER_ID,
+                        PPS_FAST_START_DELAY, pps_timer_cb);
+            }
+        }
+#endif /* CHARGER_CACHE_ENABLE */
+        return;
+    }
+
+    /* The last good operating point survives hard resets and error recovery, but not a detach */
+    if (evt == APP_EVT_TYPE_C_ERROR_RECOVERY)
+    {
+        gl_pps_err_rec = true;
+    }
+    if ((evt == APP_EVT_DISCONNECT) && !gl_pps_err_rec)
+    {
+        gl_good_volt = 0u;
+    }
+    gl_pps_recover = (gl_good_volt != 0u);
+    gl_req_volt = 0u;
+
+    gl_max_pps_vol = 0u;
+    gl_cur_voltage = 0u;
+    gl_pps_status.valid = false;
+    gl_pps_status_req = 0u;
+    gl_pps_status_sent = 0u;
+    gl_pps_work_pending = false;
+    eff_search_reset();
+    cur_probe_reset(evt == APP_EVT_DISCONNECT);
+    batt_chg_reset();
+#if CHARGER_CACHE_ENABLE
+    gl_pend_req.volt = 0u;
+    gl_pps_cache_try = false;
+    if (evt == APP_EVT_DISCONNECT)
+    {
+        gl_charger_key = 0u;
+        gl_charger_vid = 0u;
+        gl_charger_pid = 0u;
+        gl_charger_id_done = false;
+    }
+#endif /* CHARGER_CACHE_ENABLE */
+}
+
+/*******************************************************************************
+* Function Name: pps_status_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Get_PPS_Status command. Stores the PPS_Status
+*  data block received from the source.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_status_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp, const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    const uint8_t *sdb;
+
+    if ((resp != CY_PDSTACK_RES_RCVD) || (pkt == NULL) || (pkt->hdr.hdr.dataSize < 4u))
+    {
+        return;
+    }
+
+    /* PPS_Status data block: output voltage (2 bytes), output current (1 byte), real time flags (1 byte) */
+    sdb = (const uint8_t *)&pkt->dat[0];
+    gl_pps_status.outVolt = (uint16_t)sdb[0] | ((uint16_t)sdb[1] << 8u);
+    gl_pps_status.outCur = sdb[2];
+    gl_pps_status.flags = sdb[3];
+    gl_pps_status.valid = true;
+
+    trace_log(TRACE_EVT_PPS_STATUS, ctx->port, gl_pps_status.outVolt,
+            (uint32_t)gl_pps_status.outCur | ((uint32_t)gl_pps_status.flags << 8u));
+}
+
+/*******************************************************************************
+* Function Name: pps_get_status
+********************************************************************************
+* Summary:
+*  Returns the last PPS status received from the source
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_pps_status_t - PPS status. The valid flag is cleared on detach.
+*
+*******************************************************************************/
+const stc_pps_status_t *pps_get_status(void)
+{
+    return &gl_pps_status;
+}
+
+/*******************************************************************************
+* Function Name: pps_status_request
+********************************************************************************
+* Summary:
+*  Posts a Get_PPS_Status request. The message is sent from pps_task, so this
+*  function may be called from a soft timer callback.
+*
+* Parameters:
+*  req - Requester, PPS_STATUS_REQ_*
+*  cb - Callback invoked with the response, NULL if the status stored by
+*  pps_status_cb is enough
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_status_request(uint8_t req, cy_pdstack_dpm_pd_cmd_cbk_t cb)
+{
+    if (req < PPS_STATUS_REQ_COUNT)
+    {
+        gl_pps_status_req_cb[req] = cb;
+        gl_pps_status_req |= (uint8_t)(1u << req);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pps_status_req_cb
+********************************************************************************
+* Summary:
+*  Response callback of the Get_PPS_Status message sent by pps_status_send.
+*  Stores the PPS status and passes the response to each requester of the
+*  message.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void pps_status_req_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    uint8_t sent = gl_pps_status_sent;
+    uint8_t req;
+
+    gl_pps_status_sent = 0u;
+    pps_status_cb(ctx, resp, pkt);
+    for (req = 0u; req < PPS_STATUS_REQ_COUNT; req++)
+    {
+        if (((sent & (1u << req)) != 0u) && (gl_pps_status_req_cb[req] != NULL))
+        {
+            gl_pps_status_req_cb[req](ctx, resp, pkt);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: pps_status_send
+********************************************************************************
+* Summary:
+*  Sends the Get_PPS_Status message posted with pps_status_request, once the
+*  previous one has been answered
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void pps_status_send(void)
+{
+    uint8_t req = gl_pps_status_req;
+    uint32_t intr_state;
+
+    if ((req == 0u) || (gl_pps_status_sent != 0u))
+    {
+        return;
+    }
+
+    gl_pps_status_sent = req;
+    if (Cy_PdStack_Dpm_SendPdCommand(&gl_PdStackPort0Ctx, CY_PDSTACK_DPM_CMD_GET_PPS_STATUS, NULL, false,
+                pps_status_req_cb) == CY_PDSTACK_STAT_SUCCESS)
+    {
+        intr_state = Cy_SysLib_EnterCriticalSection();
+        gl_pps_status_req &= (uint8_t)~req;
+        Cy_SysLib_ExitCriticalSection(intr_state);
+    }
+    else
+    {
+        /* Retried on the next call */
+        gl_pps_status_sent = 0u;
+    }
+}
+
+#if CHARGER_CACHE_ENABLE
+/*******************************************************************************
+* Function Name: pps_set_charger_identity
+********************************************************************************
+* Summary:
+*  Sets the identity of the attached charger once the SCEDB exchange is over,
+*  with VID and PID 0 if the source does not support it. The charger is then
+*  looked up by its SPR source capabilities and identity, and the cached
+*  operating point of a known charger is requested if no PPS request was sent
+*  yet.
+*
+* Parameters:
+*  context - PdStack context
+*  vid - Vendor ID
+*  pid - Product ID
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_set_charger_identity(cy_stc_pdstack_context_t *context, uint16_t vid, uint16_t pid)
+{
+    stc_charger_entry_t *entry;
+    uint32_t key = gl_charger_key;
+
+    gl_charger_vid = vid;
+    gl_charger_pid = pid;
+    gl_charger_id_done = true;
+    gl_charger_key = 0u;
+
+    /* Identified again after a hard reset: the charger was already looked up */
+    entry = pps_find_charger(context);
+    if ((gl_charger_key == key) || (entry == NULL))
+    {
+        return;
+    }
+
+    if ((entry->volt != 0u) && (gl_max_pps_vol == 0u) && (gl_pend_req.volt == 0u) &&
+        context->dpmConfig.contractExist)
+    {
+        /* Known charger: request its last operating point without waiting for the PPS period */
+        Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, (void *)context, (cy_timer_id_t)PPS_TIMER_ID,
+                PPS_FAST_START_DELAY, pps_timer_cb);
+    }
+}
+#endif /* CHARGER_CACHE_ENABLE */
+
+/*******************************************************************************
+* Function Name: pps_timer_cb
+********************************************************************************
+* Summary:
+*  Sets the desire PPS contract request rate. The callback runs in the WDT
+*  interrupt, so it only posts the request to pps_task.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_timer_cb(
+        cy_timer_id_t id,            /**< Timer ID for which callback is being generated. */
+        void *callbackContext)       /**< Timer module Context. */
+{
+    gl_pps_work_pending = true;
+    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, callbackContext, id, PPS_REQ_TIMER, pps_timer_cb);
+}
+
+/*******************************************************************************
+* Function Name: pps_task
+********************************************************************************
+* Summary:
+*  Sends the posted Get_PPS_Status requests and requests the next PPS contract
+*  once posted by pps_timer_cb. Must be called from the main loop.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_task(void)
+{
+    uint16_t cur = 900;             //Default snk current in mA
+    uint32_t start;
+    uint32_t cycles;
+#if CHARGER_CACHE_ENABLE
+    stc_charger_entry_t *entry;
+#endif /* CHARGER_CACHE_ENABLE */
+
+    pps_status_send();
+
+    if(!gl_pps_work_pending)
+    {
+        return;
+    }
+    gl_pps_work_pending = false;
+
+    /* The PPS sweep is suspended while the EPR governor holds an AVS contract */
+    if(epr_gov_is_active())
+    {
+        return;
+    }
+
+    start = timestamp_get_cycles();
+
+    if(gl_pps_recover && gl_PdStackPort0Ctx.dpmConfig.contractExist)
+    {
+        gl_pps_recover = false;
+        gl_pps_req_volt = gl_good_volt;
+        cur = gl_good_cur;
+    }
+    else if(gl_max_pps_vol == 0)
+    {
+        gl_pps_req_volt = VSAFE_5V;         //First PPS contract
+#if CHARGER_CACHE_ENABLE
+        /* Resume from the last good operating point of a known charger, at the probed current if known */
+        entry = pps_find_charger(&gl_PdStackPort0Ctx);
+        if((entry != NULL) && (entry->volt != 0u))
+        {
+            gl_pps_req_volt = entry->volt;
+            cur = (entry->maxCur != 0u) ? entry->maxCur : entry->cur;
+            gl_max_pps_vol = entry->maxPpsVolt;
+            cur_probe_seed(entry->volt, entry->maxCur);
+            gl_pps_cache_try = true;
+        }
+#endif /* CHARGER_CACHE_ENABLE */
+    }
+    else
+    {
+#if EFF_SEARCH_ENABLE
+        gl_pps_req_volt = eff_search_step(&gl_PdStackPort0Ctx, gl_pps_req_volt, VSAFE_5V, gl_max_pps_vol);
+#elif CUR_PROBE_ENABLE
+        /* Hold the voltage and probe the sustainable current at it */
+        cur = cur_probe_step(&gl_PdStackPort0Ctx, gl_pps_req_volt, cur);
+#elif BATT_CHG_ENABLE
+        batt_chg_step(&gl_PdStackPort0Ctx, &gl_pps_req_volt, &cur);
+        if(gl_pps_req_volt > gl_max_pps_vol)
+        {
+            gl_pps_req_volt = gl_max_pps_vol;
+        }
+#else
+        gl_pps_req_volt += PPS_STEP;
+        if(gl_pps_req_volt > gl_max_pps_vol)
+        {
+            gl_pps_req_volt = VSAFE_5V;     //Minimum PPS voltage is limited to 5V
+        }
+#endif /* EFF_SEARCH_ENABLE */
+    }
+
+    updatePPScontract(gl_pps_req_volt, cur);
+
+    cycles = TIMESTAMP_CYCLES_DELTA(start, timestamp_get_cycles());
+    if(cycles > gl_pps_task_max_cycles)
+    {
+        gl_pps_task_max_cycles = cycles;
+    }
+}
+
+/*******************************************************************************
+* Function Name: pps_is_idle
+********************************************************************************
+* Summary:
+*  Checks whether a PPS request is waiting for pps_task
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if no PPS work is pending
+*
+*******************************************************************************/
+bool pps_is_idle(void)
+{
+    return (!gl_pps_work_pending);
+}
+
+/*******************************************************************************
+* Function Name: pps_get_task_cycles
+********************************************************************************
+* Summary:
+*  Returns the longest time spent in pps_task
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Duration in CPU cycles
+*
+*******************************************************************************/
+uint32_t pps_get_task_cycles(void)
+{
+    return gl_pps_task_max_cycles;
+}
+
+/*******************************************************************************
+* Function Name: pps_snk_cap_build
+********************************************************************************
+* Summary:
+*  Rebuilds the sink capability cache of a port from the SPR sink PDOs and, in
+*  EPR mode, the EPR sink PDOs, with the PPS voltage windows in mV and mA
+*
+* Parameters:
+*  context - PdStack context
+*  cap - Sink capability cache of the port
+*  epr_active - Whether EPR mode is active
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void pps_snk_cap_build(const cy_stc_pdstack_context_t *context, stc_pps_snk_cap_t *cap, bool epr_active)
+{
+    const cy_stc_pdstack_dpm_status_t *dpm_stat = &(context->dpmStat);
+#if CY_PD_EPR_ENABLE
+    const cy_stc_pdstack_dpm_ext_status_t *dpmExt = &(context->dpmExtStat);
+#endif /* CY_PD_EPR_ENABLE */
+    const cy_pd_pd_do_t *pdo_snk;
+    uint8_t snk_pdo_idx;
+    uint8_t snk_pdo_len = dpm_stat->curSnkPdocount;
+
+    /* Never trust the PDO count beyond the capacity of the PDO buffer */
+    if(snk_pdo_len > PPS_ARRAY_SIZE(dpm_stat->curSnkPdo))
+    {
+        snk_pdo_len = (uint8_t)PPS_ARRAY_SIZE(dpm_stat->curSnkPdo);
+    }
+    (void)memcpy(cap->pdo, dpm_stat->curSnkPdo, snk_pdo_len * sizeof(cy_pd_pd_do_t));
+    cap->pdoCnt = snk_pdo_len;
+
+#if CY_PD_EPR_ENABLE
+    /* In EPR mode the EPR sink PDOs are held in their own buffer */
+    if(epr_active)
+    {
+        snk_pdo_len = dpmExt->curEprSnkPdoCount;
+        if(snk_pdo_len > PPS_ARRAY_SIZE(dpmExt->curEprSnkPdo))
+        {
+            snk_pdo_len = (uint8_t)PPS_ARRAY_SIZE(dpmExt->curEprSnkPdo);
+        }
+        (void)memcpy(&cap->pdo[cap->pdoCnt], dpmExt->curEprSnkPdo, snk_pdo_len * sizeof(cy_pd_pd_do_t));
+        cap->pdoCnt += snk_pdo_len;
+    }
+#endif /* CY_PD_EPR_ENABLE */
+
+    cap->winCnt = 0u;
+    for(snk_pdo_idx = 0; snk_pdo_idx < cap->pdoCnt; snk_pdo_idx++)
+    {
+        pdo_snk = &(cap->pdo[snk_pdo_idx]);
+        if((pdo_snk->pps_snk.supplyType == CY_PDSTACK_PDO_AUGMENTED) &&
+           (pdo_snk->pps_snk.apdoType == CY_PDSTACK_APDO_PPS))
+        {
+            cap->win[cap->winCnt].minVolt = (uint16_t)(pdo_snk->pps_snk.minVolt * 100u);
+            cap->win[cap->winCnt].maxVolt = (uint16_t)(pdo_snk->pps_snk.maxVolt * 100u);
+            cap->win[cap->winCnt].opCur = (uint16_t)(pdo_snk->pps_snk.opCur * 50u);
+            cap->winCnt++;
+        }
+    }
+    cap->eprActive = epr_active;
+    cap->valid = true;
+}
+
+/*******************************************************************************
+* Function Name: pps_snk_cap_get
+********************************************************************************
+* Summary:
+*  Returns the sink capability cache of a port, rebuilt if the sink
+*  capabilities changed or EPR mode was entered or exited since it was built
+*
+* Parameters:
+*  context - PdStack context
+*
+* Return:
+*  stc_pps_snk_cap_t - Sink capability cache of the port
+*
+*******************************************************************************/
+static const stc_pps_snk_cap_t *pps_snk_cap_get(const cy_stc_pdstack_context_t *context)
+{
+    stc_pps_snk_cap_t *cap = &gl_pps_snk_cap[context->port];
+    bool epr_active = false;
+
+#if CY_PD_EPR_ENABLE
+    epr_active = context->dpmExtStat.eprActive;
+#endif /* CY_PD_EPR_ENABLE */
+
+    if((!cap->valid) || (cap->eprActive != epr_active))
+    {
+        pps_snk_cap_build(context, cap, epr_active);
+    }
+
+    return cap;
+}
+
+/*******************************************************************************
+* Function Name: pps_snk_cap_changed
+********************************************************************************
+* Summary:
+*  Invalidates the sink capability cache of a port. Must be called whenever
+*  the sink capabilities of the port are updated.
+*
+* Parameters:
+*  context - PdStack context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_snk_cap_changed(cy_stc_pdstack_context_t *context)
+{
+    gl_pps_snk_cap[context->port].valid = false;
+}
+
 /*******************************************************************************
-* Function Name: pps_timer_cb
+* Function Name: pps_get_cur_limit
 ********************************************************************************
 * Summary:
-*  Sets the desire PPS contract request rate
+*  Returns the highest operating current that may be requested at a PPS
+*  voltage: the maximum current of the PPS APDO in the present contract, the
+*  operating current of the matching sink PPS PDO, the cable rating and the
+*  source PDP.
 *
 * Parameters:
-*  id - Timer ID
-*  callbackContext - Context
+*  context - PdStack context
+*  volt - Voltage in mV
 *
 * Return:
-*  None
+*  uint16_t - Current in mA, 0 if not in a PPS contract
 *
 *******************************************************************************/
-void pps_timer_cb(
-        cy_timer_id_t id,            /**< Timer ID for which callback is being generated. */
-        void *callbackContext)       /**< Timer module Context. */
+uint16_t pps_get_cur_limit(cy_stc_pdstack_context_t *context, uint16_t volt)
 {
-    uint16_t cur = 900;             //Default snk current in mA
-    static uint16_t volt;
+    const cy_pd_pd_do_t *pdo_src = &(context->dpmStat.srcSelPdo);
+    const stc_pps_snk_cap_t *cap;
+    uint16_t limit;
+    uint16_t snk_cur = 0u;
+    uint8_t idx;
 
-    if(gl_max_pps_vol == 0)
+    if((!context->dpmConfig.contractExist) ||
+       (pdo_src->pps_src.supplyType != CY_PDSTACK_PDO_AUGMENTED) ||
+       (pdo_src->pps_src.apdoType != CY_PDSTACK_APDO_PPS))
     {
-        volt = VSAFE_5V;                    //First PPS contract
+        return 0u;
     }
-    else
+
+    /* Convert PDO current to mA from 50 mA unit */
+    limit = (uint16_t)(pdo_src->pps_src.maxCur * 50u);
+
+    cap = pps_snk_cap_get(context);
+    for(idx = 0; idx < cap->winCnt; idx++)
     {
-        volt += PPS_STEP;
-        if(volt > gl_max_pps_vol)
+        if((volt >= cap->win[idx].minVolt) && (volt <= cap->win[idx].maxVolt) &&
+           (cap->win[idx].opCur > snk_cur))
         {
-            volt = VSAFE_5V;                //Minimum PPS voltage is limited to 5V
+            snk_cur = cap->win[idx].opCur;
         }
     }
 
-    updatePPScontract(volt, cur);
-    Cy_PdUtils_SwTimer_Start (&gl_TimerCtx, callbackContext, id, PPS_REQ_TIMER, pps_timer_cb);
-}
+    if(snk_cur < limit)
+    {
+        limit = snk_cur;
+    }
+    if(cable_limit_get_max_cur(context) < limit)
+    {
+        limit = cable_limit_get_max_cur(context);
+    }
+    if(src_cap_ext_get_max_cur(context, volt) < limit)
+    {
+        limit = src_cap_ext_get_max_cur(context, volt);
+    }
 
+    return limit;
+}
 
 /*******************************************************************************
-* Function Name: is_request_valid
+* Function Name: is_snk_pdo_match
 ********************************************************************************
 * Summary:
-*  Validates user request
+*  Checks whether a sink PDO covers the requested voltage and current
 *
 * Parameters:
-*  context - PdStack context
+*  pdo_snk - Sink PDO
 *  volt - Voltage in 50mV
 *  cur - Current in 10mA
 *
 * Return:
-*  true if the request is valid otherwise false
+*  true if the sink PDO covers the request
 *
 *******************************************************************************/
-static bool is_request_valid(cy_stc_pdstack_context_t *context, uint16_t volt, uint16_t cur)
+static bool is_snk_pdo_match(const cy_pd_pd_do_t *pdo_snk, uint16_t volt, uint16_t cur)
 {
-    cy_stc_pdstack_dpm_status_t *dpm_stat = &(context->dpmStat);
-#if CY_PD_EPR_ENABLE
-    cy_stc_pdstack_dpm_ext_status_t *dpmExt = &(context->dpmExtStat);
-#endif /* CY_PD_EPR_ENABLE */
-    cy_en_pdstack_pdo_t supply_type;
-    uint8_t snk_pdo_idx;
-    uint8_t snk_pdo_len = dpm_stat->curSnkPdocount;
-    cy_pd_pd_do_t* pdo_snk;
+    cy_en_pdstack_pdo_t supply_type = (cy_en_pdstack_pdo_t)pdo_snk->fixed_snk.supplyType;
 
-#if CY_PD_EPR_ENABLE
-    if(dpmExt->eprActive)
-    {
-        snk_pdo_len = CY_PD_MAX_NO_OF_PDO + dpmExt->curEprSnkPdoCount;
-    }
-#endif /* CY_PD_EPR_ENABLE */
-
-    for(snk_pdo_idx = 0; snk_pdo_idx < snk_pdo_len; snk_pdo_idx++)
+    switch(supply_type)
     {
-        pdo_snk = (cy_pd_pd_do_t*)&(dpm_stat->curSnkPdo[snk_pdo_idx]);
-        supply_type = (cy_en_pdstack_pdo_t)pdo_snk->fixed_snk.supplyType;
-
-        switch(supply_type)
-        {
-            case CY_PDSTACK_PDO_FIXED_SUPPLY:
-                if((volt == pdo_snk->fixed_snk.voltage) && (cur <= pdo_snk->fixed_snk.opCurrent))
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            if((volt == pdo_snk->fixed_snk.voltage) && (cur <= pdo_snk->fixed_snk.opCurrent))
+            {
+                return true;
+            }
+            break;
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            if((volt >= pdo_snk->var_snk.minVoltage) && (volt <= pdo_snk->var_snk.maxVoltage))
+            {
+                if(cur <= pdo_snk->var_snk.opCurrent)
                 {
                     return true;
                 }
-                break;
-            case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
-                if((volt >= pdo_snk->var_snk.minVoltage) && (volt <= pdo_snk->var_snk.maxVoltage))
+            }
+            break;
+        case CY_PDSTACK_PDO_BATTERY:
+            if((volt >= pdo_snk->bat_snk.minVoltage) && (volt <= pdo_snk->bat_snk.maxVoltage))
+            {
+                uint16_t power = CY_PDUTILS_DIV_ROUND_UP(volt * cur, 500);
+                if(power <= pdo_snk->bat_snk.opPower)
                 {
-                    if(cur <= pdo_snk->var_snk.opCurrent)
-                    {
-                        return true;
-                    }
+                    return true;
                 }
-                break;
-            case CY_PDSTACK_PDO_BATTERY:
-                if((volt >= pdo_snk->bat_snk.minVoltage) && (volt <= pdo_snk->bat_snk.maxVoltage))
+            }
+            break;
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if(pdo_snk->pps_snk.apdoType == CY_PDSTACK_APDO_PPS)
+            {
+                /* Convert PDO voltage to 50 mV from 100 mV unit */
+                if((volt >= pdo_snk->pps_snk.minVolt * 2u) && (volt <= pdo_snk->pps_snk.maxVolt * 2u))
                 {
-                    uint16_t power = CY_PDUTILS_DIV_ROUND_UP(volt * cur, 500);
-                    if(power <= pdo_snk->bat_snk.opPower)
+                    /* Convert PDO current to 10mA from 50 mA unit */
+                    if(cur <= pdo_snk->pps_snk.opCur * 5u)
                     {
                         return true;
                     }
                 }
-                break;
-            case CY_PDSTACK_PDO_AUGMENTED:
-                if(pdo_snk->pps_snk.apdoType == CY_PDSTACK_APDO_PPS)
-                {
-                    /* Convert PDO voltage to 50 mV from 100 mV unit */
-                    if((volt >= pdo_snk->pps_snk.minVolt * 2u) && (volt <= pdo_snk->pps_snk.maxVolt * 2u))
-                    {
-                        /* Convert PDO current to 10mA from 50 mA unit */
-                        if(cur <= pdo_snk->pps_snk.opCur * 5u)
-                        {
-                            return true;
-                        }
-                    }
-                }
+            }
 #if (CY_PD_EPR_AVS_ENABLE)
-                if(pdo_snk->epr_avs_snk.apdoType == CY_PDSTACK_APDO_AVS)
+            if(pdo_snk->epr_avs_snk.apdoType == CY_PDSTACK_APDO_AVS)
+            {
+                /* Convert PDO voltage to 50 mV from 100 mV unit */
+                if((volt >= pdo_snk->epr_avs_snk.minVolt * 2u) && (volt <= pdo_snk->epr_avs_snk.maxVolt * 2u))
                 {
-                    /* Convert PDO voltage to 50 mV from 100 mV unit */
-                    if((volt >= pdo_snk->epr_avs_snk.minVolt * 2u) && (volt <= pdo_snk->epr_avs_snk.maxVolt * 2u))
+                    /* Calculate the power in 250mW units */
+                    uint16_t power = CY_PDUTILS_DIV_ROUND_UP(volt * cur, 500);
+                    /* Convert PDP to 250mW units */
+                    if(power <= pdo_snk->epr_avs_snk.pdp * 4u)
                     {
-                        /* Calculate the power in 250mW units */
-                        uint16_t power = CY_PDUTILS_DIV_ROUND_UP(volt * cur, 500);
-                        /* Convert PDP to 250mW units */
-                        if(power <= pdo_snk->epr_avs_snk.pdp * 4u)
-                        {
-                            return true;
-                        }
+                        return true;
                     }
                 }
+            }
 #endif /* CY_PD_EPR_AVS_ENABLE */
-                break;
-            default:
-                /* Do Nothing */
-                break;
+            break;
+        default:
+            /* Do Nothing */
+            break;
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: is_request_valid
+********************************************************************************
+* Summary:
+*  Validates user request against the cached SPR sink PDOs and, in EPR mode,
+*  the EPR sink PDOs
+*
+* Parameters:
+*  context - PdStack context
+*  volt - Voltage in 50mV
+*  cur - Current in 10mA
+*
+* Return:
+*  true if the request is valid otherwise false
+*
+*******************************************************************************/
+static bool is_request_valid(cy_stc_pdstack_context_t *context, uint16_t volt, uint16_t cur)
+{
+    const stc_pps_snk_cap_t *cap = pps_snk_cap_get(context);
+    uint8_t snk_pdo_idx;
+
+    for(snk_pdo_idx = 0; snk_pdo_idx < cap->pdoCnt; snk_pdo_idx++)
+    {
+        if(is_snk_pdo_match(&(cap->pdo[snk_pdo_idx]), volt, cur))
+        {
+            return true;
         }
     }
+
     return false;
 }
 
+/*******************************************************************************
+* Function Name: get_src_pdo_count
+********************************************************************************
+* Summary:
+*  Returns the number of PDOs in the source capabilities message
+*
+* Parameters:
+*  context - PdStack context
+*  srcCap - Pointer to source capabilities message
+*
+* Return:
+*  uint8_t - Number of PDOs
+*
+*******************************************************************************/
+static uint8_t get_src_pdo_count(cy_stc_pdstack_context_t *context, const cy_stc_pdstack_pd_packet_t* srcCap)
+{
+    uint32_t src_pdo_len = srcCap->len;
+    uint32_t max_pdo_len = PPS_ARRAY_SIZE(srcCap->dat);
+#if CY_PD_EPR_ENABLE
+    cy_stc_pdstack_dpm_ext_status_t *dpmExt = &(context->dpmExtStat);
+
+    if(srcCap->hdr.hdr.extd && dpmExt->eprActive)
+    {
+        /* The EPR_Source_Capabilities packet is held in the extended packet buffer */
+        src_pdo_len = srcCap->hdr.hdr.dataSize / 4u;
+        max_pdo_len = PPS_MAX_EPR_SRC_PDO_CNT;
+    }
+#else
+    (void)context;
+#endif /* CY_PD_EPR_ENABLE */
+
+    /* Never trust the received length beyond the capacity of the PDO buffer */
+    if(src_pdo_len > max_pdo_len)
+    {
+        src_pdo_len = max_pdo_len;
+    }
+
+    return (uint8_t)src_pdo_len;
+}
+
+#if CHARGER_CACHE_ENABLE
+/*******************************************************************************
+* Function Name: pps_find_charger
+********************************************************************************
+* Summary:
+*  Looks up the attached charger in the fingerprint cache. The fingerprint
+*  covers the SPR source capabilities only, so that it does not depend on
+*  whether EPR mode was entered first, and the identity of the charger, so
+*  that the lookup waits for the SCEDB exchange.
+*
+* Parameters:
+*  context - PdStack context
+*
+* Return:
+*  stc_charger_entry_t - Cache entry, NULL if the charger is not known
+*
+*******************************************************************************/
+static stc_charger_entry_t *pps_find_charger(cy_stc_pdstack_context_t *context)
+{
+    cy_stc_pdstack_pd_packet_t *srcCap = context->dpmStat.srcCapP;
+    uint8_t count;
+
+    if(gl_charger_key == 0u)
+    {
+#if SRC_CAP_EXT_ENABLE
+        if(!gl_charger_id_done)
+        {
+            return NULL;
+        }
+#endif /* SRC_CAP_EXT_ENABLE */
+        if(srcCap == NULL)
+        {
+            return NULL;
+        }
+
+        /* The SPR PDOs lead both source capabilities messages; EPR ones pad them with empty positions */
+        count = get_src_pdo_count(context, srcCap);
+        if(count > CY_PD_MAX_NO_OF_PDO)
+        {
+            count = CY_PD_MAX_NO_OF_PDO;
+        }
+        while((count != 0u) && (srcCap->dat[count - 1u].val == 0u))
+        {
+            count--;
+        }
+        gl_charger_key = charger_cache_key(srcCap->dat, count, gl_charger_vid, gl_charger_pid);
+    }
+
+    return charger_cache_lookup(gl_charger_key);
+}
+
+/*******************************************************************************
+* Function Name: pps_cache_drop
+********************************************************************************
+* Summary:
+*  Evicts the cached operating point of the attached charger after it has
+*  been refused, and falls back to the 5V first PPS contract
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void pps_cache_drop(void)
+{
+    charger_cache_evict(gl_charger_key);
+    profile_store_mark_dirty();
+    gl_pps_cache_try = false;
+    gl_max_pps_vol = 0u;
+
+    /* Request the 5V first contract without waiting for the PPS period */
+    gl_pps_work_pending = true;
+}
+#endif /* CHARGER_CACHE_ENABLE */
+
 /*******************************************************************************
 * Function Name: select_src_pdo
 ********************************************************************************
@@ -235,21 +1064,11 @@ static uint8_t select_src_pdo(cy_stc_pdstack_context_t *context, en_supply_type_
                               cy_stc_pdstack_pd_packet_t* srcCap)
 {
     bool status = false;
-#if CY_PD_EPR_ENABLE
-    cy_stc_pdstack_dpm_ext_status_t *dpmExt = &(context->dpmExtStat);
-#endif /* CY_PD_EPR_ENABLE */
     uint8_t src_pdo_idx;
-    uint8_t src_pdo_len = srcCap->len;
+    uint8_t src_pdo_len = get_src_pdo_count(context, srcCap);
     cy_pd_pd_do_t* pdo_src;
     uint8_t obj_pos = 0u;
 
-#if CY_PD_EPR_ENABLE
-    if(srcCap->hdr.hdr.extd && dpmExt->eprActive)
-    {
-        src_pdo_len = srcCap->hdr.hdr.dataSize / 4u;
-    }
-#endif /* CY_PD_EPR_ENABLE */
-
     for(src_pdo_idx = 0; src_pdo_idx < src_pdo_len; src_pdo_idx++)
     {
         status = false;
@@ -349,31 +1168,26 @@ static uint8_t select_src_pdo(cy_stc_pdstack_context_t *context, en_supply_type_
 }
 
 /*******************************************************************************
-* Function Name: send_request
+* Function Name: pps_build_rdo
 ********************************************************************************
 * Summary:
-*  Forms RDO and sends request message
+*  Encodes the request data object for the selected source PDO. This function
+*  has no side effects so that it can be verified against a reference encoder.
 *
 * Parameters:
 *  context - PdStack context
-*  pdo_no - PDO number
+*  pdo_src - Selected source PDO
+*  pdo_no - Object position of the selected PDO (1 based)
 *  volt - Voltage in 50mV
-*  Cur - Current in 10mA
-*  srcCap - Pointer to source capabilities message
+*  cur - Current in 10mA
 *
 * Return:
-* CY_PDSTACK_STAT_SUCCESS if the request is successful
-* CY_PDSTACK_STAT_FAILURE if the request is failed
+*  cy_pd_pd_do_t - Request data object
 *
 *******************************************************************************/
-static cy_en_pdstack_status_t send_request(cy_stc_pdstack_context_t *context, uint8_t pdo_no, uint16_t volt, uint16_t cur, cy_stc_pdstack_pd_packet_t* srcCap)
+cy_pd_pd_do_t pps_build_rdo(const cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+                            uint8_t pdo_no, uint16_t volt, uint16_t cur)
 {
-    cy_en_pdstack_status_t status;
-#if (CY_PD_EPR_ENABLE)
-    const cy_stc_pdstack_dpm_ext_status_t *dpmExtStat = &(context->dpmExtStat);
-#endif /* (CY_PD_EPR_ENABLE) */
-    cy_stc_pdstack_dpm_pd_cmd_buf_t cmd_buf;
-    cy_pd_pd_do_t* pdo_src = &srcCap->dat[pdo_no - 1u];
     cy_pd_pd_do_t snkRdo;
 
     snkRdo.val = 0u;
@@ -397,6 +1211,7 @@ static cy_en_pdstack_status_t send_request(cy_stc_pdstack_context_t *context, ui
         snkRdo.rdo_gen.giveBackFlag = false;
         if(pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_BATTERY)
         {
+            /* Convert power to 250 mW unit */
             uint16_t power = CY_PDUTILS_DIV_ROUND_UP(volt * cur, 500);
             snkRdo.rdo_gen.opPowerCur = power;
             snkRdo.rdo_gen.minMaxPowerCur = power;
@@ -412,15 +1227,18 @@ static cy_en_pdstack_status_t send_request(cy_stc_pdstack_context_t *context, ui
         if((pdo_src->spr_avs_src.apdoType == CY_PDSTACK_APDO_SPR_AVS) ||
            (pdo_src->epr_avs_src.apdoType == CY_PDSTACK_APDO_AVS))
         {
-            /* Convert voltage to 25 mV unit */
-            snkRdo.rdo_spr_avs.outVolt = volt * 2u;
+            /*
+             * Convert voltage to 25 mV unit. The two least significant bits must be zero,
+             * which makes the effective step 100 mV, so round down to a 100 mV boundary.
+             */
+            snkRdo.rdo_spr_avs.outVolt = (uint16_t)(volt * 2u) & AVS_RDO_VOLT_MASK;
             /* Convert current to 50 mA unit */
             snkRdo.rdo_spr_avs.opCur = cur / 5u;
         }
         else if(pdo_src->pps_src.apdoType == CY_PDSTACK_APDO_PPS)
         {
             /* Convert voltage to 20 mV unit */
-            snkRdo.rdo_pps.outVolt = (uint16_t)(volt * 25)/10;
+            snkRdo.rdo_pps.outVolt = (uint16_t)((volt * 5u) / 2u);
             /* Convert current to 50 mA unit */
             snkRdo.rdo_pps.opCur = cur / 5u;
         }
@@ -431,33 +1249,74 @@ static cy_en_pdstack_status_t send_request(cy_stc_pdstack_context_t *context, ui
     if (context->dpmConfig.specRevSopLive >= CY_PD_REV3)
     {
         snkRdo.rdo_gen.unchunkSup = true;
+#if (CY_PD_EPR_ENABLE)
+        snkRdo.rdo_gen.eprModeCapable = context->dpmExtStat.epr.snkEnable;
+#endif /* CY_PD_EPR_ENABLE */
     }
+#endif /* CY_PD_REV3_ENABLE */
 
-#if (CY_PD_EPR_ENABLE)
-    if (context->dpmConfig.specRevSopLive >= CY_PD_REV3)
+    return snkRdo;
+}
+
+/*******************************************************************************
+* Function Name: send_request
+********************************************************************************
+* Summary:
+*  Forms RDO and sends request message
+*
+* Parameters:
+*  context - PdStack context
+*  pdo_no - PDO number
+*  volt - Voltage in 50mV
+*  Cur - Current in 10mA
+*  srcCap - Pointer to source capabilities message
+*  rdo - Returns the request data object that was sent
+*
+* Return:
+* CY_PDSTACK_STAT_SUCCESS if the request is successful
+* CY_PDSTACK_STAT_FAILURE if the request is failed
+*
+*******************************************************************************/
+static cy_en_pdstack_status_t send_request(cy_stc_pdstack_context_t *context, uint8_t pdo_no, uint16_t volt, uint16_t cur,
+                                           cy_stc_pdstack_pd_packet_t* srcCap, uint32_t *rdo)
+{
+    cy_en_pdstack_status_t status;
+    cy_stc_pdstack_dpm_pd_cmd_buf_t cmd_buf;
+    cy_pd_pd_do_t* pdo_src;
+    cy_pd_pd_do_t snkRdo;
+
+    if((pdo_no == 0u) || (pdo_no > get_src_pdo_count(context, srcCap)))
     {
-        snkRdo.rdo_gen.eprModeCapable = dpmExtStat->epr.snkEnable;
+        return CY_PDSTACK_STAT_BAD_PARAM;
     }
-#endif /* CY_PD_EPR_ENABLE */
-#endif /* CY_PD_REV3_ENABLE */
+
+    pdo_src = &srcCap->dat[pdo_no - 1u];
+    snkRdo = pps_build_rdo(context, pdo_src, pdo_no, volt, cur);
 
     /* Prepare the DPM command buffer */
     cmd_buf.cmdSop = (cy_en_pd_sop_t)CY_PD_SOP;
     cmd_buf.noOfCmdDo = 1u;
     cmd_buf.cmdDo[0] = snkRdo;
 #if (CY_PD_EPR_ENABLE)
-    if(dpmExtStat->eprActive == true)
+    if(context->dpmExtStat.eprActive == true)
     {
         cmd_buf.noOfCmdDo = 2u;
         cmd_buf.cmdDo[1].val = pdo_src->val;
 
-        status = Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_EPR_REQUEST, &cmd_buf, false, NULL);
+        status = Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_EPR_REQUEST, &cmd_buf, false, pd_stats_req_cb);
     }
     else
 #endif /* (CY_PD_EPR_ENABLE) */
     {
-        status = Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_REQUEST, &cmd_buf, false, NULL);
+        status = Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SEND_REQUEST, &cmd_buf, false, pd_stats_req_cb);
+    }
+
+    if(status == CY_PDSTACK_STAT_SUCCESS)
+    {
+        pd_stats_req_queued(context, snkRdo.val);
     }
+    trace_log(TRACE_EVT_REQ_SENT, context->port, (uint16_t)status, snkRdo.val);
+    *rdo = snkRdo.val;
 
     return status;
 }
@@ -483,20 +1342,78 @@ static cy_en_pdstack_status_t snk_request_new_contract(cy_stc_pdstack_context_t
 {
     cy_en_pdstack_status_t status = CY_PDSTACK_STAT_FAILURE;
     uint8_t obj_pos = 0u;
+    uint32_t rdo = 0u;
+    uint16_t req_volt = volt;
+    uint16_t req_cur = cur;
+    uint16_t cable_cur = cable_limit_get_max_cur(context);
+    uint16_t pdp_cur = src_cap_ext_get_max_cur(context, volt);
+
+    trace_log(TRACE_EVT_CONTRACT_REQ, context->port, volt, cur);
+
+    /* Never request more current than the cable can carry */
+    if(cur > cable_cur)
+    {
+        cur = cable_cur;
+    }
+
+    /* Or more than the source can sustain within its PDP */
+    if(cur > pdp_cur)
+    {
+        cur = pdp_cur;
+    }
+
     /* Convert voltage to 50mV units */
     volt = volt / 50u;
     /* Convert current to 10mA units */
     cur = cur / 10u;
 
+    /* No source capabilities have been received yet */
+    if(context->dpmStat.srcCapP == NULL)
+    {
+        return status;
+    }
+
+    /* Record every input of the evaluation so that it can be replayed off target */
+    pd_capture_src_cap(context, context->dpmStat.srcCapP, get_src_pdo_count(context, context->dpmStat.srcCapP));
+    pd_capture_snk_cap(context);
+
     if(is_request_valid(context, volt, cur))
     {
         obj_pos = select_src_pdo(context, supply_type, volt, cur, context->dpmStat.srcCapP);
+        trace_log(TRACE_EVT_PDO_SELECT, context->port, obj_pos, (uint32_t)supply_type);
         if(obj_pos != 0u)
         {
-            status = send_request(context, obj_pos, volt, cur, context->dpmStat.srcCapP);
+            status = send_request(context, obj_pos, volt, cur, context->dpmStat.srcCapP, &rdo);
         }
     }
 
+    if((status == CY_PDSTACK_STAT_SUCCESS) && (supply_type == PROGRAMMABLE_POWER_SUPPLY))
+    {
+        gl_req_volt = req_volt;
+        gl_req_cur = req_cur;
+    }
+
+#if CHARGER_CACHE_ENABLE
+    if((status == CY_PDSTACK_STAT_SUCCESS) && (supply_type == PROGRAMMABLE_POWER_SUPPLY))
+    {
+        gl_pend_req.volt = req_volt;
+        gl_pend_req.cur = req_cur;
+        gl_pend_req.objPos = obj_pos;
+    }
+    else if(status == CY_PDSTACK_STAT_SUCCESS)
+    {
+        /* Only PPS operating points are cached; the PPS sweep replays them on the next attach */
+        gl_pend_req.volt = 0u;
+    }
+    else if(gl_pps_cache_try && (obj_pos == 0u))
+    {
+        /* The cached operating point is no longer offered or no longer valid for the sink */
+        pps_cache_drop();
+    }
+#endif /* CHARGER_CACHE_ENABLE */
+
+    pd_capture_request(req_volt, req_cur, cable_cur, pdp_cur, (uint8_t)supply_type, obj_pos, status, rdo);
+
     return status;
 }
 
@@ -544,5 +1461,26 @@ void updatePPScontract(int16_t volt, int16_t cur)
     }
 }
 
+/*******************************************************************************
+* Function Name: pps_request_contract
+********************************************************************************
+* Summary:
+*  Requests a contract of the given supply type from the source on port 0
+*
+* Parameters:
+*  supply_type - Supply type
+*  volt - Voltage in mV
+*  cur - Current in mA
+*
+* Return:
+* CY_PDSTACK_STAT_SUCCESS if the request is successful.
+* CY_PDSTACK_STAT_FAILURE if the request is failed.
+*
+*******************************************************************************/
+cy_en_pdstack_status_t pps_request_contract(en_supply_type_t supply_type, uint16_t volt, uint16_t cur)
+{
+    return snk_request_new_contract(&gl_PdStackPort0Ctx, supply_type, volt, cur);
+}
+
 /* [] END OF FILE */
 
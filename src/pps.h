@@ -72,6 +72,55 @@
  */
 #define APDO_MASK                               (0xF0)
 
+/*
+ * Maximum number of PDOs in an EPR_Source_Capabilities message (7 SPR + 6 EPR).
+ */
+#define PPS_MAX_EPR_SRC_PDO_CNT                 (CY_PD_MAX_NO_OF_PDO + 6u)
+
+/*
+ * Maximum number of sink PDOs cached per port: the SPR sink PDOs, followed by
+ * the EPR sink PDOs in EPR mode.
+ */
+#if CY_PD_EPR_ENABLE
+#define PPS_SNK_PDO_MAX                         (CY_PD_MAX_NO_OF_PDO + CY_PD_MAX_NO_OF_EPR_PDO)
+#else
+#define PPS_SNK_PDO_MAX                         (CY_PD_MAX_NO_OF_PDO)
+#endif /* CY_PD_EPR_ENABLE */
+
+/*
+ * AVS request output voltage mask. The voltage is in 25mV units with the two
+ * least significant bits cleared, giving an effective 100mV step.
+ */
+#define AVS_RDO_VOLT_MASK                       (0xFFFCu)
+
+/*
+ * PPS status real time flags: Operating Mode Flag (source is in current limit).
+ */
+#define PPS_STATUS_OMF_MASK                     (0x08u)
+
+/*
+ * PPS status output voltage value reported when the field is not supported.
+ */
+#define PPS_STATUS_VOLT_NOT_SUPP                (0xFFFFu)
+
+/*
+ * PPS status output current value reported when the field is not supported.
+ */
+#define PPS_STATUS_CUR_NOT_SUPP                 (0xFFu)
+
+/*
+ * Get_PPS_Status requesters. Timer callbacks and the user switch post a
+ * request with pps_status_request; pps_task sends the message, stores the
+ * response with pps_status_cb and passes it to every requester posted before
+ * it was sent.
+ */
+#define PPS_STATUS_REQ_EFF                      (0u)
+#define PPS_STATUS_REQ_ENERGY                   (1u)
+#define PPS_STATUS_REQ_PROBE                    (2u)
+#define PPS_STATUS_REQ_BATT                     (3u)
+#define PPS_STATUS_REQ_SWITCH                   (4u)
+#define PPS_STATUS_REQ_COUNT                    (5u)
+
 /*****************************************************************************
  * Data struct definition
  ****************************************************************************/
@@ -88,11 +137,59 @@ typedef enum {
     SPR_ADJUSTABLE_VOLTAGE_SUPPLY    = 0x23, /**< SPR Adjustable Voltage Supply */
 } en_supply_type_t;
 
+/**
+ * @typedef stc_pps_status_t
+ * @brief Last PPS_Status received from the source.
+ */
+typedef struct {
+    uint16_t outVolt;                    /**< Output voltage in 20mV units */
+    uint8_t outCur;                      /**< Output current in 50mA units */
+    uint8_t flags;                       /**< Real time flags */
+    bool valid;                          /**< Whether the fields have been received */
+} stc_pps_status_t;
+
+/**
+ * @typedef stc_pps_snk_win_t
+ * @brief PPS voltage window of a sink PPS PDO.
+ */
+typedef struct {
+    uint16_t minVolt;                    /**< Minimum voltage in mV */
+    uint16_t maxVolt;                    /**< Maximum voltage in mV */
+    uint16_t opCur;                      /**< Operating current in mA */
+} stc_pps_snk_win_t;
+
+/**
+ * @typedef stc_pps_snk_cap_t
+ * @brief Sink capabilities of a port as used by the PPS module, rebuilt after
+ * the sink capabilities change or EPR mode is entered or exited.
+ */
+typedef struct {
+    cy_pd_pd_do_t pdo[PPS_SNK_PDO_MAX];  /**< SPR sink PDOs, then the EPR sink PDOs in EPR mode */
+    stc_pps_snk_win_t win[PPS_SNK_PDO_MAX]; /**< Voltage windows of the sink PPS PDOs */
+    uint8_t pdoCnt;                      /**< Number of sink PDOs */
+    uint8_t winCnt;                      /**< Number of voltage windows */
+    bool eprActive;                      /**< EPR mode when the cache was built */
+    bool valid;                          /**< Whether the cache matches the sink capabilities */
+} stc_pps_snk_cap_t;
+
 /******************************************************************************
  * Global function declaration
  ******************************************************************************/
 
 extern void updatePPScontract(int16_t volt, int16_t cur);
+cy_en_pdstack_status_t pps_request_contract(en_supply_type_t supply_type, uint16_t volt, uint16_t cur);
 void pps_timer_cb(cy_timer_id_t id, void *callbackContext);
+void pps_task(void);
+bool pps_is_idle(void);
+uint32_t pps_get_task_cycles(void);
+uint16_t pps_get_cur_limit(cy_stc_pdstack_context_t *context, uint16_t volt);
+void pps_snk_cap_changed(cy_stc_pdstack_context_t *context);
+void pps_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void pps_status_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp, const cy_stc_pdstack_pd_packet_t *pkt);
+const stc_pps_status_t *pps_get_status(void);
+void pps_status_request(uint8_t req, cy_pdstack_dpm_pd_cmd_cbk_t cb);
+void pps_set_charger_identity(cy_stc_pdstack_context_t *context, uint16_t vid, uint16_t pid);
+cy_pd_pd_do_t pps_build_rdo(const cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+                            uint8_t pdo_no, uint16_t volt, uint16_t cur);
 
 #endif /* SRC_PPS_H_ */
@@ -0,0 +1,286 @@
+/*******************************************************************************
+* File Name: profile_store.c
+*
+* Description:
+*  This file contains the flash backed profile store. The charger fingerprint
+*  cache is saved as a log of snapshots, one per flash row, written round robin.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stddef.h>
+#include <string.h>
+#include "profile_store.h"
+#include "charger_cache.h"
+#include "timestamp.h"
+#include "crc16.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+
+#if PROFILE_STORE_ENABLE
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Start address of the flash region reserved for the profile store */
+#define PROFILE_STORE_ADDR                      (CY_FLASH_BASE + CY_FLASH_SIZE - \
+                                                 (PROFILE_STORE_ROW_COUNT * CY_FLASH_SIZEOF_ROW))
+
+/* Marker of a valid snapshot row, changed with the layout of stc_charger_entry_t */
+#define PROFILE_STORE_MAGIC                     (0x5047u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/* Snapshot of the charger cache as stored in one flash row */
+typedef struct {
+    uint16_t magic;                                 /* PROFILE_STORE_MAGIC */
+    uint16_t crc;                                   /* CRC-16 of the fields following this one */
+    uint32_t seq;                                   /* Sequence number, the highest one is the newest snapshot */
+    uint8_t count;                                  /* Number of valid entries */
+    uint8_t reserved[3];
+    stc_charger_entry_t entries[CHARGER_CACHE_SIZE];
+} stc_profile_row_t;
+
+/* A snapshot must fit in one flash row */
+typedef char profile_row_size_check_t[(sizeof(stc_profile_row_t) <= CY_FLASH_SIZEOF_ROW) ? 1 : -1];
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Row write buffer */
+static uint32_t gl_row_buf[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+
+/* Index of the row holding the newest snapshot */
+static uint8_t gl_last_row;
+
+/* Sequence number of the newest snapshot, 0 if the store is empty */
+static uint32_t gl_last_seq;
+
+/* Whether the cache has changed since the last write */
+static volatile bool gl_dirty;
+
+/* Whether a snapshot has been written since reset */
+static bool gl_written;
+
+/* Timestamp of the last write */
+static uint32_t gl_write_ts;
+
+/*******************************************************************************
+* Function Name: row_ptr
+********************************************************************************
+* Summary:
+*  Returns the snapshot stored in a flash row
+*
+* Parameters:
+*  row - Row index in the profile store
+*
+* Return:
+*  stc_profile_row_t - Snapshot as mapped in flash
+*
+*******************************************************************************/
+static const stc_profile_row_t *row_ptr(uint8_t row)
+{
+    return (const stc_profile_row_t *)(PROFILE_STORE_ADDR + ((uint32_t)row * CY_FLASH_SIZEOF_ROW));
+}
+
+/*******************************************************************************
+* Function Name: row_crc
+********************************************************************************
+* Summary:
+*  Calculates the CRC of a snapshot
+*
+* Parameters:
+*  snap - Snapshot
+*
+* Return:
+*  uint16_t - CRC value
+*
+*******************************************************************************/
+static uint16_t row_crc(const stc_profile_row_t *snap)
+{
+    return crc16_update(CRC16_INIT, (const uint8_t *)&snap->seq,
+            sizeof(stc_profile_row_t) - offsetof(stc_profile_row_t, seq));
+}
+
+/*******************************************************************************
+* Function Name: profile_store_init
+********************************************************************************
+* Summary:
+*  Restores the newest valid snapshot into the charger cache. The startup cost
+*  is bounded by one CRC calculation per row of the store.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void profile_store_init(void)
+{
+    const stc_profile_row_t *snap;
+    const stc_profile_row_t *newest = NULL;
+    uint8_t row;
+
+    gl_last_seq = 0u;
+    for (row = 0u; row < PROFILE_STORE_ROW_COUNT; row++)
+    {
+        snap = row_ptr(row);
+        if ((snap->magic == PROFILE_STORE_MAGIC) && (snap->count <= CHARGER_CACHE_SIZE) &&
+            (snap->seq > gl_last_seq) && (snap->crc == row_crc(snap)))
+        {
+            newest = snap;
+            gl_last_row = row;
+            gl_last_seq = snap->seq;
+        }
+    }
+
+    if (newest != NULL)
+    {
+        charger_cache_import(newest->entries, newest->count);
+    }
+    else
+    {
+        /* Start with the first row */
+        gl_last_row = PROFILE_STORE_ROW_COUNT - 1u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: profile_store_mark_dirty
+********************************************************************************
+* Summary:
+*  Requests the charger cache to be saved. The write is deferred to
+*  profile_store_task, which waits for the PD stack to be idle and is rate
+*  limited by PROFILE_STORE_WRITE_INTERVAL, so the changes of a session are
+*  batched into few flash writes.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void profile_store_mark_dirty(void)
+{
+    gl_dirty = true;
+
+    /* The write interval is measured across WDT counter wraps */
+    timestamp_hold(TIMESTAMP_HOLD_STORE, true);
+}
+
+/*******************************************************************************
+* Function Name: profile_store_task
+********************************************************************************
+* Summary:
+*  Writes a pending snapshot to the next flash row. The row write stalls the
+*  CPU for several milliseconds, so it is only done from the main loop while
+*  the DPM is idle between AMSs, so that no sink response timer is running.
+*  Saving does not wait for detach: a sink can hold one contract for days.
+*  A failed write keeps the snapshot pending and is retried after
+*  PROFILE_STORE_WRITE_INTERVAL.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void profile_store_task(cy_stc_pdstack_context_t *context)
+{
+    stc_profile_row_t *snap = (stc_profile_row_t *)gl_row_buf;
+    const stc_profile_row_t *last = row_ptr(gl_last_row);
+    bool dpm_idle = false;
+    uint8_t row;
+
+    if (!gl_dirty)
+    {
+        timestamp_hold(TIMESTAMP_HOLD_STORE, false);
+        return;
+    }
+
+    if (gl_written && ((timestamp_get_ticks() - gl_write_ts) <
+                (PROFILE_STORE_WRITE_INTERVAL * TIMESTAMP_TICKS_PER_MS)))
+    {
+        return;
+    }
+
+    (void)Cy_PdStack_Dpm_IsIdle(context, &dpm_idle);
+    if (!dpm_idle)
+    {
+        return;
+    }
+
+    /* Cleared before the export so that a change made meanwhile is not lost */
+    gl_dirty = false;
+
+    memset(gl_row_buf, 0, sizeof(gl_row_buf));
+    snap->magic = PROFILE_STORE_MAGIC;
+    snap->count = charger_cache_export(snap->entries, CHARGER_CACHE_SIZE);
+
+    /* Skip the write if the newest snapshot already holds the same data */
+    if ((gl_last_seq != 0u) && (last->count == snap->count) &&
+        (memcmp(last->entries, snap->entries, sizeof(snap->entries)) == 0))
+    {
+        return;
+    }
+
+    snap->seq = gl_last_seq + 1u;
+    snap->crc = row_crc(snap);
+
+    row = (uint8_t)((gl_last_row + 1u) % PROFILE_STORE_ROW_COUNT);
+    if (Cy_Flash_WriteRow((uint32_t)row_ptr(row), gl_row_buf) == CY_FLASH_DRV_SUCCESS)
+    {
+        gl_last_row = row;
+        gl_last_seq = snap->seq;
+    }
+    else
+    {
+        gl_dirty = true;
+    }
+
+    gl_written = true;
+    gl_write_ts = timestamp_get_ticks();
+}
+
+#endif /* PROFILE_STORE_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,373 @@
+/*******************************************************************************
+* File Name: sink_fet.c
+*
+* Description:
+*  This file contains the sink FET control layer. The sink enable/disable
+*  callbacks of the PD stack and the consumer FET control go through this layer,
+*  which timestamps every transition and optionally soft-starts the FET in
+*  stages to limit the inrush current.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "sink_fet.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "fault_timeline.h"
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "cy_pdutils_sw_timer.h"
+#include "cy_app_sink.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* FET status of each port */
+static stc_sink_fet_stat_t gl_sink_fet[NO_OF_TYPEC_PORTS];
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/*******************************************************************************
+* Function Name: sink_fet_gpio
+********************************************************************************
+* Summary:
+*  Drives the consumer FET control GPIO of a port
+*
+* Parameters:
+*  port - Port index
+*  on - true to turn the FET on
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sink_fet_gpio(uint8_t port, bool on)
+{
+#if CY_APP_SINK_FET_CTRL_GPIO_EN
+    if (port == 0u)
+    {
+        Cy_GPIO_Write(PFET_SNK_CTRL_P0_PORT, PFET_SNK_CTRL_P0_PIN, on ? 1u : 0u);
+    }
+#if PMG1_PD_DUALPORT_ENABLE
+    else
+    {
+        Cy_GPIO_Write(PFET_SNK_CTRL_P1_PORT, PFET_SNK_CTRL_P1_PIN, on ? 1u : 0u);
+    }
+#endif /* PMG1_PD_DUALPORT_ENABLE */
+#else
+    (void)port;
+    (void)on;
+#endif /* CY_APP_SINK_FET_CTRL_GPIO_EN */
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_mark_on
+********************************************************************************
+* Summary:
+*  Records the FET becoming fully on
+*
+* Parameters:
+*  stat - FET status of the port
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sink_fet_mark_on(stc_sink_fet_stat_t *stat)
+{
+    stat->state = SINK_FET_ON;
+    stat->onTs = timestamp_get_ticks();
+    stat->onLatency = stat->onTs - stat->enableTs;
+    if (stat->onLatency > stat->maxOnLatency)
+    {
+        stat->maxOnLatency = stat->onLatency;
+    }
+    stat->onCnt++;
+}
+
+#if (CY_APP_SINK_FET_CTRL_GPIO_EN && (SINK_FET_SOFT_START_STEPS != 0u))
+/*******************************************************************************
+* Function Name: sink_fet_timer_cb
+********************************************************************************
+* Summary:
+*  Runs the staged soft-start. In step n the FET is pulsed on for n ms and
+*  then off for SINK_FET_SOFT_START_OFF_TIME ms, after the last step the FET
+*  stays on.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sink_fet_timer_cb(cy_timer_id_t id, void *callbackContext)
+{
+    cy_stc_pdstack_context_t *context = (cy_stc_pdstack_context_t *)callbackContext;
+    stc_sink_fet_stat_t *stat = &gl_sink_fet[context->port];
+
+    if (stat->state == SINK_FET_SOFT_START_ON)
+    {
+        sink_fet_gpio(context->port, false);
+        stat->state = SINK_FET_SOFT_START_OFF;
+        Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, callbackContext, id, SINK_FET_SOFT_START_OFF_TIME, sink_fet_timer_cb);
+    }
+    else if (stat->state == SINK_FET_SOFT_START_OFF)
+    {
+        sink_fet_gpio(context->port, true);
+        stat->step++;
+        if (stat->step > SINK_FET_SOFT_START_STEPS)
+        {
+            sink_fet_mark_on(stat);
+        }
+        else
+        {
+            stat->state = SINK_FET_SOFT_START_ON;
+            Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, callbackContext, id, stat->step, sink_fet_timer_cb);
+        }
+    }
+    else
+    {
+        /* Do Nothing */
+    }
+}
+#endif /* (CY_APP_SINK_FET_CTRL_GPIO_EN && (SINK_FET_SOFT_START_STEPS != 0u)) */
+
+/*******************************************************************************
+* Function Name: sink_fet_evt_handler
+********************************************************************************
+* Summary:
+*  Records the completion of each explicit contract, i.e. the reception of
+*  PS_RDY from the source, and releases the latch of sink_fet_latch_off on
+*  detach
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sink_fet_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    if (evt == APP_EVT_DISCONNECT)
+    {
+        gl_sink_fet[ctx->port].latchedOff = false;
+    }
+    else if (app_evt_contract_ok(data))
+    {
+        gl_sink_fet[ctx->port].psRdyTs = timestamp_get_ticks();
+    }
+    else
+    {
+        /* Do Nothing */
+    }
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_enable
+********************************************************************************
+* Summary:
+*  Sink enable callback of the PD stack. Wraps Cy_App_Sink_Enable. Ignored
+*  while the FET is latched off.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sink_fet_enable(cy_stc_pdstack_context_t *context)
+{
+    stc_sink_fet_stat_t *stat = &gl_sink_fet[context->port];
+
+    if (stat->latchedOff)
+    {
+        return;
+    }
+
+    if (stat->state == SINK_FET_OFF)
+    {
+        stat->enableTs = timestamp_get_ticks();
+    }
+
+    Cy_App_Sink_Enable(context);
+
+#if !CY_APP_SINK_FET_CTRL_GPIO_EN
+    /* The FET is driven by the USBPD block and is on once the call returns */
+    if (stat->state == SINK_FET_OFF)
+    {
+        sink_fet_mark_on(stat);
+    }
+#endif /* !CY_APP_SINK_FET_CTRL_GPIO_EN */
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_disable
+********************************************************************************
+* Summary:
+*  Sink disable callback of the PD stack. Wraps Cy_App_Sink_Disable.
+*
+* Parameters:
+*  context - PD Stack Context
+*  snk_discharge_off_handler - Callback invoked once the discharge is complete
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sink_fet_disable(cy_stc_pdstack_context_t *context, cy_pdstack_sink_discharge_off_cbk_t snk_discharge_off_handler)
+{
+    stc_sink_fet_stat_t *stat = &gl_sink_fet[context->port];
+
+    stat->disableTs = timestamp_get_ticks();
+
+    Cy_App_Sink_Disable(context, snk_discharge_off_handler);
+
+#if !CY_APP_SINK_FET_CTRL_GPIO_EN
+    stat->state = SINK_FET_OFF;
+    stat->offTs = timestamp_get_ticks();
+#endif /* !CY_APP_SINK_FET_CTRL_GPIO_EN */
+
+    fault_timeline_mark(FAULT_PHASE_FET_OFF);
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_on
+********************************************************************************
+* Summary:
+*  Turns on the consumer FET, through the staged soft-start when enabled.
+*  Ignored while the FET is latched off.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sink_fet_on(cy_stc_pdstack_context_t *context)
+{
+    stc_sink_fet_stat_t *stat = &gl_sink_fet[context->port];
+
+    if ((stat->state != SINK_FET_OFF) || (stat->latchedOff))
+    {
+        return;
+    }
+
+    sink_fet_gpio(context->port, true);
+
+#if (CY_APP_SINK_FET_CTRL_GPIO_EN && (SINK_FET_SOFT_START_STEPS != 0u))
+    stat->step = 1u;
+    stat->state = SINK_FET_SOFT_START_ON;
+    Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, (void *)context, (cy_timer_id_t)(SINK_FET_TIMER_ID + context->port),
+            stat->step, sink_fet_timer_cb);
+#else
+    sink_fet_mark_on(stat);
+#endif /* (CY_APP_SINK_FET_CTRL_GPIO_EN && (SINK_FET_SOFT_START_STEPS != 0u)) */
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_off
+********************************************************************************
+* Summary:
+*  Turns off the consumer FET and aborts a soft-start in progress
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sink_fet_off(cy_stc_pdstack_context_t *context)
+{
+    stc_sink_fet_stat_t *stat = &gl_sink_fet[context->port];
+
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)(SINK_FET_TIMER_ID + context->port));
+    sink_fet_gpio(context->port, false);
+
+    stat->state = SINK_FET_OFF;
+    stat->offTs = timestamp_get_ticks();
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_latch_off
+********************************************************************************
+* Summary:
+*  Opens the consumer FET through the sink disable path and keeps it open
+*  until the source is detached. Sink enable requests of the PD stack, for
+*  example after the next contract, are ignored in the meantime.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sink_fet_latch_off(cy_stc_pdstack_context_t *context)
+{
+    gl_sink_fet[context->port].latchedOff = true;
+    sink_fet_disable(context, NULL);
+}
+
+/*******************************************************************************
+* Function Name: sink_fet_get_stat
+********************************************************************************
+* Summary:
+*  Returns the FET switching timeline of a port
+*
+* Parameters:
+*  port - Port index
+*
+* Return:
+*  stc_sink_fet_stat_t - FET status
+*
+*******************************************************************************/
+const stc_sink_fet_stat_t *sink_fet_get_stat(uint8_t port)
+{
+    return &gl_sink_fet[port];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* File Name: sink_fet.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  sink FET control layer used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_SINK_FET_H_
+#define SRC_SINK_FET_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_sink_fet_state_t
+ * @brief Sink FET states.
+ */
+typedef enum {
+    SINK_FET_OFF                     = 0, /**< FET off */
+    SINK_FET_SOFT_START_ON,               /**< Soft-start, FET pulsed on */
+    SINK_FET_SOFT_START_OFF,              /**< Soft-start, FET pulsed off */
+    SINK_FET_ON,                          /**< FET fully on */
+} en_sink_fet_state_t;
+
+/**
+ * @typedef stc_sink_fet_stat_t
+ * @brief Sink FET switching timeline of a port. Times are in timestamp ticks.
+ */
+typedef struct {
+    en_sink_fet_state_t state;           /**< Current state */
+    uint8_t step;                        /**< Current soft-start step */
+    uint32_t psRdyTs;                    /**< Last explicit contract completion (PS_RDY received) */
+    uint32_t enableTs;                   /**< Last sink enable request from the stack */
+    uint32_t onTs;                       /**< Last time the FET became fully on */
+    uint32_t disableTs;                  /**< Last sink disable request from the stack */
+    uint32_t offTs;                      /**< Last time the FET was turned off */
+    uint32_t onLatency;                  /**< Enable request to FET fully on, last transition */
+    uint32_t maxOnLatency;               /**< Enable request to FET fully on, worst case */
+    uint32_t onCnt;                      /**< Number of off to on transitions */
+    bool latchedOff;                     /**< FET held off by sink_fet_latch_off until detach */
+} stc_sink_fet_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+void sink_fet_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void sink_fet_enable(cy_stc_pdstack_context_t *context);
+void sink_fet_disable(cy_stc_pdstack_context_t *context, cy_pdstack_sink_discharge_off_cbk_t snk_discharge_off_handler);
+void sink_fet_on(cy_stc_pdstack_context_t *context);
+void sink_fet_off(cy_stc_pdstack_context_t *context);
+void sink_fet_latch_off(cy_stc_pdstack_context_t *context);
+const stc_sink_fet_stat_t *sink_fet_get_stat(uint8_t port);
+
+#endif /* SRC_SINK_FET_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,227 @@
+/*******************************************************************************
+* File Name: sleep_stats.c
+*
+* Description:
+*  This file contains the deep sleep statistics. Every deep sleep attempt of the
+*  main loop goes through sleep_stats_try_sleep, which accounts the time spent
+*  asleep, the wake sources and the reason each refused attempt stayed awake.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "sleep_stats.h"
+#include "timestamp.h"
+#include "pps.h"
+#include "telemetry.h"
+#include "config.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+#include "cy_app.h"
+#include "cy_app_battery_charging.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Wake sources seen since the last deep sleep entry */
+volatile uint8_t gl_sleep_wake_mask;
+
+/* Statistics */
+static stc_sleep_stat_t gl_sleep_stat;
+
+/* Timestamp of the end of the previous attempt */
+static uint32_t gl_sleep_last_ts;
+
+/*******************************************************************************
+* Function Name: sleep_port_block
+********************************************************************************
+* Summary:
+*  Returns the reason a port keeps the device awake
+*
+* Parameters:
+*  context - PD Stack Context, may be NULL
+*
+* Return:
+*  en_sleep_block_t - Reason, SLEEP_BLOCK_COUNT if the port is idle
+*
+*******************************************************************************/
+static en_sleep_block_t sleep_port_block(cy_stc_pdstack_context_t *context)
+{
+    bool dpm_idle = true;
+
+    if (context == NULL)
+    {
+        return SLEEP_BLOCK_COUNT;
+    }
+
+    (void)Cy_PdStack_Dpm_IsIdle(context, &dpm_idle);
+    if (!dpm_idle)
+    {
+        return SLEEP_BLOCK_DPM;
+    }
+
+#if BATTERY_CHARGING_ENABLE
+    if (Cy_App_Bc_GetStatus(context->ptrUsbPdContext)->bc_fsm_state != BC_FSM_OFF)
+    {
+        return SLEEP_BLOCK_BC;
+    }
+#endif /* BATTERY_CHARGING_ENABLE */
+
+    return SLEEP_BLOCK_COUNT;
+}
+
+/*******************************************************************************
+* Function Name: sleep_stats_try_sleep
+********************************************************************************
+* Summary:
+*  Enters deep sleep if nothing keeps the device awake and updates the
+*  statistics. Replaces the direct call of Cy_App_SystemSleep in the main loop.
+*
+* Parameters:
+*  ctx0 - PD Stack Context of port 0
+*  ctx1 - PD Stack Context of port 1, NULL on single port devices
+*
+* Return:
+*  true if the device has been in deep sleep
+*
+*******************************************************************************/
+bool sleep_stats_try_sleep(cy_stc_pdstack_context_t *ctx0, cy_stc_pdstack_context_t *ctx1)
+{
+    uint32_t now = timestamp_get_ticks();
+    uint32_t awake = now - gl_sleep_last_ts;
+    en_sleep_block_t reason = SLEEP_BLOCK_COUNT;
+    uint8_t wake;
+    uint8_t i;
+
+    gl_sleep_stat.awakeTicks += awake;
+
+    if (!pps_is_idle())
+    {
+        reason = SLEEP_BLOCK_PPS;
+    }
+    else if (!telemetry_is_idle())
+    {
+        reason = SLEEP_BLOCK_TELEMETRY;
+    }
+    else
+    {
+        gl_sleep_wake_mask = 0u;
+        if (Cy_App_SystemSleep(ctx0, ctx1))
+        {
+            gl_sleep_last_ts = timestamp_get_ticks();
+            gl_sleep_stat.sleepCnt++;
+            gl_sleep_stat.sleepTicks += gl_sleep_last_ts - now;
+
+            wake = gl_sleep_wake_mask;
+            if (wake == 0u)
+            {
+                gl_sleep_stat.wakeCnt[SLEEP_WAKE_OTHER]++;
+            }
+            for (i = 0u; i < (uint8_t)SLEEP_WAKE_OTHER; i++)
+            {
+                if ((wake & (1u << i)) != 0u)
+                {
+                    gl_sleep_stat.wakeCnt[i]++;
+                }
+            }
+            return true;
+        }
+
+        reason = sleep_port_block(ctx0);
+        if (reason == SLEEP_BLOCK_COUNT)
+        {
+            reason = sleep_port_block(ctx1);
+        }
+        if (reason == SLEEP_BLOCK_COUNT)
+        {
+            reason = SLEEP_BLOCK_OTHER;
+        }
+    }
+
+    gl_sleep_stat.blockCnt[reason]++;
+    gl_sleep_stat.blockTicks[reason] += awake;
+    gl_sleep_last_ts = now;
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: sleep_stats_get
+********************************************************************************
+* Summary:
+*  Copies the deep sleep statistics
+*
+* Parameters:
+*  stats - Destination
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sleep_stats_get(stc_sleep_stat_t *stats)
+{
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    (void)memcpy(stats, &gl_sleep_stat, sizeof(gl_sleep_stat));
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: sleep_stats_clear
+********************************************************************************
+* Summary:
+*  Clears the deep sleep statistics
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void sleep_stats_clear(void)
+{
+    uint32_t intr_state;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    (void)memset(&gl_sleep_stat, 0, sizeof(gl_sleep_stat));
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/* [] END OF FILE */
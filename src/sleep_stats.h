@@ -0,0 +1,121 @@
+/*******************************************************************************
+* File Name: sleep_stats.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  deep sleep statistics used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_SLEEP_STATS_H_
+#define SRC_SLEEP_STATS_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Records an interrupt as a possible wake source. To be placed in the
+ * interrupt handlers that can wake the device from deep sleep.
+ */
+#define SLEEP_STATS_WAKE(src)                   (gl_sleep_wake_mask |= (uint8_t)(1u << (uint8_t)(src)))
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_sleep_block_t
+ * @brief Reasons for staying out of deep sleep.
+ */
+typedef enum {
+    SLEEP_BLOCK_PPS                  = 0, /**< PPS request pending in the main loop */
+    SLEEP_BLOCK_TELEMETRY,                /**< Telemetry data still being transmitted */
+    SLEEP_BLOCK_DPM,                      /**< PD stack busy (AMS in progress) */
+    SLEEP_BLOCK_BC,                       /**< Legacy charging state machine active */
+    SLEEP_BLOCK_OTHER,                    /**< Refused by the application layer, e.g. a soft timer about to expire */
+    SLEEP_BLOCK_COUNT                     /**< Number of reasons */
+} en_sleep_block_t;
+
+/**
+ * @typedef en_sleep_wake_t
+ * @brief Deep sleep wake sources.
+ */
+typedef enum {
+    SLEEP_WAKE_WDT                   = 0, /**< WDT (soft timer) interrupt */
+    SLEEP_WAKE_USBPD0,                    /**< USBPD port 0 interrupt */
+    SLEEP_WAKE_USBPD1,                    /**< USBPD port 1 interrupt */
+    SLEEP_WAKE_SWITCH,                    /**< User switch interrupt */
+    SLEEP_WAKE_OTHER,                     /**< No instrumented interrupt ran */
+    SLEEP_WAKE_COUNT                      /**< Number of wake sources */
+} en_sleep_wake_t;
+
+/**
+ * @typedef stc_sleep_stat_t
+ * @brief Deep sleep statistics. Times are in timestamp ticks.
+ */
+typedef struct {
+    uint32_t sleepCnt;                   /**< Number of deep sleep entries */
+    uint32_t sleepTicks;                 /**< Time spent in deep sleep */
+    uint32_t awakeTicks;                 /**< Time spent awake */
+    uint32_t blockCnt[SLEEP_BLOCK_COUNT];   /**< Sleep refusals per reason */
+    uint32_t blockTicks[SLEEP_BLOCK_COUNT]; /**< Awake time attributed to each reason */
+    uint32_t wakeCnt[SLEEP_WAKE_COUNT];     /**< Wake ups per source */
+} stc_sleep_stat_t;
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+
+/* Wake sources seen since the last deep sleep entry */
+extern volatile uint8_t gl_sleep_wake_mask;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+bool sleep_stats_try_sleep(cy_stc_pdstack_context_t *ctx0, cy_stc_pdstack_context_t *ctx1);
+void sleep_stats_get(stc_sleep_stat_t *stats);
+void sleep_stats_clear(void);
+
+#endif /* SRC_SLEEP_STATS_H_ */
+
+/* [] END OF FILE */
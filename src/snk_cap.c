@@ -0,0 +1,366 @@
+/*******************************************************************************
+* File Name: snk_cap.c
+*
+* Description:
+*  This file contains the batched runtime sink capability updates. PDO and mask
+*  edits are staged in a transaction and applied to the stack in one commit,
+*  which causes at most one renegotiation.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "snk_cap.h"
+#include "pps.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+
+#if SNK_CAP_EDIT_ENABLE
+
+/******************************************************************************
+ * Data struct definition
+ ******************************************************************************/
+/* Staged sink capabilities of a port */
+typedef struct {
+    cy_pd_pd_do_t pdo[CY_PD_MAX_NO_OF_PDO];
+    uint8_t count;
+    uint8_t mask;
+    uint8_t edits;
+    bool open;
+} stc_snk_cap_txn_t;
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Open transaction per port */
+static stc_snk_cap_txn_t gl_snk_cap_txn[NO_OF_TYPEC_PORTS];
+
+/* Set when a committed change still has to be announced to the source */
+static bool gl_snk_cap_reneg_pending[NO_OF_TYPEC_PORTS];
+
+/* Update statistics per port */
+static stc_snk_cap_stat_t gl_snk_cap_stat[NO_OF_TYPEC_PORTS];
+
+/*******************************************************************************
+* Function Name: snk_cap_begin
+********************************************************************************
+* Summary:
+*  Opens a transaction, staging a copy of the current sink capabilities
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  CY_PDSTACK_STAT_SUCCESS, or CY_PDSTACK_STAT_BUSY if a transaction is open
+*
+*******************************************************************************/
+cy_en_pdstack_status_t snk_cap_begin(const cy_stc_pdstack_context_t *context)
+{
+    stc_snk_cap_txn_t *txn = &gl_snk_cap_txn[context->port];
+    uint8_t count = context->dpmStat.curSnkPdocount;
+
+    if (txn->open)
+    {
+        return CY_PDSTACK_STAT_BUSY;
+    }
+
+    if (count > CY_PD_MAX_NO_OF_PDO)
+    {
+        count = CY_PD_MAX_NO_OF_PDO;
+    }
+
+    (void)memcpy(txn->pdo, context->dpmStat.curSnkPdo, count * sizeof(cy_pd_pd_do_t));
+    txn->count = count;
+    txn->mask = context->dpmStat.snkPdoMask;
+    txn->edits = 0u;
+    txn->open = true;
+
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_set_pdo
+********************************************************************************
+* Summary:
+*  Stages a sink PDO. Writing the PDO right after the last one appends it.
+*
+* Parameters:
+*  context - PD Stack Context
+*  index - PDO index, 0 for the vSafe5V PDO
+*  pdo - Sink PDO
+*
+* Return:
+*  CY_PDSTACK_STAT_SUCCESS, CY_PDSTACK_STAT_BAD_PARAM or
+*  CY_PDSTACK_STAT_NOT_READY if no transaction is open
+*
+*******************************************************************************/
+cy_en_pdstack_status_t snk_cap_set_pdo(const cy_stc_pdstack_context_t *context, uint8_t index, cy_pd_pd_do_t pdo)
+{
+    stc_snk_cap_txn_t *txn = &gl_snk_cap_txn[context->port];
+
+    if (!txn->open)
+    {
+        return CY_PDSTACK_STAT_NOT_READY;
+    }
+    if ((index > txn->count) || (index >= CY_PD_MAX_NO_OF_PDO))
+    {
+        return CY_PDSTACK_STAT_BAD_PARAM;
+    }
+
+    txn->pdo[index] = pdo;
+    if (index == txn->count)
+    {
+        txn->count++;
+        txn->mask |= (uint8_t)(1u << index);
+    }
+    txn->edits++;
+
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_set_count
+********************************************************************************
+* Summary:
+*  Stages the number of sink PDOs, dropping the PDOs above it
+*
+* Parameters:
+*  context - PD Stack Context
+*  count - Number of PDOs, at least 1
+*
+* Return:
+*  CY_PDSTACK_STAT_SUCCESS, CY_PDSTACK_STAT_BAD_PARAM or
+*  CY_PDSTACK_STAT_NOT_READY if no transaction is open
+*
+*******************************************************************************/
+cy_en_pdstack_status_t snk_cap_set_count(const cy_stc_pdstack_context_t *context, uint8_t count)
+{
+    stc_snk_cap_txn_t *txn = &gl_snk_cap_txn[context->port];
+
+    if (!txn->open)
+    {
+        return CY_PDSTACK_STAT_NOT_READY;
+    }
+    if ((count == 0u) || (count > txn->count))
+    {
+        return CY_PDSTACK_STAT_BAD_PARAM;
+    }
+
+    txn->count = count;
+    txn->mask &= (uint8_t)((1u << count) - 1u);
+    txn->edits++;
+
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_set_mask
+********************************************************************************
+* Summary:
+*  Stages the mask of enabled sink PDOs
+*
+* Parameters:
+*  context - PD Stack Context
+*  mask - Enabled PDO mask, bit 0 (vSafe5V) is always kept
+*
+* Return:
+*  CY_PDSTACK_STAT_SUCCESS or CY_PDSTACK_STAT_NOT_READY if no transaction is open
+*
+*******************************************************************************/
+cy_en_pdstack_status_t snk_cap_set_mask(const cy_stc_pdstack_context_t *context, uint8_t mask)
+{
+    stc_snk_cap_txn_t *txn = &gl_snk_cap_txn[context->port];
+
+    if (!txn->open)
+    {
+        return CY_PDSTACK_STAT_NOT_READY;
+    }
+
+    txn->mask = mask | 0x01u;
+    txn->edits++;
+
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_commit
+********************************************************************************
+* Summary:
+*  Applies the staged sink capabilities to the stack and closes the
+*  transaction. If they differ from the current ones and a contract is in
+*  place, a single renegotiation is scheduled for snk_cap_task. The cached
+*  PPS sink windows are rebuilt in the same step.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  CY_PDSTACK_STAT_SUCCESS, CY_PDSTACK_STAT_NOT_READY if no transaction is
+*  open, or the stack status if the update is refused
+*
+*******************************************************************************/
+cy_en_pdstack_status_t snk_cap_commit(cy_stc_pdstack_context_t *context)
+{
+    stc_snk_cap_txn_t *txn = &gl_snk_cap_txn[context->port];
+    stc_snk_cap_stat_t *stat = &gl_snk_cap_stat[context->port];
+    cy_en_pdstack_status_t status;
+    bool changed;
+
+    if (!txn->open)
+    {
+        return CY_PDSTACK_STAT_NOT_READY;
+    }
+    txn->open = false;
+
+    stat->edits += txn->edits;
+    stat->commits++;
+
+    changed = (txn->count != context->dpmStat.curSnkPdocount) ||
+              (txn->mask != context->dpmStat.snkPdoMask) ||
+              (memcmp(txn->pdo, context->dpmStat.curSnkPdo, txn->count * sizeof(cy_pd_pd_do_t)) != 0);
+    if (!changed)
+    {
+        stat->avoided += txn->edits;
+        return CY_PDSTACK_STAT_SUCCESS;
+    }
+
+    status = Cy_PdStack_Dpm_UpdateSnkCap(context, txn->count, txn->pdo);
+    if (status == CY_PDSTACK_STAT_SUCCESS)
+    {
+        status = Cy_PdStack_Dpm_UpdateSnkCapMask(context, txn->mask);
+    }
+    if (status != CY_PDSTACK_STAT_SUCCESS)
+    {
+        return status;
+    }
+
+    pps_snk_cap_changed(context);
+
+    if (txn->edits > 1u)
+    {
+        stat->avoided += (uint32_t)txn->edits - 1u;
+    }
+    if (context->dpmConfig.contractExist)
+    {
+        if (gl_snk_cap_reneg_pending[context->port])
+        {
+            /* Folded into the renegotiation still waiting from the previous commit */
+            stat->avoided++;
+        }
+        gl_snk_cap_reneg_pending[context->port] = true;
+    }
+
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_abort
+********************************************************************************
+* Summary:
+*  Closes the transaction without applying the staged edits
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void snk_cap_abort(const cy_stc_pdstack_context_t *context)
+{
+    gl_snk_cap_txn[context->port].open = false;
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_task
+********************************************************************************
+* Summary:
+*  Announces committed sink capability changes to the source. The stack
+*  re-evaluates the source capabilities against the new sink capabilities
+*  and requests a new contract. Must be called from the main loop.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void snk_cap_task(cy_stc_pdstack_context_t *context)
+{
+    if (!gl_snk_cap_reneg_pending[context->port])
+    {
+        return;
+    }
+
+    /* Without a contract the new capabilities are used by the next negotiation */
+    if (!context->dpmConfig.contractExist)
+    {
+        gl_snk_cap_reneg_pending[context->port] = false;
+        return;
+    }
+
+    if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_SNK_CAP_CHNG, NULL, false, NULL) ==
+            CY_PDSTACK_STAT_SUCCESS)
+    {
+        gl_snk_cap_reneg_pending[context->port] = false;
+        gl_snk_cap_stat[context->port].renegotiations++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: snk_cap_get_stat
+********************************************************************************
+* Summary:
+*  Returns the sink capability update statistics of a port
+*
+* Parameters:
+*  port - Port index
+*
+* Return:
+*  const stc_snk_cap_stat_t* - Statistics
+*
+*******************************************************************************/
+const stc_snk_cap_stat_t *snk_cap_get_stat(uint8_t port)
+{
+    return &gl_snk_cap_stat[port];
+}
+
+#endif /* SNK_CAP_EDIT_ENABLE */
+
+/* [] END OF FILE */
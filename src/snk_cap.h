@@ -0,0 +1,87 @@
+/*******************************************************************************
+* File Name: snk_cap.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  batched runtime sink capability updates used in the USB PD Sink PPS Code
+*  example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_SNK_CAP_H_
+#define SRC_SNK_CAP_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef stc_snk_cap_stat_t
+ * @brief Sink capability update statistics of a port.
+ */
+typedef struct {
+    uint32_t edits;                      /**< Staged PDO and mask edits */
+    uint32_t commits;                    /**< Committed transactions */
+    uint32_t renegotiations;             /**< Renegotiations triggered by commits */
+    uint32_t avoided;                    /**< Renegotiations saved by batching the edits */
+} stc_snk_cap_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if SNK_CAP_EDIT_ENABLE
+cy_en_pdstack_status_t snk_cap_begin(const cy_stc_pdstack_context_t *context);
+cy_en_pdstack_status_t snk_cap_set_pdo(const cy_stc_pdstack_context_t *context, uint8_t index, cy_pd_pd_do_t pdo);
+cy_en_pdstack_status_t snk_cap_set_count(const cy_stc_pdstack_context_t *context, uint8_t count);
+cy_en_pdstack_status_t snk_cap_set_mask(const cy_stc_pdstack_context_t *context, uint8_t mask);
+cy_en_pdstack_status_t snk_cap_commit(cy_stc_pdstack_context_t *context);
+void snk_cap_abort(const cy_stc_pdstack_context_t *context);
+void snk_cap_task(cy_stc_pdstack_context_t *context);
+const stc_snk_cap_stat_t *snk_cap_get_stat(uint8_t port);
+#else
+#define snk_cap_task(context)                   ((void)0)
+#endif /* SNK_CAP_EDIT_ENABLE */
+
+#endif /* SRC_SNK_CAP_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,309 @@
+/*******************************************************************************
+* File Name: src_cap_ext.c
+*
+* Description:
+*  This file contains the extended source capabilities cache. The source is
+*  asked for its Source_Capabilities_Extended once per attach and the parsed PDP,
+*  peak current and load step capability are used to bound the requests.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "src_cap_ext.h"
+#include "pps.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_dpm.h"
+
+#if SRC_CAP_EXT_ENABLE
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Parsed extended source capabilities per port */
+static stc_src_cap_ext_t gl_src_cap_ext[NO_OF_TYPEC_PORTS];
+
+/*******************************************************************************
+* Function Name: src_cap_ext_evt_handler
+********************************************************************************
+* Summary:
+*  Drops the cached capabilities on detach
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void src_cap_ext_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)evt;
+    (void)data;
+
+    gl_src_cap_ext[ctx->port].state = SRC_CAP_EXT_IDLE;
+}
+
+/*******************************************************************************
+* Function Name: src_cap_ext_identify
+********************************************************************************
+* Summary:
+*  Passes the outcome of the SCEDB exchange to the charger cache: the VID and
+*  PID of the source, or 0 if it does not support the message
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void src_cap_ext_identify(cy_stc_pdstack_context_t *ctx)
+{
+#if CHARGER_CACHE_ENABLE
+    const stc_src_cap_ext_t *ext = &gl_src_cap_ext[ctx->port];
+
+    if (ctx->port == 0u)
+    {
+        if (ext->state == SRC_CAP_EXT_VALID)
+        {
+            pps_set_charger_identity(ctx, ext->vid, ext->pid);
+        }
+        else
+        {
+            pps_set_charger_identity(ctx, 0u, 0u);
+        }
+    }
+#else
+    (void)ctx;
+#endif /* CHARGER_CACHE_ENABLE */
+}
+
+/*******************************************************************************
+* Function Name: src_cap_ext_cb
+********************************************************************************
+* Summary:
+*  Response callback for the Get_Source_Cap_Extended command. Parses the
+*  Source_Capabilities_Extended data block. Any other outcome marks the
+*  source as not supporting the message so that it is not asked again.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  resp - Response status
+*  pkt - Received packet
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void src_cap_ext_cb(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_resp_status_t resp,
+        const cy_stc_pdstack_pd_packet_t *pkt)
+{
+    stc_src_cap_ext_t *ext = &gl_src_cap_ext[ctx->port];
+    const uint8_t *scedb;
+
+    if (ext->state != SRC_CAP_EXT_PENDING)
+    {
+        return;
+    }
+
+    ext->cost = timestamp_get_ticks() - ext->reqTs;
+
+    if ((resp != CY_PDSTACK_RES_RCVD) || (pkt == NULL) || (!pkt->hdr.hdr.extd) ||
+        (pkt->hdr.hdr.dataSize < SRC_CAP_EXT_SCEDB_SIZE))
+    {
+        ext->state = SRC_CAP_EXT_NOT_SUPP;
+        src_cap_ext_identify(ctx);
+        return;
+    }
+
+    /*
+     * SCEDB: VID (0-1), PID (2-3), XID (4-7), FW/HW version (8-9), voltage
+     * regulation (10), holdup time (11), compliance (12), touch current (13),
+     * peak current 1..3 (14-19), touch temp (20), source inputs (21),
+     * batteries (22), SPR PDP (23), EPR PDP (24, PD 3.1 only).
+     */
+    scedb = (const uint8_t *)&pkt->dat[0];
+    ext->vid = (uint16_t)scedb[0] | ((uint16_t)scedb[1] << 8u);
+    ext->pid = (uint16_t)scedb[2] | ((uint16_t)scedb[3] << 8u);
+    ext->voltReg = scedb[10];
+    ext->peakCur = (uint16_t)scedb[14] | ((uint16_t)scedb[15] << 8u);
+    ext->pdp = scedb[23];
+    ext->eprPdp = (pkt->hdr.hdr.dataSize > SRC_CAP_EXT_SCEDB_SIZE) ? scedb[24] : 0u;
+    ext->state = SRC_CAP_EXT_VALID;
+    src_cap_ext_identify(ctx);
+}
+
+/*******************************************************************************
+* Function Name: src_cap_ext_task
+********************************************************************************
+* Summary:
+*  Sends Get_Source_Cap_Extended once per attach after the first explicit PD
+*  3.0 contract. Must be called from the main loop.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void src_cap_ext_task(cy_stc_pdstack_context_t *context)
+{
+    stc_src_cap_ext_t *ext = &gl_src_cap_ext[context->port];
+
+    if ((ext->state != SRC_CAP_EXT_IDLE) || !context->dpmConfig.contractExist)
+    {
+        return;
+    }
+
+    if (context->dpmConfig.specRevSopLive < CY_PD_REV3)
+    {
+        ext->state = SRC_CAP_EXT_NOT_SUPP;
+        src_cap_ext_identify(context);
+        return;
+    }
+
+    ext->reqTs = timestamp_get_ticks();
+    ext->state = SRC_CAP_EXT_PENDING;
+    if (Cy_PdStack_Dpm_SendPdCommand(context, CY_PDSTACK_DPM_CMD_GET_SRC_CAP_EXTENDED, NULL, false,
+            src_cap_ext_cb) != CY_PDSTACK_STAT_SUCCESS)
+    {
+        /* Stack busy, retry from the next main loop iteration */
+        ext->state = SRC_CAP_EXT_IDLE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: src_cap_ext_get
+********************************************************************************
+* Summary:
+*  Returns the cached extended source capabilities of a port
+*
+* Parameters:
+*  port - Port index
+*
+* Return:
+*  const stc_src_cap_ext_t* - Cached capabilities, valid if state is SRC_CAP_EXT_VALID
+*
+*******************************************************************************/
+const stc_src_cap_ext_t *src_cap_ext_get(uint8_t port)
+{
+    return &gl_src_cap_ext[port];
+}
+
+/*******************************************************************************
+* Function Name: src_cap_ext_get_max_cur
+********************************************************************************
+* Summary:
+*  Returns the highest current the source can sustain at a voltage given its
+*  PDP. A source without overload capability (peak current equal to IoC) is
+*  derated by SRC_CAP_EXT_NO_PEAK_DERATE so that load transients stay below
+*  its protection.
+*
+* Parameters:
+*  context - PD Stack Context
+*  volt - Voltage in mV
+*
+* Return:
+*  uint16_t - Current in mA, 0xFFFF if the PDP is not known
+*
+*******************************************************************************/
+uint16_t src_cap_ext_get_max_cur(const cy_stc_pdstack_context_t *context, uint16_t volt)
+{
+    const stc_src_cap_ext_t *ext = &gl_src_cap_ext[context->port];
+    uint32_t pdp;
+    uint32_t cur;
+
+    if ((ext->state != SRC_CAP_EXT_VALID) || (ext->pdp == 0u) || (volt == 0u))
+    {
+        return 0xFFFFu;
+    }
+
+    pdp = ext->pdp;
+#if CY_PD_EPR_ENABLE
+    if ((context->dpmExtStat.eprActive) && (ext->eprPdp != 0u))
+    {
+        pdp = ext->eprPdp;
+    }
+#endif /* CY_PD_EPR_ENABLE */
+
+    /* PDP in mW */
+    pdp *= 1000u;
+    if ((ext->peakCur & SRC_CAP_EXT_PEAK_OVERLOAD_MASK) == 0u)
+    {
+        pdp -= (pdp * SRC_CAP_EXT_NO_PEAK_DERATE) / 100u;
+    }
+
+    cur = (pdp * 1000u) / volt;
+
+    return (cur < 0xFFFFu) ? (uint16_t)cur : 0xFFFFu;
+}
+
+/*******************************************************************************
+* Function Name: src_cap_ext_get_load_step
+********************************************************************************
+* Summary:
+*  Returns the largest load step, in percent of the operating current, the
+*  source can regulate through
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  uint8_t - 25 or 90, 100 if not known
+*
+*******************************************************************************/
+uint8_t src_cap_ext_get_load_step(const cy_stc_pdstack_context_t *context)
+{
+    const stc_src_cap_ext_t *ext = &gl_src_cap_ext[context->port];
+
+    if (ext->state != SRC_CAP_EXT_VALID)
+    {
+        return 100u;
+    }
+
+    return ((ext->voltReg & SRC_CAP_EXT_LOAD_STEP_90_MASK) != 0u) ? 90u : 25u;
+}
+
+#endif /* SRC_CAP_EXT_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,120 @@
+/*******************************************************************************
+* File Name: src_cap_ext.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  extended source capabilities cache used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_SRC_CAP_EXT_H_
+#define SRC_SRC_CAP_EXT_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Minimum size of the Source_Capabilities_Extended data block (PD 3.0).
+ */
+#define SRC_CAP_EXT_SCEDB_SIZE                  (24u)
+
+/*
+ * Voltage regulation field: load step magnitude bit (0: 25%, 1: 90% of IoC).
+ */
+#define SRC_CAP_EXT_LOAD_STEP_90_MASK           (0x04u)
+
+/*
+ * Peak current field: overload current in 10% increments of IoC.
+ */
+#define SRC_CAP_EXT_PEAK_OVERLOAD_MASK          (0x1Fu)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_src_cap_ext_state_t
+ * @brief Extended source capabilities cache states.
+ */
+typedef enum {
+    SRC_CAP_EXT_IDLE                 = 0, /**< Not requested yet on this attach */
+    SRC_CAP_EXT_PENDING,                  /**< Get_Source_Cap_Extended sent */
+    SRC_CAP_EXT_VALID,                    /**< Capabilities received and parsed */
+    SRC_CAP_EXT_NOT_SUPP,                 /**< Not supported by the source or no response */
+} en_src_cap_ext_state_t;
+
+/**
+ * @typedef stc_src_cap_ext_t
+ * @brief Parsed Source_Capabilities_Extended of a port.
+ */
+typedef struct {
+    en_src_cap_ext_state_t state;        /**< Cache state */
+    uint16_t vid;                        /**< Vendor ID */
+    uint16_t pid;                        /**< Product ID */
+    uint8_t voltReg;                     /**< Voltage regulation (load step) field */
+    uint8_t pdp;                         /**< SPR source PDP in W */
+    uint8_t eprPdp;                      /**< EPR source PDP in W, 0 if not reported */
+    uint16_t peakCur;                    /**< Peak current 1 field */
+    uint32_t reqTs;                      /**< Request time in timestamp ticks */
+    uint32_t cost;                       /**< Request to response time in timestamp ticks */
+} stc_src_cap_ext_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if SRC_CAP_EXT_ENABLE
+void src_cap_ext_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void src_cap_ext_task(cy_stc_pdstack_context_t *context);
+const stc_src_cap_ext_t *src_cap_ext_get(uint8_t port);
+uint16_t src_cap_ext_get_max_cur(const cy_stc_pdstack_context_t *context, uint16_t volt);
+uint8_t src_cap_ext_get_load_step(const cy_stc_pdstack_context_t *context);
+#else
+#define src_cap_ext_task(context)               ((void)0)
+#define src_cap_ext_get_max_cur(context, volt)  (0xFFFFu)
+#define src_cap_ext_get_load_step(context)      (100u)
+#endif /* SRC_CAP_EXT_ENABLE */
+
+#endif /* SRC_SRC_CAP_EXT_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,388 @@
+/*******************************************************************************
+* File Name: telemetry.c
+*
+* Description:
+*  This file contains the UART telemetry link. Frames are queued into a RAM
+*  transmit ring with a single copy and drained into the SCB TX FIFO from the
+*  FIFO level interrupt, so the main loop never waits for the UART.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <string.h>
+#include "telemetry.h"
+#include "timestamp.h"
+#include "crc16.h"
+#include "pps.h"
+#include "vbus_meas.h"
+#include "cy_pdl.h"
+#include "cycfg.h"
+#include "cy_app.h"
+
+#if TELEMETRY_ENABLE
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+#if ((TELEMETRY_RING_SIZE & (TELEMETRY_RING_SIZE - 1u)) != 0u)
+#error "TELEMETRY_RING_SIZE must be a power of 2"
+#endif
+
+#define TELEMETRY_RING_MASK                     (TELEMETRY_RING_SIZE - 1u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Transmit ring. The head is only written by telemetry_send, the tail only by the ISR. */
+static uint8_t gl_tlm_ring[TELEMETRY_RING_SIZE];
+static volatile uint16_t gl_tlm_head;
+static volatile uint16_t gl_tlm_tail;
+
+/* Link statistics */
+static stc_telemetry_stat_t gl_tlm_stat;
+
+/* Timestamp of the last periodic report */
+static uint32_t gl_tlm_report_ts;
+
+/* Last contract and PPS status reported */
+static uint32_t gl_tlm_contract;
+static uint32_t gl_tlm_pps;
+
+/* UART context */
+static cy_stc_scb_uart_context_t gl_tlm_uart_ctx;
+
+/* UART interrupt configuration */
+static const cy_stc_sysint_t gl_tlm_intr_config =
+{
+    .intrSrc = CYBSP_UART_IRQ,
+    .intrPriority = TELEMETRY_INTR_PRIORITY,
+};
+
+/*******************************************************************************
+* Function Name: telemetry_uart_isr
+********************************************************************************
+* Summary:
+*  Moves data from the transmit ring into the TX FIFO. The FIFO level interrupt
+*  is masked once the ring is empty.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void telemetry_uart_isr(void)
+{
+    uint16_t tail = gl_tlm_tail;
+    uint16_t head = gl_tlm_head;
+    uint32_t len;
+    uint32_t sent;
+
+    while (tail != head)
+    {
+        /* Contiguous part of the pending data */
+        len = (head > tail) ? (uint32_t)(head - tail) : (uint32_t)(TELEMETRY_RING_SIZE - tail);
+        sent = Cy_SCB_UART_PutArray(CYBSP_UART_HW, &gl_tlm_ring[tail], len);
+        gl_tlm_stat.bytesSent += sent;
+        tail = (uint16_t)((tail + sent) & TELEMETRY_RING_MASK);
+        if (sent < len)
+        {
+            break;
+        }
+    }
+    gl_tlm_tail = tail;
+
+    if (tail == head)
+    {
+        Cy_SCB_SetTxInterruptMask(CYBSP_UART_HW, 0u);
+    }
+    Cy_SCB_ClearTxInterrupt(CYBSP_UART_HW, CY_SCB_TX_INTR_LEVEL);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_ring_put
+********************************************************************************
+* Summary:
+*  Copies data into the transmit ring. The caller checks for space.
+*
+* Parameters:
+*  head - Ring write position
+*  data - Data
+*  len - Number of bytes
+*
+* Return:
+*  uint16_t - New ring write position
+*
+*******************************************************************************/
+static uint16_t telemetry_ring_put(uint16_t head, const uint8_t *data, uint16_t len)
+{
+    uint16_t first = (uint16_t)(TELEMETRY_RING_SIZE - head);
+
+    if (first > len)
+    {
+        first = len;
+    }
+    (void)memcpy(&gl_tlm_ring[head], data, first);
+    (void)memcpy(&gl_tlm_ring[0], &data[first], (uint32_t)len - first);
+
+    return (uint16_t)((head + len) & TELEMETRY_RING_MASK);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_init
+********************************************************************************
+* Summary:
+*  Initializes the UART and its interrupt. The TX FIFO level interrupt is only
+*  unmasked while the transmit ring holds data.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void telemetry_init(void)
+{
+    (void)Cy_SCB_UART_Init(CYBSP_UART_HW, &CYBSP_UART_config, &gl_tlm_uart_ctx);
+    Cy_SCB_SetTxInterruptMask(CYBSP_UART_HW, 0u);
+    Cy_SysInt_Init(&gl_tlm_intr_config, &telemetry_uart_isr);
+    NVIC_EnableIRQ(gl_tlm_intr_config.intrSrc);
+    Cy_SCB_UART_Enable(CYBSP_UART_HW);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_send
+********************************************************************************
+* Summary:
+*  Queues a frame for transmission. The frame is dropped as a whole if the
+*  transmit ring does not have room for it. Must only be called from the main
+*  loop, the ring has a single producer.
+*
+* Parameters:
+*  type - Frame type
+*  payload - Payload
+*  len - Payload length, up to TELEMETRY_MAX_PAYLOAD
+*
+* Return:
+*  true if the frame was queued
+*
+*******************************************************************************/
+bool telemetry_send(en_telemetry_frame_t type, const uint8_t *payload, uint8_t len)
+{
+    uint8_t frame[TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD];
+    uint32_t start = timestamp_get_cycles();
+    uint32_t cycles;
+    uint16_t size = (uint16_t)len + TELEMETRY_FRAME_OVERHEAD;
+    uint16_t head = gl_tlm_head;
+    uint16_t crc;
+
+    if (len > TELEMETRY_MAX_PAYLOAD)
+    {
+        return false;
+    }
+
+    /* One byte of the ring is kept free to tell a full ring from an empty one */
+    if (((gl_tlm_tail - head - 1u) & TELEMETRY_RING_MASK) < size)
+    {
+        gl_tlm_stat.framesDropped++;
+        return false;
+    }
+
+    frame[0] = TELEMETRY_SYNC;
+    frame[1] = len;
+    frame[2] = (uint8_t)type;
+    (void)memcpy(&frame[3], payload, len);
+    crc = crc16_update(CRC16_INIT, &frame[1], (uint32_t)len + 2u);
+    frame[3u + len] = (uint8_t)crc;
+    frame[4u + len] = (uint8_t)(crc >> 8u);
+
+    gl_tlm_head = telemetry_ring_put(head, frame, size);
+    gl_tlm_stat.bytesQueued += size;
+
+    Cy_SCB_SetTxInterruptMask(CYBSP_UART_HW, CY_SCB_TX_INTR_LEVEL);
+
+    cycles = TIMESTAMP_CYCLES_DELTA(start, timestamp_get_cycles());
+    if (cycles > gl_tlm_stat.maxSendCycles)
+    {
+        gl_tlm_stat.maxSendCycles = cycles;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: telemetry_put16
+********************************************************************************
+* Summary:
+*  Stores a 16-bit value LSB first
+*
+* Parameters:
+*  buf - Destination
+*  val - Value
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void telemetry_put16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = (uint8_t)val;
+    buf[1] = (uint8_t)(val >> 8u);
+}
+
+/*******************************************************************************
+* Function Name: telemetry_task
+********************************************************************************
+* Summary:
+*  Reports the contract and PPS status when they change and VBUS every
+*  TELEMETRY_PERIOD. Must be called from the main loop.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void telemetry_task(cy_stc_pdstack_context_t *context)
+{
+    const stc_pps_status_t *status = pps_get_status();
+    uint8_t buf[12];
+    uint32_t now = timestamp_get_ticks();
+    uint32_t val;
+
+    val = context->dpmConfig.contractExist ?
+        (uint32_t)context->dpmStat.contract.curPwr | ((uint32_t)context->dpmStat.contract.maxVolt << 16u) : 0u;
+    if (val != gl_tlm_contract)
+    {
+        buf[0] = context->port;
+        buf[1] = (uint8_t)context->dpmStat.snkRdo.rdo_gen.objPos;
+        buf[2] = (uint8_t)context->dpmStat.srcSelPdo.fixed_src.supplyType;
+        telemetry_put16(&buf[3], (uint16_t)(val >> 16u));
+        telemetry_put16(&buf[5], (uint16_t)((val & 0xFFFFu) * 10u));
+        if (telemetry_send(TELEMETRY_FRAME_CONTRACT, buf, 7u))
+        {
+            gl_tlm_contract = val;
+        }
+    }
+
+    val = status->valid ? ((uint32_t)status->outVolt | ((uint32_t)status->outCur << 16u) |
+        ((uint32_t)status->flags << 24u)) : 0u;
+    if (val != gl_tlm_pps)
+    {
+        telemetry_put16(&buf[0], status->outVolt);
+        buf[2] = status->outCur;
+        buf[3] = status->flags;
+        if (telemetry_send(TELEMETRY_FRAME_PPS_STATUS, buf, 4u))
+        {
+            gl_tlm_pps = val;
+        }
+    }
+
+    if ((now - gl_tlm_report_ts) >= (TELEMETRY_PERIOD * TIMESTAMP_TICKS_PER_MS))
+    {
+        gl_tlm_report_ts = now;
+#if VBUS_MEAS_ENABLE
+        {
+            const stc_vbus_meas_t *meas = vbus_meas_get();
+
+            buf[0] = (uint8_t)meas->timestamp;
+            buf[1] = (uint8_t)(meas->timestamp >> 8u);
+            buf[2] = (uint8_t)(meas->timestamp >> 16u);
+            buf[3] = (uint8_t)(meas->timestamp >> 24u);
+            telemetry_put16(&buf[4], meas->volt);
+            telemetry_put16(&buf[6], meas->minVolt);
+            telemetry_put16(&buf[8], meas->maxVolt);
+        }
+#else
+        val = Cy_App_VbusGetValue(context);
+        buf[0] = (uint8_t)now;
+        buf[1] = (uint8_t)(now >> 8u);
+        buf[2] = (uint8_t)(now >> 16u);
+        buf[3] = (uint8_t)(now >> 24u);
+        telemetry_put16(&buf[4], (uint16_t)val);
+        telemetry_put16(&buf[6], (uint16_t)val);
+        telemetry_put16(&buf[8], (uint16_t)val);
+#endif /* VBUS_MEAS_ENABLE */
+        (void)telemetry_send(TELEMETRY_FRAME_VBUS, buf, 10u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: telemetry_is_idle
+********************************************************************************
+* Summary:
+*  Checks whether all queued data has left the UART. The SCB does not run in
+*  deep sleep, so the device must stay active until then.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if there is nothing left to transmit
+*
+*******************************************************************************/
+bool telemetry_is_idle(void)
+{
+    return ((gl_tlm_head == gl_tlm_tail) && Cy_SCB_UART_IsTxComplete(CYBSP_UART_HW));
+}
+
+/*******************************************************************************
+* Function Name: telemetry_get_stat
+********************************************************************************
+* Summary:
+*  Returns the link statistics. The sustained rate is the change of bytesSent
+*  between two reads divided by the time between them.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_telemetry_stat_t - Link statistics
+*
+*******************************************************************************/
+const stc_telemetry_stat_t *telemetry_get_stat(void)
+{
+    return &gl_tlm_stat;
+}
+
+#endif /* TELEMETRY_ENABLE */
+
+/* [] END OF FILE */
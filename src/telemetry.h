@@ -0,0 +1,115 @@
+/*******************************************************************************
+* File Name: telemetry.h
+*
+* Description:
+*  This file contains the frame definitions and function prototypes of the
+*  UART telemetry link used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_TELEMETRY_H_
+#define SRC_TELEMETRY_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Frame layout: sync byte, payload length, frame type, payload, CRC-16 (LSB
+ * first). The CRC covers the length, type and payload bytes.
+ */
+#define TELEMETRY_SYNC                          (0xA5u)
+
+/*
+ * Largest payload carried by a frame.
+ */
+#define TELEMETRY_MAX_PAYLOAD                   (32u)
+
+/*
+ * Bytes added to the payload by the frame header and CRC.
+ */
+#define TELEMETRY_FRAME_OVERHEAD                (5u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_telemetry_frame_t
+ * @brief Telemetry frame types.
+ */
+typedef enum {
+    TELEMETRY_FRAME_CONTRACT         = 1, /**< Port, supply type, object position, voltage (mV), current (mA) */
+    TELEMETRY_FRAME_VBUS             = 2, /**< Timestamp, filtered, minimum and maximum VBUS (mV) */
+    TELEMETRY_FRAME_PPS_STATUS       = 3, /**< Output voltage (20mV), output current (50mA), real time flags */
+} en_telemetry_frame_t;
+
+/**
+ * @typedef stc_telemetry_stat_t
+ * @brief Telemetry link statistics.
+ */
+typedef struct {
+    uint32_t bytesQueued;                /**< Bytes written into the transmit ring */
+    uint32_t bytesSent;                  /**< Bytes moved from the ring into the UART FIFO */
+    uint32_t framesDropped;              /**< Frames dropped because the ring was full */
+    uint32_t maxSendCycles;              /**< Longest time spent queuing a frame, in CPU cycles */
+} stc_telemetry_stat_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if TELEMETRY_ENABLE
+void telemetry_init(void);
+bool telemetry_send(en_telemetry_frame_t type, const uint8_t *payload, uint8_t len);
+void telemetry_task(cy_stc_pdstack_context_t *context);
+bool telemetry_is_idle(void);
+const stc_telemetry_stat_t *telemetry_get_stat(void);
+#else
+#define telemetry_init()                        ((void)0)
+#define telemetry_task(context)                 ((void)0)
+#define telemetry_is_idle()                     (true)
+#endif /* TELEMETRY_ENABLE */
+
+#endif /* SRC_TELEMETRY_H_ */
+
+/* [] END OF FILE */
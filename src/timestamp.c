@@ -0,0 +1,278 @@
+/*******************************************************************************
+* File Name: timestamp.c
+*
+* Description:
+*  This file contains the functions of the timestamp module. It extends the
+*  16-bit WDT counter to a 32-bit tick count which keeps running in deep sleep.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdutils_sw_timer.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+#if ((TIMESTAMP_REFRESH_PERIOD * TIMESTAMP_TICKS_PER_MS) >= 0x10000u)
+#error "TIMESTAMP_REFRESH_PERIOD must be shorter than the WDT counter wrap"
+#endif
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Extended tick count */
+static uint32_t gl_ts_ticks;
+
+/* WDT counter value at the time of the previous read */
+static uint16_t gl_ts_last_cnt;
+
+/* Holders of the refresh timer, one bit per TIMESTAMP_HOLD_* */
+static volatile uint8_t gl_ts_holders;
+
+/* Whether the refresh timer is running */
+static volatile bool gl_ts_timer_on;
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/*******************************************************************************
+* Function Name: timestamp_timer_cb
+********************************************************************************
+* Summary:
+*  Extends the timestamp at least once per WDT counter wrap, as long as the
+*  timer is held
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - Not used
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void timestamp_timer_cb(cy_timer_id_t id, void *callbackContext)
+{
+    (void)timestamp_get_ticks();
+    if (gl_ts_holders != 0u)
+    {
+        Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, callbackContext, id, TIMESTAMP_REFRESH_PERIOD, timestamp_timer_cb);
+    }
+    else
+    {
+        gl_ts_timer_on = false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: timestamp_init
+********************************************************************************
+* Summary:
+*  Initializes the timestamp. The refresh timer is only started once a holder
+*  needs it, see timestamp_hold.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timestamp_init(void)
+{
+    gl_ts_holders = 0u;
+    gl_ts_timer_on = false;
+    (void)timestamp_get_ticks();
+}
+
+/*******************************************************************************
+* Function Name: timestamp_hold
+********************************************************************************
+* Summary:
+*  Keeps the timestamp refresh timer running while at least one holder needs
+*  intervals beyond the WDT counter wrap to be measured. The WDT interrupt
+*  reads the timestamp on every soft timer expiry, but with the other timers
+*  stopped or running at periods beyond the counter wrap (such as
+*  PPS_REQ_TIMER) the wrap would go unnoticed. Without a holder, the timer is
+*  stopped at its next expiry so that it does not wake the device from deep
+*  sleep, and intervals are only exact up to the counter wrap.
+*
+* Parameters:
+*  holder - TIMESTAMP_HOLD_*
+*  hold - true to hold the timer, false to release it
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timestamp_hold(uint8_t holder, bool hold)
+{
+    uint32_t intr_state;
+    bool start = false;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+    if (hold)
+    {
+        gl_ts_holders |= (uint8_t)(1u << holder);
+        start = !gl_ts_timer_on;
+        gl_ts_timer_on = true;
+    }
+    else
+    {
+        gl_ts_holders &= (uint8_t)~(1u << holder);
+    }
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (start)
+    {
+        (void)timestamp_get_ticks();
+        Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, NULL, (cy_timer_id_t)TIMESTAMP_TIMER_ID,
+                TIMESTAMP_REFRESH_PERIOD, timestamp_timer_cb);
+    }
+}
+
+/*******************************************************************************
+* Function Name: timestamp_evt_handler
+********************************************************************************
+* Summary:
+*  Holds the refresh timer while a port is attached
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timestamp_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)data;
+
+    if (evt == APP_EVT_CONNECT)
+    {
+        timestamp_hold(TIMESTAMP_HOLD_PORT0 + ctx->port, true);
+    }
+    else if (evt == APP_EVT_DISCONNECT)
+    {
+        timestamp_hold(TIMESTAMP_HOLD_PORT0 + ctx->port, false);
+    }
+    else
+    {
+        /* Not subscribed */
+    }
+}
+
+/*******************************************************************************
+* Function Name: timestamp_get_ticks
+********************************************************************************
+* Summary:
+*  Returns the current timestamp in WDT ticks. The 16-bit WDT counter is
+*  extended in software, which requires this function to be called at least
+*  once per counter wrap (about 1.6 s). This is ensured by the refresh timer
+*  while it is held, see timestamp_hold.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Timestamp in ticks, see TIMESTAMP_TICKS_PER_MS
+*
+*******************************************************************************/
+uint32_t timestamp_get_ticks(void)
+{
+    uint32_t intr_state;
+    uint32_t ticks;
+    uint16_t cnt;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    cnt = (uint16_t)Cy_WDT_GetCount();
+    gl_ts_ticks += (uint16_t)(cnt - gl_ts_last_cnt);
+    gl_ts_last_cnt = cnt;
+    ticks = gl_ts_ticks;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    return ticks;
+}
+
+/*******************************************************************************
+* Function Name: timestamp_cycles_init
+********************************************************************************
+* Summary:
+*  Starts SysTick as a free running 24-bit CPU cycle counter. The SysTick
+*  interrupt is not used. The counter does not run in deep sleep and is only
+*  meant for measuring short code sections.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void timestamp_cycles_init(void)
+{
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0u;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+/*******************************************************************************
+* Function Name: timestamp_get_cycles
+********************************************************************************
+* Summary:
+*  Returns the CPU cycle counter. Use TIMESTAMP_CYCLES_DELTA to compute the
+*  number of cycles between two readings.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Up counting 24-bit cycle count
+*
+*******************************************************************************/
+uint32_t timestamp_get_cycles(void)
+{
+    return (SysTick_LOAD_RELOAD_Msk - SysTick->VAL);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,90 @@
+/*******************************************************************************
+* File Name: timestamp.h
+*
+* Description:
+*  This file contains the function prototypes of the timestamp module used in
+*  the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_TIMESTAMP_H_
+#define SRC_TIMESTAMP_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Converts a timestamp tick delta to milliseconds.
+ */
+#define TIMESTAMP_TICKS_TO_MS(ticks)            ((uint32_t)(ticks) / TIMESTAMP_TICKS_PER_MS)
+
+/*
+ * Holders of the timestamp refresh timer, see timestamp_hold. The port
+ * holders are indexed by the port number.
+ */
+#define TIMESTAMP_HOLD_PORT0                    (0u)
+#define TIMESTAMP_HOLD_PORT1                    (1u)
+#define TIMESTAMP_HOLD_BOOT                     (2u)
+#define TIMESTAMP_HOLD_STORE                    (3u)
+
+/*
+ * Number of CPU cycles between two cycle counter readings. The counter is
+ * 24 bits wide, so only intervals below 2^24 cycles can be measured.
+ */
+#define TIMESTAMP_CYCLES_DELTA(start, end)      (((end) - (start)) & 0x00FFFFFFu)
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+void timestamp_init(void);
+void timestamp_hold(uint8_t holder, bool hold);
+void timestamp_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+uint32_t timestamp_get_ticks(void);
+void timestamp_cycles_init(void);
+uint32_t timestamp_get_cycles(void);
+
+#endif /* SRC_TIMESTAMP_H_ */
+
+/* [] END OF FILE */
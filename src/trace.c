@@ -0,0 +1,206 @@
+/*******************************************************************************
+* File Name: trace.c
+*
+* Description:
+*  This file contains the binary event trace. Records are stored unformatted in
+*  a RAM ring buffer and decoded off target from a memory dump.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "trace.h"
+#include "timestamp.h"
+#include "app_evt.h"
+#include "cy_pdl.h"
+#include "cy_pdstack_common.h"
+
+#if TRACE_ENABLE
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+#if ((TRACE_BUF_DEPTH & (TRACE_BUF_DEPTH - 1u)) != 0u)
+#error "TRACE_BUF_DEPTH must be a power of 2"
+#endif
+
+#define TRACE_IDX_MASK                          (TRACE_BUF_DEPTH - 1u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Trace ring buffer */
+static stc_trace_log_t gl_trace_log =
+{
+    .magic = TRACE_LOG_MAGIC,
+    .depth = TRACE_BUF_DEPTH,
+    .recSize = sizeof(stc_trace_record_t),
+    .count = 0u
+};
+
+/*******************************************************************************
+* Function Name: trace_evt_handler
+********************************************************************************
+* Summary:
+*  Records connection state changes and faults reported by the PD stack and
+*  the instrumentation
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trace_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    en_trace_evt_t id = TRACE_EVT_FAULT;
+
+    (void)data;
+
+    if ((evt == APP_EVT_CONNECT) || (evt == APP_EVT_DISCONNECT) ||
+        (evt == APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE))
+    {
+        id = TRACE_EVT_PD_EVENT;
+    }
+
+    trace_log(id, ctx->port, (uint16_t)evt, 0u);
+}
+
+/*******************************************************************************
+* Function Name: trace_log
+********************************************************************************
+* Summary:
+*  Appends a record to the trace ring buffer, overwriting the oldest record
+*  when the buffer is full. Can be called from interrupt context.
+*
+* Parameters:
+*  id - Event ID
+*  port - PD port index
+*  arg0 - First event argument
+*  arg1 - Second event argument
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trace_log(en_trace_evt_t id, uint8_t port, uint16_t arg0, uint32_t arg1)
+{
+    uint32_t intr_state;
+    stc_trace_record_t *rec;
+    uint32_t ts = timestamp_get_ticks();
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    rec = &gl_trace_log.rec[gl_trace_log.count & TRACE_IDX_MASK];
+    gl_trace_log.count++;
+
+    rec->timestamp = ts;
+    rec->id = (uint8_t)id;
+    rec->port = port;
+    rec->arg0 = arg0;
+    rec->arg1 = arg1;
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+}
+
+/*******************************************************************************
+* Function Name: trace_log_coalesce
+********************************************************************************
+* Summary:
+*  Records a repetitive event. If the newest record has the same ID, port and
+*  first argument, only its repeat count (arg1) is incremented. This keeps
+*  frequent events such as deep sleep entries from flushing the buffer.
+*
+* Parameters:
+*  id - Event ID
+*  port - PD port index
+*  arg0 - First event argument
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void trace_log_coalesce(en_trace_evt_t id, uint8_t port, uint16_t arg0)
+{
+    uint32_t intr_state;
+    stc_trace_record_t *rec;
+    bool merged = false;
+
+    intr_state = Cy_SysLib_EnterCriticalSection();
+
+    if (gl_trace_log.count != 0u)
+    {
+        rec = &gl_trace_log.rec[(gl_trace_log.count - 1u) & TRACE_IDX_MASK];
+        if ((rec->id == (uint8_t)id) && (rec->port == port) && (rec->arg0 == arg0))
+        {
+            rec->arg1++;
+            merged = true;
+        }
+    }
+
+    Cy_SysLib_ExitCriticalSection(intr_state);
+
+    if (!merged)
+    {
+        trace_log(id, port, arg0, 1u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: trace_get_log
+********************************************************************************
+* Summary:
+*  Returns the trace ring buffer for export
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_trace_log_t - Trace ring buffer
+*
+*******************************************************************************/
+const stc_trace_log_t *trace_get_log(void)
+{
+    return &gl_trace_log;
+}
+
+#endif /* TRACE_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/*******************************************************************************
+* File Name: trace.h
+*
+* Description:
+*  This file contains the record format, event IDs and function prototypes of
+*  the binary event trace used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_TRACE_H_
+#define SRC_TRACE_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+
+/*
+ * Marker placed at the start of the trace log so that it can be located in a
+ * RAM dump ("TRC1" in little endian).
+ */
+#define TRACE_LOG_MAGIC                         (0x31435254u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef en_trace_evt_t
+ * @brief Trace event IDs. The values are part of the record format and must
+ * not be renumbered; new IDs are only appended.
+ */
+typedef enum {
+    TRACE_EVT_NONE                   = 0x00, /**< Unused record */
+    TRACE_EVT_CONTRACT_REQ           = 0x01, /**< Contract request. arg0: voltage (mV), arg1: current (mA) */
+    TRACE_EVT_PDO_SELECT             = 0x02, /**< PDO selection. arg0: object position (0 = none), arg1: supply type */
+    TRACE_EVT_REQ_SENT               = 0x03, /**< Request sent. arg0: DPM status, arg1: RDO */
+    TRACE_EVT_PPS_STATUS             = 0x04, /**< PPS status. arg0: voltage (20mV), arg1: current (50mA) | flags << 8 */
+    TRACE_EVT_PD_EVENT               = 0x05, /**< Connection state event. arg0: app event ID */
+    TRACE_EVT_FAULT                  = 0x06, /**< Fault event. arg0: app event ID */
+    TRACE_EVT_SLEEP                  = 0x07, /**< Deep sleep entries. arg1: number of consecutive entries */
+} en_trace_evt_t;
+
+/**
+ * @typedef stc_trace_record_t
+ * @brief Fixed size trace record.
+ */
+typedef struct {
+    uint32_t timestamp;                      /**< Timestamp in ticks, see TIMESTAMP_TICKS_PER_MS */
+    uint8_t id;                              /**< Event ID, see en_trace_evt_t */
+    uint8_t port;                            /**< PD port index */
+    uint16_t arg0;                           /**< First event argument */
+    uint32_t arg1;                           /**< Second event argument */
+} stc_trace_record_t;
+
+/**
+ * @typedef stc_trace_log_t
+ * @brief Trace ring buffer. The newest record is at index (count - 1) modulo depth.
+ */
+typedef struct {
+    uint32_t magic;                          /**< TRACE_LOG_MAGIC */
+    uint16_t depth;                          /**< Number of records in the ring */
+    uint16_t recSize;                        /**< Size of a record in bytes */
+    uint32_t count;                          /**< Total number of records written */
+    stc_trace_record_t rec[TRACE_BUF_DEPTH]; /**< Record ring */
+} stc_trace_log_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if TRACE_ENABLE
+void trace_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void trace_log(en_trace_evt_t id, uint8_t port, uint16_t arg0, uint32_t arg1);
+void trace_log_coalesce(en_trace_evt_t id, uint8_t port, uint16_t arg0);
+const stc_trace_log_t *trace_get_log(void);
+#else
+#define trace_log(id, port, arg0, arg1)         ((void)0)
+#define trace_log_coalesce(id, port, arg0)      ((void)0)
+#endif /* TRACE_ENABLE */
+
+#endif /* SRC_TRACE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,322 @@
+/*******************************************************************************
+* File Name: vbus_meas.c
+*
+* Description:
+*  This file contains the VBUS measurement pipeline. VBUS is oversampled on
+*  every tick of a soft timer, filtered with a 3-tap median and a first order
+*  IIR in fixed point, decimated and published in a double buffer.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "vbus_meas.h"
+#include "app_evt.h"
+#include "timestamp.h"
+#include "cy_pdl.h"
+#include "cy_pdutils_sw_timer.h"
+#include "cy_app.h"
+
+#if VBUS_MEAS_ENABLE
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Fractional bits of the IIR filter state */
+#define VBUS_MEAS_IIR_FRAC                      (4u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Published blocks. Consumers read gl_vbus_blk[gl_vbus_idx]. */
+static stc_vbus_meas_t gl_vbus_blk[2];
+static volatile uint8_t gl_vbus_idx;
+
+/* Set by the timer when a sample is due */
+static volatile bool gl_vbus_due;
+
+/* Median filter history */
+static uint16_t gl_vbus_hist[3];
+
+/* IIR filter state in mV with VBUS_MEAS_IIR_FRAC fractional bits */
+static uint32_t gl_vbus_iir;
+
+/* Decimation window state */
+static uint16_t gl_vbus_decim;
+static uint16_t gl_vbus_min;
+static uint16_t gl_vbus_max;
+
+/* CPU cycles spent in the pipeline in the present load window */
+static uint32_t gl_vbus_busy;
+static uint32_t gl_vbus_win_ts;
+static uint16_t gl_vbus_load;
+
+/* Soft timer context */
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+/* USB PD context */
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: vbus_median3
+********************************************************************************
+* Summary:
+*  Returns the median of the last three oversampled values
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint16_t - Median in mV
+*
+*******************************************************************************/
+static uint16_t vbus_median3(void)
+{
+    uint16_t a = gl_vbus_hist[0];
+    uint16_t b = gl_vbus_hist[1];
+    uint16_t c = gl_vbus_hist[2];
+
+    if (a > b)
+    {
+        uint16_t t = a;
+        a = b;
+        b = t;
+    }
+
+    /* a <= b: the median is b clamped to [a, c] */
+    if (c < b)
+    {
+        b = (c > a) ? c : a;
+    }
+
+    return b;
+}
+
+/*******************************************************************************
+* Function Name: vbus_publish
+********************************************************************************
+* Summary:
+*  Writes the inactive block and makes it the active one
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void vbus_publish(void)
+{
+    stc_vbus_meas_t *blk = &gl_vbus_blk[gl_vbus_idx ^ 1u];
+
+    blk->seq = gl_vbus_blk[gl_vbus_idx].seq + 1u;
+    blk->timestamp = timestamp_get_ticks();
+    blk->volt = (uint16_t)(gl_vbus_iir >> VBUS_MEAS_IIR_FRAC);
+    blk->minVolt = gl_vbus_min;
+    blk->maxVolt = gl_vbus_max;
+    blk->load = gl_vbus_load;
+
+    gl_vbus_idx ^= 1u;
+
+    if ((blk->timestamp - gl_vbus_win_ts) >= (1000u * TIMESTAMP_TICKS_PER_MS))
+    {
+        gl_vbus_load = (uint16_t)(((uint64_t)gl_vbus_busy * 10000u) / Cy_SysClk_ClkSysGetFrequency());
+        gl_vbus_busy = 0u;
+        gl_vbus_win_ts = blk->timestamp;
+    }
+}
+
+/*******************************************************************************
+* Function Name: vbus_timer_cb
+********************************************************************************
+* Summary:
+*  Posts one sample to vbus_meas_task. The conversions are not made here
+*  because this callback runs in the timer interrupt.
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void vbus_timer_cb(cy_timer_id_t id, void *callbackContext)
+{
+    gl_vbus_due = true;
+    Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, callbackContext, id, VBUS_MEAS_PERIOD, vbus_timer_cb);
+}
+
+/*******************************************************************************
+* Function Name: vbus_meas_task
+********************************************************************************
+* Summary:
+*  Takes 2^VBUS_MEAS_OVERSAMPLE_SHIFT conversions and runs them through the
+*  filter chain when the timer has posted a sample. Must be called from the
+*  main loop. Samples posted while a previous one was pending are dropped.
+*
+* Parameters:
+*  context - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void vbus_meas_task(cy_stc_pdstack_context_t *context)
+{
+    uint32_t start;
+    uint32_t sum = 0u;
+    uint16_t sample;
+    uint8_t i;
+
+    if (!gl_vbus_due)
+    {
+        return;
+    }
+    gl_vbus_due = false;
+    start = timestamp_get_cycles();
+
+    for (i = 0u; i < (1u << VBUS_MEAS_OVERSAMPLE_SHIFT); i++)
+    {
+        sum += Cy_App_VbusGetValue(context);
+    }
+    sample = (uint16_t)(sum >> VBUS_MEAS_OVERSAMPLE_SHIFT);
+
+    gl_vbus_hist[2] = gl_vbus_hist[1];
+    gl_vbus_hist[1] = gl_vbus_hist[0];
+    gl_vbus_hist[0] = sample;
+
+    if (gl_vbus_iir == 0u)
+    {
+        /* First sample after attach: seed the filters */
+        gl_vbus_hist[1] = sample;
+        gl_vbus_hist[2] = sample;
+        gl_vbus_iir = (uint32_t)sample << VBUS_MEAS_IIR_FRAC;
+    }
+    else
+    {
+        gl_vbus_iir = gl_vbus_iir - (gl_vbus_iir >> VBUS_MEAS_IIR_SHIFT) +
+            (((uint32_t)vbus_median3() << VBUS_MEAS_IIR_FRAC) >> VBUS_MEAS_IIR_SHIFT);
+    }
+
+    if (gl_vbus_decim == 0u)
+    {
+        gl_vbus_min = sample;
+        gl_vbus_max = sample;
+    }
+    else if (sample < gl_vbus_min)
+    {
+        gl_vbus_min = sample;
+    }
+    else if (sample > gl_vbus_max)
+    {
+        gl_vbus_max = sample;
+    }
+
+    gl_vbus_decim++;
+    if (gl_vbus_decim >= VBUS_MEAS_DECIMATION)
+    {
+        gl_vbus_decim = 0u;
+        vbus_publish();
+    }
+
+    gl_vbus_busy += TIMESTAMP_CYCLES_DELTA(start, timestamp_get_cycles());
+}
+
+/*******************************************************************************
+* Function Name: vbus_evt_handler
+********************************************************************************
+* Summary:
+*  Runs the pipeline while a source is attached
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  evt - App Event
+*  data - Data
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void vbus_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)data;
+
+    if (ctx->port != gl_PdStackPort0Ctx.port)
+    {
+        return;
+    }
+
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)VBUS_MEAS_TIMER_ID);
+
+    gl_vbus_due = false;
+    gl_vbus_iir = 0u;
+    gl_vbus_decim = 0u;
+    gl_vbus_busy = 0u;
+    gl_vbus_load = 0u;
+    gl_vbus_win_ts = timestamp_get_ticks();
+    gl_vbus_blk[gl_vbus_idx].seq = 0u;
+
+    if (evt == APP_EVT_CONNECT)
+    {
+        Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, (void *)ctx, (cy_timer_id_t)VBUS_MEAS_TIMER_ID,
+                VBUS_MEAS_PERIOD, vbus_timer_cb);
+    }
+}
+
+/*******************************************************************************
+* Function Name: vbus_meas_get
+********************************************************************************
+* Summary:
+*  Returns the last published block. Blocks are published from
+*  vbus_meas_task, so main loop consumers can read it without locking.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_vbus_meas_t - Last published block, seq is 0 if none is available
+*
+*******************************************************************************/
+const stc_vbus_meas_t *vbus_meas_get(void)
+{
+    return &gl_vbus_blk[gl_vbus_idx];
+}
+
+#endif /* VBUS_MEAS_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,83 @@
+/*******************************************************************************
+* File Name: vbus_meas.h
+*
+* Description:
+*  This file contains the structure declaration and function prototypes of the
+*  VBUS measurement pipeline used in the USB PD Sink PPS Code example.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef SRC_VBUS_MEAS_H_
+#define SRC_VBUS_MEAS_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include "config.h"
+#include "cy_pdstack_common.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef stc_vbus_meas_t
+ * @brief Block published by the VBUS measurement pipeline once per
+ * decimation period.
+ */
+typedef struct {
+    uint32_t seq;                        /**< Publish sequence number, 0 if nothing published since attach */
+    uint32_t timestamp;                  /**< Timestamp of the block */
+    uint16_t volt;                       /**< Filtered VBUS voltage in mV */
+    uint16_t minVolt;                    /**< Lowest oversampled value in the decimation period in mV */
+    uint16_t maxVolt;                    /**< Highest oversampled value in the decimation period in mV */
+    uint16_t load;                       /**< CPU time spent sampling over the last second, in 0.01% units */
+} stc_vbus_meas_t;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+
+#if VBUS_MEAS_ENABLE
+void vbus_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data);
+void vbus_meas_task(cy_stc_pdstack_context_t *context);
+const stc_vbus_meas_t *vbus_meas_get(void);
+#else
+#define vbus_meas_task(context)                 ((void)0)
+#endif /* VBUS_MEAS_ENABLE */
+
+#endif /* SRC_VBUS_MEAS_H_ */
+
+/* [] END OF FILE */
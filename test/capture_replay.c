@@ -0,0 +1,572 @@
+/*******************************************************************************
+* File Name: capture_replay.c
+*
+* Description:
+*  Host decoder and replay of the PD capture (see src/pd_capture.h). Prints
+*  each record and feeds every recorded contract request with its recorded
+*  source capabilities, sink capabilities, cable limit and PDP limit back
+*  into the PDO selection and RDO encoding of src/pps.c. A request whose
+*  replayed object position, status or RDO differs from the recorded one is
+*  reported as a mismatch. A repeat record counts identical requests that
+*  the capture collapsed into the preceding one. The replay rate is printed
+*  to stderr so that stdout stays comparable with the golden file.
+*  
+*  The cable and PDP limits are injected through replacements of
+*  cable_limit.c and src_cap_ext.c, which are not linked into this program.
+*  
+*  Usage: capture_replay <capture dump>
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_sdk.h"
+#include "app_evt.h"
+#include "pps.h"
+#include "pd_capture.h"
+#include "cable_limit.h"
+#include "src_cap_ext.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Largest dump accepted */
+#define REPLAY_MAX_DUMP                         (1024u * 1024u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/* Limits of the request being replayed */
+static uint16_t gl_replay_cable_cur = 0xFFFFu;
+static uint16_t gl_replay_pdp_cur = 0xFFFFu;
+
+/* Time spent in the replayed contract evaluations */
+static uint64_t gl_replay_ns;
+
+/* Source capabilities of the session being replayed */
+static cy_stc_pdstack_pd_packet_extd_t gl_replay_src_cap;
+
+/*******************************************************************************
+ * Replacements of cable_limit.c and src_cap_ext.c
+ ******************************************************************************/
+void cable_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)ctx;
+    (void)evt;
+    (void)data;
+}
+
+void cable_limit_task(cy_stc_pdstack_context_t *context)
+{
+    (void)context;
+}
+
+void cable_limit_set_rating(uint8_t port, uint16_t cur)
+{
+    (void)port;
+    (void)cur;
+}
+
+uint16_t cable_limit_get_max_cur(const cy_stc_pdstack_context_t *context)
+{
+    (void)context;
+    return gl_replay_cable_cur;
+}
+
+void src_cap_ext_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)ctx;
+    (void)evt;
+    (void)data;
+}
+
+void src_cap_ext_task(cy_stc_pdstack_context_t *context)
+{
+    (void)context;
+}
+
+const stc_src_cap_ext_t *src_cap_ext_get(uint8_t port)
+{
+    static const stc_src_cap_ext_t ext = { .state = SRC_CAP_EXT_NOT_SUPP };
+
+    (void)port;
+    return &ext;
+}
+
+uint16_t src_cap_ext_get_max_cur(const cy_stc_pdstack_context_t *context, uint16_t volt)
+{
+    (void)context;
+    (void)volt;
+    return gl_replay_pdp_cur;
+}
+
+uint8_t src_cap_ext_get_load_step(const cy_stc_pdstack_context_t *context)
+{
+    (void)context;
+    return 100u;
+}
+
+/*******************************************************************************
+* Function Name: rd16
+********************************************************************************
+* Summary:
+*  Reads a little endian 16-bit value
+*
+* Parameters:
+*  p - Location
+*
+* Return:
+*  uint16_t - Value
+*
+*******************************************************************************/
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+/*******************************************************************************
+* Function Name: rd32
+********************************************************************************
+* Summary:
+*  Reads a little endian 32-bit value
+*
+* Parameters:
+*  p - Location
+*
+* Return:
+*  uint32_t - Value
+*
+*******************************************************************************/
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+* Function Name: print_pdo
+********************************************************************************
+* Summary:
+*  Prints a source or sink PDO
+*
+* Parameters:
+*  idx - Object position
+*  val - PDO
+*  snk - true for a sink PDO
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void print_pdo(uint8_t idx, uint32_t val, bool snk)
+{
+    cy_pd_pd_do_t pdo;
+
+    pdo.val = val;
+    printf("  %2u: ", idx);
+    if (val == 0u)
+    {
+        /* Unused SPR positions of an EPR capabilities message */
+        printf("empty\n");
+        return;
+    }
+
+    switch (pdo.fixed_src.supplyType)
+    {
+        case CY_PDSTACK_PDO_FIXED_SUPPLY:
+            printf("FIXED %u mV %u mA", pdo.fixed_src.voltage * 50u,
+                    (snk ? pdo.fixed_snk.opCurrent : pdo.fixed_src.maxCurrent) * 10u);
+            break;
+        case CY_PDSTACK_PDO_BATTERY:
+            printf("BATTERY %u-%u mV %u mW", pdo.bat_src.minVoltage * 50u, pdo.bat_src.maxVoltage * 50u,
+                    pdo.bat_src.maxPower * 250u);
+            break;
+        case CY_PDSTACK_PDO_VARIABLE_SUPPLY:
+            printf("VARIABLE %u-%u mV %u mA", pdo.var_src.minVoltage * 50u, pdo.var_src.maxVoltage * 50u,
+                    pdo.var_src.maxCurrent * 10u);
+            break;
+        default:
+            if (pdo.pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+            {
+                printf("PPS %u-%u mV %u mA", pdo.pps_src.minVolt * 100u, pdo.pps_src.maxVolt * 100u,
+                        pdo.pps_src.maxCur * 50u);
+            }
+            else if (pdo.pps_src.apdoType == CY_PDSTACK_APDO_AVS)
+            {
+                printf("EPR AVS %u-%u mV %u W", pdo.epr_avs_src.minVolt * 100u, pdo.epr_avs_src.maxVolt * 100u,
+                        pdo.epr_avs_src.pdp);
+            }
+            else if (pdo.pps_src.apdoType == CY_PDSTACK_APDO_SPR_AVS)
+            {
+                printf("SPR AVS %u mA (9-15 V) %u mA (15-20 V)", pdo.spr_avs_src.maxCur1 * 10u,
+                        pdo.spr_avs_src.maxCur2 * 10u);
+            }
+            else
+            {
+                printf("APDO 0x%08x", (unsigned)val);
+            }
+            break;
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+* Function Name: supply_name
+********************************************************************************
+* Summary:
+*  Returns the name of a requested supply type
+*
+* Parameters:
+*  type - en_supply_type_t value
+*
+* Return:
+*  const char* - Name
+*
+*******************************************************************************/
+static const char *supply_name(uint8_t type)
+{
+    switch (type)
+    {
+        case FIXED_SUPPLY:
+            return "FIXED";
+        case BATTERY_SUPPLY:
+            return "BATTERY";
+        case VARIABLE_SUPPLY:
+            return "VARIABLE";
+        case PROGRAMMABLE_POWER_SUPPLY:
+            return "PPS";
+        case EPR_ADJUSTABLE_VOLTAGE_SUPPLY:
+            return "EPR_AVS";
+        case SPR_ADJUSTABLE_VOLTAGE_SUPPLY:
+            return "SPR_AVS";
+        default:
+            return "?";
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_src_cap
+********************************************************************************
+* Summary:
+*  Loads a source capabilities record into the port 0 context
+*
+* Parameters:
+*  p - Record payload
+*  len - Payload length
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void replay_src_cap(const uint8_t *p, uint8_t len)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint8_t count = (uint8_t)((len - 2u) / 4u);
+    uint8_t idx;
+
+    printf("SRC_CAP PD rev %u%s%s\n", p[1] + 1u, ((p[0] & PD_CAPTURE_SRC_EPR_ACTIVE) != 0u) ? " epr" : "",
+            ((p[0] & PD_CAPTURE_SRC_EXTD) != 0u) ? " extd" : "");
+
+    memset(&gl_replay_src_cap, 0, sizeof(gl_replay_src_cap));
+    for (idx = 0u; idx < count; idx++)
+    {
+        gl_replay_src_cap.dat[idx].val = rd32(&p[2u + (idx * 4u)]);
+        print_pdo((uint8_t)(idx + 1u), gl_replay_src_cap.dat[idx].val, false);
+    }
+    gl_replay_src_cap.len = count;
+    if ((p[0] & PD_CAPTURE_SRC_EXTD) != 0u)
+    {
+        gl_replay_src_cap.hdr.hdr.extd = 1u;
+        gl_replay_src_cap.hdr.hdr.dataSize = (uint32_t)count * 4u;
+    }
+
+    ctx->dpmStat.srcCapP = (cy_stc_pdstack_pd_packet_t *)&gl_replay_src_cap;
+    ctx->dpmExtStat.eprActive = ((p[0] & PD_CAPTURE_SRC_EPR_ACTIVE) != 0u);
+    ctx->dpmConfig.specRevSopLive = p[1];
+}
+
+/*******************************************************************************
+* Function Name: replay_snk_cap
+********************************************************************************
+* Summary:
+*  Loads a sink capabilities record into the port 0 context
+*
+* Parameters:
+*  p - Record payload
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void replay_snk_cap(const uint8_t *p)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint8_t idx;
+
+    printf("SNK_CAP%s%s%s%s\n", ((p[0] & PD_CAPTURE_SNK_EPR_ACTIVE) != 0u) ? " epr" : "",
+            ((p[0] & PD_CAPTURE_SNK_USB_COMM) != 0u) ? " usb_comm" : "",
+            ((p[0] & PD_CAPTURE_SNK_NO_USB_SUSP) != 0u) ? " no_usb_susp" : "",
+            ((p[0] & PD_CAPTURE_SNK_EPR_CAPABLE) != 0u) ? " epr_capable" : "");
+
+    ctx->dpmStat.snkUsbCommEn = ((p[0] & PD_CAPTURE_SNK_USB_COMM) != 0u);
+    ctx->dpmStat.snkUsbSuspEn = ((p[0] & PD_CAPTURE_SNK_NO_USB_SUSP) != 0u);
+    ctx->dpmExtStat.epr.snkEnable = ((p[0] & PD_CAPTURE_SNK_EPR_CAPABLE) != 0u);
+    ctx->dpmExtStat.eprActive = ((p[0] & PD_CAPTURE_SNK_EPR_ACTIVE) != 0u);
+
+    ctx->dpmStat.curSnkPdocount = p[1];
+    for (idx = 0u; idx < p[1]; idx++)
+    {
+        ctx->dpmStat.curSnkPdo[idx].val = rd32(&p[3u + (idx * 4u)]);
+        print_pdo((uint8_t)(idx + 1u), ctx->dpmStat.curSnkPdo[idx].val, true);
+    }
+    ctx->dpmExtStat.curEprSnkPdoCount = p[2];
+    for (idx = 0u; idx < p[2]; idx++)
+    {
+        ctx->dpmExtStat.curEprSnkPdo[idx].val = rd32(&p[3u + ((p[1] + idx) * 4u)]);
+        print_pdo((uint8_t)(CY_PD_MAX_NO_OF_PDO + idx + 1u), ctx->dpmExtStat.curEprSnkPdo[idx].val, true);
+    }
+    pps_snk_cap_changed(ctx);
+}
+
+/*******************************************************************************
+* Function Name: replay_last_request
+********************************************************************************
+* Summary:
+*  Returns the payload of the request the replay itself just recorded
+*
+* Parameters:
+*  cap - Capture of the replay
+*
+* Return:
+*  const uint8_t* - Payload, NULL if the last record is not that request
+*
+*******************************************************************************/
+static const uint8_t *replay_last_request(const stc_pd_capture_t *cap)
+{
+    uint16_t end = cap->len;
+
+    /* An identical request is collapsed into a repeat record */
+    if ((end >= 4u) && (cap->buf[end - 4u] == PD_CAPTURE_REC_REPEAT) && (cap->buf[end - 3u] == 2u))
+    {
+        end -= 4u;
+    }
+    if ((end < (2u + PD_CAPTURE_REQ_SIZE)) || (cap->buf[end - (2u + PD_CAPTURE_REQ_SIZE)] != PD_CAPTURE_REC_REQUEST))
+    {
+        return NULL;
+    }
+    return &cap->buf[end - PD_CAPTURE_REQ_SIZE];
+}
+
+/*******************************************************************************
+* Function Name: replay_request
+********************************************************************************
+* Summary:
+*  Replays a recorded request and compares the outcome
+*
+* Parameters:
+*  p - Record payload
+*
+* Return:
+*  true if the replayed outcome matches the recording
+*
+*******************************************************************************/
+static bool replay_request(const uint8_t *p)
+{
+    const stc_pd_capture_t *cap = pd_capture_get();
+    const uint8_t *out;
+    uint16_t dropped = cap->dropped;
+    uint16_t volt = rd16(&p[0]);
+    uint16_t cur = rd16(&p[2]);
+    uint64_t start;
+    bool match;
+
+    gl_replay_cable_cur = rd16(&p[4]);
+    gl_replay_pdp_cur = rd16(&p[6]);
+
+    printf("REQUEST %s %u mV %u mA, cable %u mA, pdp ", supply_name(p[8]), volt, cur, gl_replay_cable_cur);
+    if (gl_replay_pdp_cur == 0xFFFFu)
+    {
+        printf("n/a");
+    }
+    else
+    {
+        printf("%u mA", gl_replay_pdp_cur);
+    }
+    printf(" -> pdo %u status %d rdo 0x%08x", p[9], (int)(int8_t)p[10], (unsigned)rd32(&p[11]));
+
+    /* A busy stack is part of the recording */
+    host_send_status = (cy_en_pdstack_status_t)(int8_t)p[10];
+    start = host_time_ns();
+    (void)pps_request_contract((en_supply_type_t)p[8], volt, cur);
+    gl_replay_ns += host_time_ns() - start;
+    host_send_status = CY_PDSTACK_STAT_SUCCESS;
+
+    /* The replay records the request in its own capture */
+    out = replay_last_request(cap);
+    match = (cap->dropped == dropped) && (out != NULL) && (memcmp(&out[9], &p[9], 6u) == 0);
+    if (match)
+    {
+        printf(": replay ok\n");
+    }
+    else if (out == NULL)
+    {
+        printf(": MISMATCH, replay not recorded\n");
+    }
+    else
+    {
+        printf(": MISMATCH, replay pdo %u status %d rdo 0x%08x\n", out[9], (int)(int8_t)out[10],
+                (unsigned)rd32(&out[11]));
+    }
+
+    return match;
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Decodes and replays the first capture found in a dump
+*
+* Parameters:
+*  argc, argv - Command line, see the file description
+*
+* Return:
+*  0 if all requests replayed identically, 1 otherwise
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static uint8_t dump[REPLAY_MAX_DUMP];
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint32_t mismatch = 0u;
+    uint32_t requests = 0u;
+    uint32_t repeats = 0u;
+    size_t len;
+    size_t off;
+    FILE *f;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s <capture dump>\n", argv[0]);
+        return 1;
+    }
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    len = fread(dump, 1u, sizeof(dump), f);
+    fclose(f);
+
+    host_reset();
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+
+    for (off = 0u; (off + 8u) <= len; off += 4u)
+    {
+        uint16_t cap_len;
+        size_t pos;
+
+        if (rd32(&dump[off]) != PD_CAPTURE_MAGIC)
+        {
+            continue;
+        }
+
+        cap_len = rd16(&dump[off + 4u]);
+        if ((off + 8u + cap_len) > len)
+        {
+            continue;
+        }
+
+        printf("capture at 0x%zx: %u bytes, %u records dropped\n", off, cap_len, rd16(&dump[off + 6u]));
+        for (pos = off + 8u; (pos + 2u) <= (off + 8u + cap_len); pos += 2u + dump[pos + 1u])
+        {
+            const uint8_t *p = &dump[pos + 2u];
+            uint8_t type = dump[pos];
+            uint8_t plen = dump[pos + 1u];
+
+            switch (type)
+            {
+                case PD_CAPTURE_REC_ATTACH:
+                    printf("ATTACH\n");
+                    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+                    break;
+                case PD_CAPTURE_REC_DETACH:
+                    printf("DETACH\n");
+                    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+                    break;
+                case PD_CAPTURE_REC_SRC_CAP:
+                    replay_src_cap(p, plen);
+                    break;
+                case PD_CAPTURE_REC_SNK_CAP:
+                    replay_snk_cap(p);
+                    break;
+                case PD_CAPTURE_REC_REQUEST:
+                    requests++;
+                    if (!replay_request(p))
+                    {
+                        mismatch++;
+                    }
+                    break;
+                case PD_CAPTURE_REC_REPEAT:
+                    printf("REPEAT x%u\n", rd16(p));
+                    repeats += rd16(p);
+                    break;
+                default:
+                    printf("unknown record 0x%02x (%u bytes)\n", type, plen);
+                    break;
+            }
+        }
+
+        printf("%u requests replayed, %u repeats, %u mismatches\n", (unsigned)requests, (unsigned)repeats,
+                (unsigned)mismatch);
+        fprintf(stderr, "replayed %u requests in %u us, %u requests/s\n", (unsigned)requests,
+                (unsigned)(gl_replay_ns / 1000u),
+                (unsigned)(((uint64_t)requests * 1000000000u) / ((gl_replay_ns != 0u) ? gl_replay_ns : 1u)));
+        return (mismatch == 0u) ? 0 : 1;
+    }
+
+    fprintf(stderr, "no capture found\n");
+    return 1;
+}
+
+/* [] END OF FILE */
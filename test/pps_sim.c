@@ -0,0 +1,277 @@
+/*******************************************************************************
+* File Name: pps_sim.c
+*
+* Description:
+*  Simulated PPS source for the host tests. The source offers 5 V 3 A fixed
+*  and 3.3-11 V 3 A PPS and does not answer Get_Source_Cap_Extended, and the
+*  main loop is modelled by pps_sim_run.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "pps_sim.h"
+#include "app_evt.h"
+#include "pps.h"
+#include "energy.h"
+#include "src_cap_ext.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+pps_sim_load_t pps_sim_load;
+uint16_t pps_sim_volt;
+uint16_t pps_sim_cur;
+uint16_t pps_sim_cur_max;
+uint32_t pps_sim_isr_cmd_cnt;
+uint32_t pps_sim_status_cnt;
+bool pps_sim_status_mute;
+bool pps_sim_cur_unsupp;
+
+/* Source capabilities */
+static cy_stc_pdstack_pd_packet_t gl_sim_src_cap;
+
+/* PD commands already answered */
+static uint32_t gl_sim_cmd_done;
+
+/*******************************************************************************
+* Function Name: sim_status
+********************************************************************************
+* Summary:
+*  Answers Get_PPS_Status. The source is in current limit when the load draws
+*  more than the requested operating current or than pps_sim_cur_max. A muted
+*  source lets the request time out.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  cmd - Recorded command
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_status(cy_stc_pdstack_context_t *ctx, const host_pd_cmd_t *cmd)
+{
+    cy_stc_pdstack_pd_packet_t pkt;
+    uint8_t *sdb = (uint8_t *)&pkt.dat[0];
+    uint16_t cur = (pps_sim_load != NULL) ? pps_sim_load(pps_sim_volt) : 0u;
+    uint16_t out_volt = pps_sim_volt / 20u;
+
+    if (pps_sim_status_mute)
+    {
+        cmd->cb(ctx, CY_PDSTACK_RES_TIMEOUT, NULL);
+        return;
+    }
+
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.hdr.hdr.dataSize = 4u;
+    sdb[3] = 0u;
+    if (cur > pps_sim_cur)
+    {
+        cur = pps_sim_cur;
+        sdb[3] = PPS_STATUS_OMF_MASK;
+    }
+    if ((pps_sim_cur_max != 0u) && (cur > pps_sim_cur_max))
+    {
+        cur = pps_sim_cur_max;
+        sdb[3] = PPS_STATUS_OMF_MASK;
+    }
+    sdb[0] = (uint8_t)out_volt;
+    sdb[1] = (uint8_t)(out_volt >> 8u);
+    /* Output current in 50 mA units, rounded */
+    sdb[2] = pps_sim_cur_unsupp ? PPS_STATUS_CUR_NOT_SUPP : (uint8_t)((cur + 25u) / 50u);
+
+    pps_sim_status_cnt++;
+    cmd->cb(ctx, CY_PDSTACK_RES_RCVD, &pkt);
+}
+
+/*******************************************************************************
+* Function Name: sim_request
+********************************************************************************
+* Summary:
+*  Accepts a request, moves VBUS to the requested voltage and completes the
+*  contract
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  cmd - Recorded command
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_request(cy_stc_pdstack_context_t *ctx, const host_pd_cmd_t *cmd)
+{
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+    uint32_t rdo = cmd->buf.cmdDo[0].val;
+    uint8_t pos = (uint8_t)((rdo >> 28u) & 0x7u);
+
+    ctx->dpmStat.srcSelPdo = gl_sim_src_cap.dat[pos - 1u];
+    if (pos == 2u)
+    {
+        /* PPS RDO: output voltage in 20 mV units, operating current in 50 mA units */
+        pps_sim_volt = (uint16_t)(((rdo >> 9u) & 0xFFFu) * 20u);
+        pps_sim_cur = (uint16_t)((rdo & 0x7Fu) * 50u);
+    }
+    else
+    {
+        pps_sim_volt = VSAFE_5V;
+        pps_sim_cur = 3000u;
+    }
+    host_vbus_mv[ctx->port & 1u] = pps_sim_volt;
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &ok);
+}
+
+/*******************************************************************************
+* Function Name: pps_sim_attach
+********************************************************************************
+* Summary:
+*  Attaches the source, completes the first explicit contract at 5 V and
+*  starts the PPS timer
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_sim_attach(cy_stc_pdstack_context_t *ctx)
+{
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+
+    gl_sim_src_cap.len = 2u;
+    gl_sim_src_cap.dat[0].val = 0x0001912Cu;
+    gl_sim_src_cap.dat[1].val = 0xC0DC213Cu;
+    ctx->dpmStat.srcCapP = &gl_sim_src_cap;
+    ctx->dpmStat.curSnkPdo[0].val = gl_sim_src_cap.dat[0].val;
+    ctx->dpmStat.curSnkPdo[1].val = gl_sim_src_cap.dat[1].val;
+    ctx->dpmStat.curSnkPdocount = 2u;
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV3;
+    ctx->dpmConfig.attach = true;
+    gl_sim_cmd_done = host_pd_cmd_cnt;
+    pps_sim_volt = VSAFE_5V;
+    pps_sim_cur = 3000u;
+    host_vbus_mv[ctx->port & 1u] = pps_sim_volt;
+
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmStat.srcSelPdo = gl_sim_src_cap.dat[0];
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &ok);
+    if (!host_timer_running((cy_timer_id_t)PPS_TIMER_ID))
+    {
+        pps_timer_cb((cy_timer_id_t)PPS_TIMER_ID, ctx);
+    }
+}
+
+/*******************************************************************************
+* Function Name: pps_sim_detach
+********************************************************************************
+* Summary:
+*  Detaches the source
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_sim_detach(cy_stc_pdstack_context_t *ctx)
+{
+    ctx->dpmConfig.attach = false;
+    ctx->dpmConfig.contractExist = false;
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+}
+
+/*******************************************************************************
+* Function Name: pps_sim_run
+********************************************************************************
+* Summary:
+*  Runs the soft timers and the PPS, energy and extended source capabilities
+*  tasks for a number of milliseconds, and answers every PD command right after the main loop pass
+*  that sent it
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  ms - Duration in ms
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void pps_sim_run(cy_stc_pdstack_context_t *ctx, uint32_t ms)
+{
+    const host_pd_cmd_t *cmd;
+    uint32_t cnt;
+
+    while (ms-- != 0u)
+    {
+        cnt = host_pd_cmd_cnt;
+        host_advance_ms(1u);
+        pps_sim_isr_cmd_cnt += host_pd_cmd_cnt - cnt;
+
+        pps_task();
+        energy_task(ctx);
+        src_cap_ext_task(ctx);
+
+        while (gl_sim_cmd_done != host_pd_cmd_cnt)
+        {
+            cmd = &host_pd_cmd_log[gl_sim_cmd_done % HOST_PD_CMD_LOG_SIZE];
+            gl_sim_cmd_done++;
+            if (cmd->cmd == CY_PDSTACK_DPM_CMD_GET_PPS_STATUS)
+            {
+                sim_status(ctx, cmd);
+            }
+            else if (cmd->cmd == CY_PDSTACK_DPM_CMD_SEND_REQUEST)
+            {
+                sim_request(ctx, cmd);
+            }
+            else if (cmd->cmd == CY_PDSTACK_DPM_CMD_GET_SRC_CAP_EXTENDED)
+            {
+                /* No SCEDB: the source lets the request time out */
+                cmd->cb(ctx, CY_PDSTACK_RES_TIMEOUT, NULL);
+            }
+            else
+            {
+                /* Not modelled */
+            }
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* File Name: pps_sim.h
+*
+* Description:
+*  Simulated PPS source for the host tests. The source accepts every PPS
+*  request, limits the output current to the requested operating current and
+*  answers Get_PPS_Status from a load model.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef TEST_PPS_SIM_H_
+#define TEST_PPS_SIM_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "host_sdk.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/**
+ * @typedef pps_sim_load_t
+ * @brief Load model: current drawn in mA at an output voltage in mV.
+ */
+typedef uint16_t (*pps_sim_load_t)(uint16_t volt);
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Load model, 0 mA if NULL */
+extern pps_sim_load_t pps_sim_load;
+
+/* Output voltage (mV) and current limit (mA) of the last accepted request */
+extern uint16_t pps_sim_volt;
+extern uint16_t pps_sim_cur;
+
+/* PD commands issued from a soft timer callback */
+extern uint32_t pps_sim_isr_cmd_cnt;
+
+/* Get_PPS_Status messages answered */
+extern uint32_t pps_sim_status_cnt;
+
+/* Current (mA) the source can deliver before it enters current limit, 0 if
+ * only limited by the request */
+extern uint16_t pps_sim_cur_max;
+
+/* When set, Get_PPS_Status times out instead of being answered */
+extern bool pps_sim_status_mute;
+
+/* When set, PPS status reports the output current as not supported */
+extern bool pps_sim_cur_unsupp;
+
+/******************************************************************************
+ * Global function declaration
+ ******************************************************************************/
+void pps_sim_attach(cy_stc_pdstack_context_t *ctx);
+void pps_sim_detach(cy_stc_pdstack_context_t *ctx);
+void pps_sim_run(cy_stc_pdstack_context_t *ctx, uint32_t ms);
+
+#endif /* TEST_PPS_SIM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,2 @@
+/* Host build: see host_sdk.h */
+#include "host_sdk.h"
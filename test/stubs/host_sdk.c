@@ -0,0 +1,584 @@
+/*******************************************************************************
+* File Name: host_sdk.c
+*
+* Description:
+*  Host models of the SDK functions used by the application sources. PD
+*  commands are recorded, soft timers run from host_advance_ms and the flash
+*  is a memory mapping at the device flash address, optionally backed by a
+*  file so that its content survives a simulated power cycle.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "host_sdk.h"
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+typedef struct {
+    bool running;
+    uint32_t remaining;
+    void *cbContext;
+    cy_cb_timer_t cb;
+} host_timer_t;
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+host_systick_t host_systick;
+CySCB_Type host_uart;
+const cy_stc_scb_uart_config_t CYBSP_UART_config;
+
+/* Objects normally provided by main.c */
+cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+/* dpmDefCableCap as set by Cy_PdStack_Dpm_Init from the DPM parameters of main.c */
+cy_stc_usbpd_context_t gl_UsbPdPort0Ctx = { .port = 0u };
+cy_stc_usbpd_context_t gl_UsbPdPort1Ctx = { .port = 1u };
+cy_stc_pdstack_context_t gl_PdStackPort0Ctx = { .port = 0u, .ptrUsbPdContext = &gl_UsbPdPort0Ctx,
+        .dpmStat.dpmDefCableCap = 300u };
+cy_stc_pdstack_context_t gl_PdStackPort1Ctx = { .port = 1u, .ptrUsbPdContext = &gl_UsbPdPort1Ctx,
+        .dpmStat.dpmDefCableCap = 300u };
+uint32_t host_led_evt_cnt;
+
+uint16_t host_wdt_count;
+uint16_t host_vbus_mv[2];
+uint16_t host_batt_mv[2];
+bool host_dpm_idle = true;
+cy_en_pdstack_status_t host_send_status = CY_PDSTACK_STAT_SUCCESS;
+host_pd_cmd_t host_pd_cmd_log[HOST_PD_CMD_LOG_SIZE];
+uint32_t host_pd_cmd_cnt;
+cy_stc_bc_status_t host_bc_status[2];
+uint32_t host_bc_stop_cnt[2];
+uint32_t host_flash_write_cnt;
+uint32_t host_flash_fail_at;
+uint32_t host_sink_enable_cnt[2];
+uint32_t host_sink_disable_cnt[2];
+uint32_t host_snk_cap_update_cnt;
+uint8_t host_uart_tx[4096];
+uint32_t host_uart_tx_len;
+bool host_in_timer_cb;
+uint32_t host_isr_adc_cnt;
+uint32_t host_wdt_isr_cnt;
+uint64_t host_wdt_isr_max_ns;
+
+static host_timer_t gl_host_timers[HOST_TIMER_CNT];
+
+void led_evt_handler(cy_stc_pdstack_context_t *ctx, cy_en_pdstack_app_evt_t evt, const void *data)
+{
+    (void)ctx;
+    (void)evt;
+    (void)data;
+    host_led_evt_cnt++;
+}
+
+/*******************************************************************************
+ * Host model control
+ ******************************************************************************/
+void host_assert_fail(const char *expr, const char *file, int line)
+{
+    fprintf(stderr, "%s:%d: assertion failed: %s\n", file, line, expr);
+    abort();
+}
+
+void host_reset(void)
+{
+    memset(gl_host_timers, 0, sizeof(gl_host_timers));
+    memset(host_pd_cmd_log, 0, sizeof(host_pd_cmd_log));
+    memset(host_bc_status, 0, sizeof(host_bc_status));
+    memset(host_bc_stop_cnt, 0, sizeof(host_bc_stop_cnt));
+    memset(host_sink_enable_cnt, 0, sizeof(host_sink_enable_cnt));
+    memset(host_sink_disable_cnt, 0, sizeof(host_sink_disable_cnt));
+    memset(host_batt_mv, 0, sizeof(host_batt_mv));
+    host_pd_cmd_cnt = 0u;
+    host_dpm_idle = true;
+    host_send_status = CY_PDSTACK_STAT_SUCCESS;
+    host_flash_write_cnt = 0u;
+    host_flash_fail_at = 0u;
+    host_snk_cap_update_cnt = 0u;
+    host_uart_tx_len = 0u;
+    host_led_evt_cnt = 0u;
+    host_isr_adc_cnt = 0u;
+    host_wdt_isr_cnt = 0u;
+    host_wdt_isr_max_ns = 0u;
+}
+
+/* Whether the flash region is mapped */
+static bool gl_flash_mapped;
+
+void host_flash_open(const char *path)
+{
+    void *p;
+    int fd;
+
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if ((fd < 0) || (ftruncate(fd, CY_FLASH_SIZE) != 0))
+    {
+        fprintf(stderr, "cannot open the flash file %s\n", path);
+        exit(2);
+    }
+
+    /* Replaces the previous mapping, as a power cycle would */
+    p = mmap((void *)(uintptr_t)CY_FLASH_BASE, CY_FLASH_SIZE, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_FIXED, fd, 0);
+    (void)close(fd);
+    if (p != (void *)(uintptr_t)CY_FLASH_BASE)
+    {
+        fprintf(stderr, "cannot map the flash at 0x%08x\n", (unsigned)CY_FLASH_BASE);
+        exit(2);
+    }
+    gl_flash_mapped = true;
+}
+
+/* Master side of the pseudo terminal standing in for the UART, -1 if none */
+static int gl_uart_pty = -1;
+
+int host_uart_open_pty(char *name, size_t size)
+{
+    struct termios tio;
+    const char *slave;
+    int fd;
+
+    fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    slave = ((grantpt(fd) == 0) && (unlockpt(fd) == 0)) ? ptsname(fd) : NULL;
+    if ((slave == NULL) || (strlen(slave) >= size) || (tcgetattr(fd, &tio) != 0))
+    {
+        (void)close(fd);
+        return -1;
+    }
+
+    /* Binary frames pass the line discipline unchanged */
+    cfmakeraw(&tio);
+    (void)tcsetattr(fd, TCSANOW, &tio);
+    strcpy(name, slave);
+    gl_uart_pty = fd;
+    return fd;
+}
+
+void host_uart_close_pty(void)
+{
+    if (gl_uart_pty >= 0)
+    {
+        (void)close(gl_uart_pty);
+        gl_uart_pty = -1;
+    }
+}
+
+void host_flash_init(void)
+{
+    if (!gl_flash_mapped)
+    {
+        void *p = mmap((void *)(uintptr_t)CY_FLASH_BASE, CY_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (p != (void *)(uintptr_t)CY_FLASH_BASE)
+        {
+            fprintf(stderr, "cannot map the flash at 0x%08x\n", (unsigned)CY_FLASH_BASE);
+            exit(2);
+        }
+        gl_flash_mapped = true;
+    }
+
+    /* Erased flash reads as zero on PMG1 */
+    memset((void *)(uintptr_t)CY_FLASH_BASE, 0, CY_FLASH_SIZE);
+    host_flash_write_cnt = 0u;
+}
+
+uint64_t host_time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+void host_advance_ms(uint32_t ms)
+{
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+    uint8_t id;
+    bool isr;
+
+    for (i = 0u; i < ms; i++)
+    {
+        host_wdt_count = (uint16_t)(host_wdt_count + 40u);
+        start = 0u;
+        isr = false;
+        for (id = 0u; id < HOST_TIMER_CNT; id++)
+        {
+            host_timer_t *tmr = &gl_host_timers[id];
+            if (tmr->running)
+            {
+                if (tmr->remaining <= 1u)
+                {
+                    if (!isr)
+                    {
+                        isr = true;
+                        start = host_time_ns();
+                    }
+                    tmr->running = false;
+                    host_in_timer_cb = true;
+                    tmr->cb((cy_timer_id_t)(CY_PDUTILS_TIMER_USER_START_ID + id), tmr->cbContext);
+                    host_in_timer_cb = false;
+                }
+                else
+                {
+                    tmr->remaining--;
+                }
+            }
+        }
+
+        /* A tickless WDT interrupt only occurs when a timer expires */
+        if (isr)
+        {
+            ns = host_time_ns() - start;
+            host_wdt_isr_cnt++;
+            if (ns > host_wdt_isr_max_ns)
+            {
+                host_wdt_isr_max_ns = ns;
+            }
+        }
+    }
+}
+
+static host_timer_t *host_timer(cy_timer_id_t id)
+{
+    /* Only the application timer IDs are modelled */
+    uint32_t idx = (uint32_t)id - CY_PDUTILS_TIMER_USER_START_ID;
+
+    if (idx >= HOST_TIMER_CNT)
+    {
+        host_assert_fail("timer id in range", __FILE__, __LINE__);
+    }
+    return &gl_host_timers[idx];
+}
+
+bool host_timer_running(cy_timer_id_t id)
+{
+    return host_timer(id)->running;
+}
+
+void host_timer_fire(cy_timer_id_t id)
+{
+    host_timer_t *tmr = host_timer(id);
+
+    if (tmr->running)
+    {
+        tmr->running = false;
+        tmr->cb(id, tmr->cbContext);
+    }
+}
+
+const host_pd_cmd_t *host_last_cmd(void)
+{
+    if (host_pd_cmd_cnt == 0u)
+    {
+        return NULL;
+    }
+    return &host_pd_cmd_log[(host_pd_cmd_cnt - 1u) % HOST_PD_CMD_LOG_SIZE];
+}
+
+/*******************************************************************************
+ * PDL
+ ******************************************************************************/
+uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+uint32_t Cy_SysClk_ClkSysGetFrequency(void)
+{
+    return 48000000u;
+}
+
+uint32_t Cy_WDT_GetCount(void)
+{
+    return host_wdt_count;
+}
+
+uint32_t Cy_WDT_GetMatch(void)
+{
+    return host_wdt_count;
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+    return 0u;
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+int Cy_SysInt_Init(const cy_stc_sysint_t *config, void (*userIsr)(void))
+{
+    (void)config;
+    (void)userIsr;
+    return 0;
+}
+
+void Cy_GPIO_Write(void *base, uint32_t pinNum, uint32_t value)
+{
+    (void)base;
+    (void)pinNum;
+    (void)value;
+}
+
+uint32_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t *data)
+{
+    host_flash_write_cnt++;
+    if ((host_flash_fail_at != 0u) && (host_flash_write_cnt == host_flash_fail_at))
+    {
+        return 1u;
+    }
+    if ((rowAddr < CY_FLASH_BASE) || ((rowAddr + CY_FLASH_SIZEOF_ROW) > (CY_FLASH_BASE + CY_FLASH_SIZE)) ||
+        ((rowAddr % CY_FLASH_SIZEOF_ROW) != 0u))
+    {
+        host_assert_fail("flash row address", __FILE__, __LINE__);
+    }
+    memcpy((void *)(uintptr_t)rowAddr, data, CY_FLASH_SIZEOF_ROW);
+    return CY_FLASH_DRV_SUCCESS;
+}
+
+int Cy_SCB_UART_Init(CySCB_Type *base, const cy_stc_scb_uart_config_t *config, cy_stc_scb_uart_context_t *context)
+{
+    (void)base;
+    (void)config;
+    (void)context;
+    return 0;
+}
+
+void Cy_SCB_UART_Enable(CySCB_Type *base)
+{
+    (void)base;
+}
+
+uint32_t Cy_SCB_UART_PutArray(CySCB_Type *base, void *buffer, uint32_t size)
+{
+    uint32_t copy;
+    ssize_t sent;
+
+    (void)base;
+    if (gl_uart_pty >= 0)
+    {
+        /* A full pseudo terminal takes fewer bytes, as a full TX FIFO would */
+        sent = write(gl_uart_pty, buffer, size);
+        size = (sent > 0) ? (uint32_t)sent : 0u;
+    }
+    else if (size > (sizeof(host_uart_tx) - host_uart_tx_len))
+    {
+        size = sizeof(host_uart_tx) - host_uart_tx_len;
+    }
+
+    copy = size;
+    if (copy > (sizeof(host_uart_tx) - host_uart_tx_len))
+    {
+        copy = sizeof(host_uart_tx) - host_uart_tx_len;
+    }
+    memcpy(&host_uart_tx[host_uart_tx_len], buffer, copy);
+    host_uart_tx_len += copy;
+    return size;
+}
+
+bool Cy_SCB_UART_IsTxComplete(CySCB_Type const *base)
+{
+    (void)base;
+    return true;
+}
+
+void Cy_SCB_SetTxInterruptMask(CySCB_Type *base, uint32_t interruptMask)
+{
+    (void)base;
+    (void)interruptMask;
+}
+
+void Cy_SCB_ClearTxInterrupt(CySCB_Type *base, uint32_t interruptMask)
+{
+    (void)base;
+    (void)interruptMask;
+}
+
+/*******************************************************************************
+ * PDUtils
+ ******************************************************************************/
+void Cy_PdUtils_SwTimer_Start(cy_stc_pdutils_sw_timer_t *context, void *callbackContext, cy_timer_id_t id,
+        uint16_t period, cy_cb_timer_t cb)
+{
+    host_timer_t *tmr = host_timer(id);
+
+    (void)context;
+    tmr->running = true;
+    tmr->remaining = period;
+    tmr->cbContext = callbackContext;
+    tmr->cb = cb;
+}
+
+void Cy_PdUtils_SwTimer_Stop(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id)
+{
+    (void)context;
+    host_timer(id)->running = false;
+}
+
+bool Cy_PdUtils_SwTimer_IsRunning(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id)
+{
+    (void)context;
+    return host_timer(id)->running;
+}
+
+/*******************************************************************************
+ * PDStack
+ ******************************************************************************/
+cy_en_pdstack_status_t Cy_PdStack_Dpm_SendPdCommand(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_pd_cmd_t cmd, cy_stc_pdstack_dpm_pd_cmd_buf_t *buf_ptr, bool noResp,
+        cy_pdstack_dpm_pd_cmd_cbk_t cmdCbk)
+{
+    host_pd_cmd_t *rec;
+
+    (void)noResp;
+    if (host_send_status != CY_PDSTACK_STAT_SUCCESS)
+    {
+        return host_send_status;
+    }
+
+    rec = &host_pd_cmd_log[host_pd_cmd_cnt % HOST_PD_CMD_LOG_SIZE];
+    memset(rec, 0, sizeof(*rec));
+    rec->cmd = (uint8_t)cmd;
+    rec->port = ptrPdStackContext->port;
+    rec->cb = cmdCbk;
+    if (buf_ptr != NULL)
+    {
+        rec->buf = *buf_ptr;
+    }
+    host_pd_cmd_cnt++;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_IsIdle(cy_stc_pdstack_context_t *ptrPdStackContext, bool *isIdle)
+{
+    (void)ptrPdStackContext;
+    *isIdle = host_dpm_idle;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSnkCap(cy_stc_pdstack_context_t *ptrPdStackContext,
+        uint8_t count, cy_pd_pd_do_t *pdo)
+{
+    if ((count == 0u) || (count > CY_PD_MAX_NO_OF_PDO))
+    {
+        return CY_PDSTACK_STAT_BAD_PARAM;
+    }
+    memcpy(ptrPdStackContext->dpmStat.curSnkPdo, pdo, count * sizeof(cy_pd_pd_do_t));
+    ptrPdStackContext->dpmStat.curSnkPdocount = count;
+    host_snk_cap_update_cnt++;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSnkCapMask(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t mask)
+{
+    ptrPdStackContext->dpmStat.snkPdoMask = mask;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+/*******************************************************************************
+ * pmg-app-common
+ ******************************************************************************/
+uint16_t Cy_App_VbusGetValue(cy_stc_pdstack_context_t *context)
+{
+    if (host_in_timer_cb)
+    {
+        host_isr_adc_cnt++;
+    }
+    return host_vbus_mv[context->port & 1u];
+}
+
+#if BATT_CHG_ENABLE
+uint16_t batt_chg_get_batt_volt(cy_stc_pdstack_context_t *context)
+{
+    return host_batt_mv[context->port & 1u];
+}
+#endif /* BATT_CHG_ENABLE */
+
+void Cy_App_Sink_Enable(cy_stc_pdstack_context_t *context)
+{
+    host_sink_enable_cnt[context->port & 1u]++;
+}
+
+void Cy_App_Sink_Disable(cy_stc_pdstack_context_t *context, cy_pdstack_sink_discharge_off_cbk_t snk_discharge_off_handler)
+{
+    (void)snk_discharge_off_handler;
+    host_sink_disable_cnt[context->port & 1u]++;
+}
+
+const cy_stc_bc_status_t *Cy_App_Bc_GetStatus(cy_stc_usbpd_context_t *ptrUsbPdContext)
+{
+    return &host_bc_status[ptrUsbPdContext->port & 1u];
+}
+
+cy_en_pdstack_status_t Cy_App_Bc_Stop(cy_stc_usbpd_context_t *ptrUsbPdContext)
+{
+    host_bc_stop_cnt[ptrUsbPdContext->port & 1u]++;
+    return CY_PDSTACK_STAT_SUCCESS;
+}
+
+bool Cy_App_SystemSleep(cy_stc_pdstack_context_t *ptrPdStack0Context, cy_stc_pdstack_context_t *ptrPdStack1Context)
+{
+    (void)ptrPdStack0Context;
+    (void)ptrPdStack1Context;
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,646 @@
+/*******************************************************************************
+* File Name: host_sdk.h
+*
+* Description:
+*  Host build stand-in for the parts of the PDL, PDStack, PDUtils and
+*  pmg-app-common APIs used by the application sources. The data layouts
+*  follow the USB PD specification bit assignments so that encoded PDOs
+*  and RDOs can be compared with values captured on the target.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef TEST_STUBS_HOST_SDK_H_
+#define TEST_STUBS_HOST_SDK_H_
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+#define CY_ASSERT(x)                            do { if (!(x)) { host_assert_fail(#x, __FILE__, __LINE__); } } while (0)
+
+#define CY_PD_MAX_NO_OF_DO                      (7u)
+#define CY_PD_MAX_NO_OF_PDO                     (7u)
+#define CY_PD_MAX_NO_OF_EPR_PDO                 (6u)
+#define CY_PD_MAX_EXTD_PKT_WORDS                (65u)
+#define CY_PD_REV2                              (1u)
+#define CY_PD_REV3                              (2u)
+
+#ifndef NO_OF_TYPEC_PORTS
+#define NO_OF_TYPEC_PORTS                       (1u)
+#endif /* NO_OF_TYPEC_PORTS */
+
+#define CY_PDUTILS_TIMER_USER_START_ID          (0xC0u)
+#define CY_PDUTILS_DIV_ROUND_UP(x, y)           (((x) + ((y) - 1u)) / (y))
+
+#define CY_PDSTACK_CONTRACT_REJECT_CONTRACT_VALID  (0x00u)
+#define CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL (0x01u)
+
+#define CY_FLASH_SIZEOF_ROW                     (128u)
+#define CY_FLASH_SIZE                           (0x20000u)
+#define CY_FLASH_BASE                           (0x10000000u)
+#define CY_FLASH_DRV_SUCCESS                    (0u)
+
+#define CY_SCB_TX_INTR_LEVEL                    (1u)
+
+#define SysTick_LOAD_RELOAD_Msk                 (0xFFFFFFu)
+#define SysTick_CTRL_CLKSOURCE_Msk              (4u)
+#define SysTick_CTRL_ENABLE_Msk                 (1u)
+#define SysTick                                 (&host_systick)
+
+#define CYBSP_UART_HW                           (&host_uart)
+#define CYBSP_UART_IRQ                          (10)
+
+#define PFET_SNK_CTRL_P0_PORT                   (NULL)
+#define PFET_SNK_CTRL_P0_PIN                    (0u)
+#define PFET_SNK_CTRL_P1_PORT                   (NULL)
+#define PFET_SNK_CTRL_P1_PIN                    (1u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+typedef uint8_t cy_timer_id_t;
+typedef int IRQn_Type;
+
+typedef enum {
+    CY_PD_SOP = 0,
+    CY_PD_SOP_PRIME,
+    CY_PD_SOP_DPRIME,
+} cy_en_pd_sop_t;
+
+typedef enum {
+    CY_PD_CTRL_MSG_ACCEPT       = 3,
+    CY_PD_CTRL_MSG_REJECT       = 4,
+    CY_PD_CTRL_MSG_WAIT         = 12,
+} cy_en_pd_ctrl_msg_t;
+
+typedef enum {
+    CY_PDSTACK_STAT_NO_RESPONSE = -2,
+    CY_PDSTACK_STAT_HARD_RESET  = -1,
+    CY_PDSTACK_STAT_SUCCESS     = 0,
+    CY_PDSTACK_STAT_FLASH_DATA_AVAILABLE,
+    CY_PDSTACK_STAT_BAD_PARAM,
+    CY_PDSTACK_STAT_INVALID_COMMAND = 3,
+    CY_PDSTACK_STAT_FLASH_UPDATE_FAILED = 5,
+    CY_PDSTACK_STAT_INVALID_FW,
+    CY_PDSTACK_STAT_INVALID_ARGUMENT,
+    CY_PDSTACK_STAT_NOT_SUPPORTED,
+    CY_PDSTACK_STAT_INVALID_SIGNATURE,
+    CY_PDSTACK_STAT_TRANS_FAILURE,
+    CY_PDSTACK_STAT_CMD_FAILURE,
+    CY_PDSTACK_STAT_FAILURE,
+    CY_PDSTACK_STAT_READ_DATA,
+    CY_PDSTACK_STAT_NOT_READY,
+    CY_PDSTACK_STAT_BUSY,
+} cy_en_pdstack_status_t;
+
+typedef enum {
+    CY_PDSTACK_SEQ_ABORTED = 0,
+    CY_PDSTACK_CMD_FAILED,
+    CY_PDSTACK_RES_TIMEOUT,
+    CY_PDSTACK_CMD_SENT,
+    CY_PDSTACK_RES_RCVD,
+} cy_en_pdstack_resp_status_t;
+
+typedef enum {
+    CY_PDSTACK_PDO_FIXED_SUPPLY = 0,
+    CY_PDSTACK_PDO_BATTERY,
+    CY_PDSTACK_PDO_VARIABLE_SUPPLY,
+    CY_PDSTACK_PDO_AUGMENTED,
+} cy_en_pdstack_pdo_t;
+
+typedef enum {
+    CY_PDSTACK_APDO_PPS = 0,
+    CY_PDSTACK_APDO_AVS,
+    CY_PDSTACK_APDO_SPR_AVS,
+} cy_en_pdstack_apdo_t;
+
+typedef enum {
+    CY_PDSTACK_DPM_CMD_SRC_CAP_CHNG = 0,
+    CY_PDSTACK_DPM_CMD_SNK_CAP_CHNG,
+    CY_PDSTACK_DPM_CMD_SEND_GO_TO_MIN,
+    CY_PDSTACK_DPM_CMD_GET_SNK_CAP,
+    CY_PDSTACK_DPM_CMD_GET_SRC_CAP,
+    CY_PDSTACK_DPM_CMD_SEND_HARD_RESET,
+    CY_PDSTACK_DPM_CMD_SEND_SOFT_RESET,
+    CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP = 0x09,
+    CY_PDSTACK_DPM_CMD_SEND_REQUEST = 0x0B,
+    CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY = 0x10,
+    CY_PDSTACK_DPM_CMD_GET_SRC_CAP_EXTENDED = 0x14,
+    CY_PDSTACK_DPM_CMD_GET_PPS_STATUS = 0x17,
+    CY_PDSTACK_DPM_CMD_SEND_EPR_REQUEST = 0x2A,
+    CY_PDSTACK_DPM_CMD_SNK_EPR_MODE_ENTRY = 0x2C,
+} cy_en_pdstack_dpm_pd_cmd_t;
+
+typedef enum {
+    APP_EVT_UNEXPECTED_VOLTAGE_ON_VBUS = 0,
+    APP_EVT_TYPE_C_ERROR_RECOVERY,
+    APP_EVT_CONNECT,
+    APP_EVT_DISCONNECT,
+    APP_EVT_EMCA_DETECTED,
+    APP_EVT_EMCA_NOT_DETECTED,
+    APP_EVT_ALT_MODE,
+    APP_EVT_APP_HW,
+    APP_EVT_BB,
+    APP_EVT_RP_CHANGE,
+    APP_EVT_HARD_RESET_RCVD,
+    APP_EVT_HARD_RESET_COMPLETE,
+    APP_EVT_PKT_RCVD,
+    APP_EVT_PR_SWAP_COMPLETE,
+    APP_EVT_DR_SWAP_COMPLETE,
+    APP_EVT_VCONN_SWAP_COMPLETE,
+    APP_EVT_SENDER_RESPONSE_TIMEOUT,
+    APP_EVT_VENDOR_RESPONSE_TIMEOUT,
+    APP_EVT_HARD_RESET_SENT,
+    APP_EVT_SOFT_RESET_SENT,
+    APP_EVT_CBL_RESET_SENT,
+    APP_EVT_PE_DISABLED,
+    APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE,
+    APP_EVT_VBUS_OVP_FAULT,
+    APP_EVT_VBUS_OCP_FAULT,
+    APP_EVT_VCONN_OCP_FAULT,
+    APP_EVT_VBUS_PORT_DISABLE,
+    APP_EVT_TYPEC_STARTED,
+    APP_EVT_FR_SWAP_COMPLETE,
+    APP_EVT_TEMPERATURE_FAULT,
+    APP_EVT_HANDLE_EXTENDED_MSG,
+    APP_EVT_VBUS_UVP_FAULT,
+    APP_EVT_VBUS_SCP_FAULT,
+    APP_TOTAL_EVENTS
+} cy_en_pdstack_app_evt_t;
+
+/* Power data object. Bit assignments follow the USB PD 3.2 specification. */
+typedef union {
+    uint32_t val;
+
+    struct {
+        uint32_t maxCurrent     : 10;
+        uint32_t voltage        : 10;
+        uint32_t pkCurrent      : 2;
+        uint32_t reserved       : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t drSwap         : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t extPowered     : 1;
+        uint32_t usbSuspendSup  : 1;
+        uint32_t dualRolePower  : 1;
+        uint32_t supplyType     : 2;
+    } fixed_src;
+
+    struct {
+        uint32_t maxCurrent     : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } var_src;
+
+    struct {
+        uint32_t maxPower       : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } bat_src;
+
+    struct {
+        uint32_t opCurrent      : 10;
+        uint32_t voltage        : 10;
+        uint32_t reserved       : 3;
+        uint32_t frSwap         : 2;
+        uint32_t drSwap         : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t extPowered     : 1;
+        uint32_t highCap        : 1;
+        uint32_t dualRolePower  : 1;
+        uint32_t supplyType     : 2;
+    } fixed_snk;
+
+    struct {
+        uint32_t opCurrent      : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } var_snk;
+
+    struct {
+        uint32_t opPower        : 10;
+        uint32_t minVoltage     : 10;
+        uint32_t maxVoltage     : 10;
+        uint32_t supplyType     : 2;
+    } bat_snk;
+
+    struct {
+        uint32_t maxCur         : 7;
+        uint32_t rsvd1          : 1;
+        uint32_t minVolt        : 8;
+        uint32_t rsvd2          : 1;
+        uint32_t maxVolt        : 8;
+        uint32_t rsvd3          : 2;
+        uint32_t pwrLimited     : 1;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } pps_src;
+
+    struct {
+        uint32_t opCur          : 7;
+        uint32_t rsvd1          : 1;
+        uint32_t minVolt        : 8;
+        uint32_t rsvd2          : 1;
+        uint32_t maxVolt        : 8;
+        uint32_t rsvd3          : 3;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } pps_snk;
+
+    struct {
+        uint32_t maxCur2        : 10;
+        uint32_t maxCur1        : 10;
+        uint32_t rsvd1          : 6;
+        uint32_t peakCur        : 2;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } spr_avs_src;
+
+    struct {
+        uint32_t pdp            : 8;
+        uint32_t minVolt        : 8;
+        uint32_t rsvd1          : 1;
+        uint32_t maxVolt        : 9;
+        uint32_t peakCur        : 2;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } epr_avs_src;
+
+    struct {
+        uint32_t pdp            : 8;
+        uint32_t minVolt        : 8;
+        uint32_t rsvd1          : 1;
+        uint32_t maxVolt        : 9;
+        uint32_t rsvd2          : 2;
+        uint32_t apdoType       : 2;
+        uint32_t supplyType     : 2;
+    } epr_avs_snk;
+
+    struct {
+        uint32_t minMaxPowerCur : 10;
+        uint32_t opPowerCur     : 10;
+        uint32_t rsvd1          : 2;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t giveBackFlag   : 1;
+        uint32_t objPos         : 3;
+        uint32_t eprPdo         : 1;
+    } rdo_gen;
+
+    struct {
+        uint32_t opCur          : 7;
+        uint32_t rsvd1          : 2;
+        uint32_t outVolt        : 12;
+        uint32_t rsvd2          : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t rsvd3          : 1;
+        uint32_t objPos         : 4;
+    } rdo_pps;
+
+    struct {
+        uint32_t opCur          : 7;
+        uint32_t rsvd1          : 2;
+        uint32_t outVolt        : 12;
+        uint32_t rsvd2          : 1;
+        uint32_t eprModeCapable : 1;
+        uint32_t unchunkSup     : 1;
+        uint32_t noUsbSuspend   : 1;
+        uint32_t usbCommCap     : 1;
+        uint32_t capMismatch    : 1;
+        uint32_t rsvd3          : 1;
+        uint32_t objPos         : 4;
+    } rdo_spr_avs;
+
+    struct {
+        uint32_t rsvd1          : 5;
+        uint32_t vbusCur        : 2;
+        uint32_t rsvd2          : 25;
+    } std_cbl_vdo;
+} cy_pd_pd_do_t;
+
+typedef cy_pd_pd_do_t cy_pd_cbl_vdo_t;
+
+typedef union {
+    uint32_t val;
+    struct {
+        uint32_t msgType        : 5;
+        uint32_t dataRole       : 1;
+        uint32_t specRev        : 2;
+        uint32_t pwrRole        : 1;
+        uint32_t msgId          : 3;
+        uint32_t len            : 3;
+        uint32_t extd           : 1;
+        uint32_t dataSize       : 9;
+        uint32_t rsvd1          : 1;
+        uint32_t request        : 1;
+        uint32_t chunkNum       : 4;
+        uint32_t chunked        : 1;
+    } hdr;
+} cy_pd_pd_hdr_t;
+
+typedef struct {
+    uint8_t sop;
+    uint8_t len;
+    uint8_t msg;
+    uint8_t dataRole;
+    cy_pd_pd_hdr_t hdr;
+    cy_pd_pd_do_t dat[CY_PD_MAX_NO_OF_DO];
+} cy_stc_pdstack_pd_packet_t;
+
+/* Extended packet buffer. Shares the layout of cy_stc_pdstack_pd_packet_t. */
+typedef struct {
+    uint8_t sop;
+    uint8_t len;
+    uint8_t msg;
+    uint8_t dataRole;
+    cy_pd_pd_hdr_t hdr;
+    cy_pd_pd_do_t dat[CY_PD_MAX_EXTD_PKT_WORDS];
+} cy_stc_pdstack_pd_packet_extd_t;
+
+typedef struct {
+    uint8_t status;
+    uint8_t rdo_status;
+} cy_stc_pdstack_pd_contract_info_t;
+
+typedef struct {
+    uint16_t curPwr;
+    uint16_t maxVolt;
+    uint16_t minVolt;
+} cy_stc_pdstack_contract_t;
+
+typedef struct {
+    cy_stc_pdstack_pd_packet_t *srcCapP;
+    cy_pd_pd_do_t srcSelPdo;
+    cy_pd_pd_do_t snkRdo;
+    cy_pd_pd_do_t curSnkPdo[CY_PD_MAX_NO_OF_PDO];
+    uint8_t curSnkPdocount;
+    uint8_t snkPdoMask;
+    cy_stc_pdstack_contract_t contract;
+    cy_pd_cbl_vdo_t cblVdo;
+    bool emcaPresent;
+    bool snkUsbCommEn;
+    bool snkUsbSuspEn;
+    uint16_t dpmDefCableCap;
+} cy_stc_pdstack_dpm_status_t;
+
+typedef struct {
+    bool snkEnable;
+} cy_stc_pdstack_epr_cfg_t;
+
+typedef struct {
+    bool eprActive;
+    cy_stc_pdstack_epr_cfg_t epr;
+    cy_pd_pd_do_t curEprSnkPdo[CY_PD_MAX_NO_OF_EPR_PDO];
+    uint8_t curEprSnkPdoCount;
+} cy_stc_pdstack_dpm_ext_status_t;
+
+typedef struct {
+    bool attach;
+    bool contractExist;
+    bool vconnLogical;
+    uint8_t specRevSopLive;
+} cy_stc_pd_dpm_config_t;
+
+typedef struct {
+    uint8_t port;
+} cy_stc_usbpd_context_t;
+
+typedef struct {
+    uint8_t port;
+    cy_stc_usbpd_context_t *ptrUsbPdContext;
+    cy_stc_pdstack_dpm_status_t dpmStat;
+    cy_stc_pdstack_dpm_ext_status_t dpmExtStat;
+    cy_stc_pd_dpm_config_t dpmConfig;
+} cy_stc_pdstack_context_t;
+
+typedef struct {
+    cy_en_pd_sop_t cmdSop;
+    uint8_t noOfCmdDo;
+    cy_pd_pd_do_t cmdDo[CY_PD_MAX_NO_OF_DO];
+    uint8_t *datPtr;
+    uint16_t timeout;
+} cy_stc_pdstack_dpm_pd_cmd_buf_t;
+
+typedef void (*cy_pdstack_dpm_pd_cmd_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_resp_status_t resp, const cy_stc_pdstack_pd_packet_t *pkt);
+typedef void (*cy_pdstack_sink_discharge_off_cbk_t)(cy_stc_pdstack_context_t *ptrPdStackContext);
+typedef void (*cy_cb_timer_t)(cy_timer_id_t id, void *callbackContext);
+
+typedef struct {
+    uint32_t dummy;
+} cy_stc_pdutils_sw_timer_t;
+
+typedef enum {
+    BC_FSM_OFF = 0,
+    BC_FSM_SINK_START,
+    BC_FSM_SINK_APPLE_CHARGER_DETECT,
+    BC_FSM_SINK_APPLE_BRICK_ID_DETECT,
+    BC_FSM_SINK_PRIMARY_CHARGER_DETECT,
+    BC_FSM_SINK_TYPE_C_ONLY_SOURCE_CONNECTED,
+    BC_FSM_SINK_SECONDARY_CHARGER_DETECT,
+    BC_FSM_SINK_DCP_CONNECTED,
+    BC_FSM_SINK_SDP_CONNECTED,
+    BC_FSM_SINK_CDP_CONNECTED,
+    BC_FSM_SINK_AFC_CHARGER_DETECT,
+    BC_FSM_SINK_QC_CHARGER_DETECTED,
+} cy_en_bc_fsm_state_t;
+
+typedef enum {
+    BC_CHARGE_NONE = 0,
+    BC_CHARGE_DCP,
+    BC_CHARGE_QC2,
+    BC_CHARGE_QC3,
+    BC_CHARGE_AFC,
+    BC_CHARGE_APPLE,
+    BC_CHARGE_CDP,
+} cy_en_bc_charge_mode_t;
+
+typedef struct {
+    cy_en_bc_fsm_state_t bc_fsm_state;
+    bool connected;
+    cy_en_bc_charge_mode_t cur_mode;
+    uint16_t cur_volt;
+    uint16_t cur_amp;
+} cy_stc_bc_status_t;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+} host_systick_t;
+
+typedef struct {
+    uint32_t dummy;
+} CySCB_Type;
+
+typedef struct {
+    uint32_t dummy;
+} cy_stc_scb_uart_context_t;
+
+typedef struct {
+    uint32_t dummy;
+} cy_stc_scb_uart_config_t;
+
+typedef struct {
+    IRQn_Type intrSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+/*******************************************************************************
+ * Host model state. Tests set these to drive the application code.
+ ******************************************************************************/
+typedef struct {
+    uint8_t cmd;                                /**< DPM command */
+    uint8_t port;                               /**< Port of the command */
+    cy_stc_pdstack_dpm_pd_cmd_buf_t buf;        /**< Copy of the command buffer, if any */
+    cy_pdstack_dpm_pd_cmd_cbk_t cb;             /**< Response callback */
+} host_pd_cmd_t;
+
+#define HOST_PD_CMD_LOG_SIZE                    (64u)
+#define HOST_TIMER_CNT                          (32u)
+
+extern host_systick_t host_systick;
+extern CySCB_Type host_uart;
+extern const cy_stc_scb_uart_config_t CYBSP_UART_config;
+
+extern uint16_t host_wdt_count;
+extern uint16_t host_vbus_mv[2];
+/* Battery voltage returned by batt_chg_get_batt_volt */
+extern uint16_t host_batt_mv[2];
+extern bool host_dpm_idle;
+extern cy_en_pdstack_status_t host_send_status;
+extern host_pd_cmd_t host_pd_cmd_log[HOST_PD_CMD_LOG_SIZE];
+extern uint32_t host_pd_cmd_cnt;
+extern cy_stc_bc_status_t host_bc_status[2];
+/* Cy_App_Bc_Stop calls per port */
+extern uint32_t host_bc_stop_cnt[2];
+extern uint32_t host_flash_write_cnt;
+extern uint32_t host_flash_fail_at;
+extern uint32_t host_sink_enable_cnt[2];
+extern uint32_t host_sink_disable_cnt[2];
+extern uint32_t host_snk_cap_update_cnt;
+extern uint8_t host_uart_tx[4096];
+extern uint32_t host_uart_tx_len;
+extern uint32_t host_led_evt_cnt;
+/* Set while host_advance_ms runs a soft timer callback */
+extern bool host_in_timer_cb;
+/* VBUS ADC reads made from a soft timer callback */
+extern uint32_t host_isr_adc_cnt;
+/* host_advance_ms ticks in which a soft timer expired, i.e. tickless WDT interrupts */
+extern uint32_t host_wdt_isr_cnt;
+/* Longest of these ticks in ns of host time */
+extern uint64_t host_wdt_isr_max_ns;
+
+void host_assert_fail(const char *expr, const char *file, int line);
+void host_reset(void);
+/* Maps the flash onto a file, keeping its content; call again to power cycle */
+void host_flash_open(const char *path);
+/* Erases the flash, mapping it in memory if no file was opened */
+void host_flash_init(void);
+/* Forwards the UART output to a pseudo terminal; returns its master fd and
+ * the slave device name, -1 if the host has none */
+int host_uart_open_pty(char *name, size_t size);
+void host_uart_close_pty(void);
+/* Host monotonic clock in ns, for the benchmarks */
+uint64_t host_time_ns(void);
+void host_advance_ms(uint32_t ms);
+bool host_timer_running(cy_timer_id_t id);
+void host_timer_fire(cy_timer_id_t id);
+const host_pd_cmd_t *host_last_cmd(void);
+
+/*******************************************************************************
+ * SDK functions
+ ******************************************************************************/
+uint32_t Cy_SysLib_EnterCriticalSection(void);
+void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus);
+uint32_t Cy_SysClk_ClkSysGetFrequency(void);
+uint32_t Cy_WDT_GetCount(void);
+uint32_t Cy_WDT_GetMatch(void);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+int Cy_SysInt_Init(const cy_stc_sysint_t *config, void (*userIsr)(void));
+void Cy_GPIO_Write(void *base, uint32_t pinNum, uint32_t value);
+uint32_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t *data);
+
+int Cy_SCB_UART_Init(CySCB_Type *base, const cy_stc_scb_uart_config_t *config, cy_stc_scb_uart_context_t *context);
+void Cy_SCB_UART_Enable(CySCB_Type *base);
+uint32_t Cy_SCB_UART_PutArray(CySCB_Type *base, void *buffer, uint32_t size);
+bool Cy_SCB_UART_IsTxComplete(CySCB_Type const *base);
+void Cy_SCB_SetTxInterruptMask(CySCB_Type *base, uint32_t interruptMask);
+void Cy_SCB_ClearTxInterrupt(CySCB_Type *base, uint32_t interruptMask);
+
+void Cy_PdUtils_SwTimer_Start(cy_stc_pdutils_sw_timer_t *context, void *callbackContext, cy_timer_id_t id,
+        uint16_t period, cy_cb_timer_t cb);
+void Cy_PdUtils_SwTimer_Stop(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id);
+bool Cy_PdUtils_SwTimer_IsRunning(cy_stc_pdutils_sw_timer_t *context, cy_timer_id_t id);
+
+cy_en_pdstack_status_t Cy_PdStack_Dpm_SendPdCommand(cy_stc_pdstack_context_t *ptrPdStackContext,
+        cy_en_pdstack_dpm_pd_cmd_t cmd, cy_stc_pdstack_dpm_pd_cmd_buf_t *buf_ptr, bool noResp,
+        cy_pdstack_dpm_pd_cmd_cbk_t cmdCbk);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_IsIdle(cy_stc_pdstack_context_t *ptrPdStackContext, bool *isIdle);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSnkCap(cy_stc_pdstack_context_t *ptrPdStackContext,
+        uint8_t count, cy_pd_pd_do_t *pdo);
+cy_en_pdstack_status_t Cy_PdStack_Dpm_UpdateSnkCapMask(cy_stc_pdstack_context_t *ptrPdStackContext, uint8_t mask);
+
+uint16_t Cy_App_VbusGetValue(cy_stc_pdstack_context_t *context);
+void Cy_App_Sink_Enable(cy_stc_pdstack_context_t *context);
+void Cy_App_Sink_Disable(cy_stc_pdstack_context_t *context, cy_pdstack_sink_discharge_off_cbk_t snk_discharge_off_handler);
+const cy_stc_bc_status_t *Cy_App_Bc_GetStatus(cy_stc_usbpd_context_t *ptrUsbPdContext);
+cy_en_pdstack_status_t Cy_App_Bc_Stop(cy_stc_usbpd_context_t *ptrUsbPdContext);
+bool Cy_App_SystemSleep(cy_stc_pdstack_context_t *ptrPdStack0Context, cy_stc_pdstack_context_t *ptrPdStack1Context);
+
+#endif /* TEST_STUBS_HOST_SDK_H_ */
+
+/* [] END OF FILE */
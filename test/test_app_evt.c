@@ -0,0 +1,170 @@
+/*******************************************************************************
+* File Name: test_app_evt.c
+*
+* Description:
+*  Host test of the application event dispatch. Checks that the LED handler
+*  does not receive events before it is enabled by the deferred start of the
+*  non-critical tasks and that the instrumentation events reach the trace.
+*  Also reports the dispatch cost by number of subscribers.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "trace.h"
+#include "../src/app_evt.c"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Number of dispatches timed per event */
+#define BENCH_RUNS                              (20000u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: subscriber_cnt
+********************************************************************************
+* Summary:
+*  Returns the number of built and enabled handlers subscribed to an event
+*
+* Parameters:
+*  evt - Event ID
+*
+* Return:
+*  uint8_t - Number of handlers
+*
+*******************************************************************************/
+static uint8_t subscriber_cnt(uint32_t evt)
+{
+    uint16_t mask = gl_app_evt_table[evt] & gl_app_evt_active;
+    uint8_t cnt = 0u;
+    uint8_t slot;
+
+    for (slot = 0u; slot < APP_EVT_SLOT_COUNT; slot++)
+    {
+        if (((mask & APP_EVT_BIT(slot)) != 0u) && (gl_app_evt_handlers[slot] != NULL))
+        {
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
+/*******************************************************************************
+* Function Name: bench_dispatch
+********************************************************************************
+* Summary:
+*  Times app_evt_dispatch for every event and reports the average cost by
+*  number of subscribers, handler time included
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void bench_dispatch(cy_stc_pdstack_context_t *ctx)
+{
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+    uint64_t ns[APP_EVT_SLOT_COUNT + 1u] = { 0u };
+    uint32_t evt_cnt[APP_EVT_SLOT_COUNT + 1u] = { 0u };
+    uint64_t start;
+    uint32_t evt;
+    uint32_t i;
+    uint8_t n;
+
+    for (evt = 0u; evt < APP_EVT_TABLE_SIZE; evt++)
+    {
+        n = subscriber_cnt(evt);
+        start = host_time_ns();
+        for (i = 0u; i < BENCH_RUNS; i++)
+        {
+            app_evt_dispatch(ctx, (cy_en_pdstack_app_evt_t)evt, &ok);
+        }
+        ns[n] += host_time_ns() - start;
+        evt_cnt[n]++;
+    }
+
+    for (n = 0u; n <= APP_EVT_SLOT_COUNT; n++)
+    {
+        if (evt_cnt[n] != 0u)
+        {
+            printf("dispatch: %u subscribers, %u ns per event on the host (%u events)\n", n,
+                    (unsigned)(ns[n] / ((uint64_t)evt_cnt[n] * BENCH_RUNS)), (unsigned)evt_cnt[n]);
+        }
+    }
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+
+    host_reset();
+
+    /* No LED timer may be started before the first contract */
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+    CHECK_EQ(host_led_evt_cnt, 0u);
+
+    app_evt_enable(APP_EVT_SLOT_LED);
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    CHECK_EQ(host_led_evt_cnt, 1u);
+
+    /* Events without an LED subscription and invalid slots */
+    app_evt_dispatch(ctx, APP_EVT_SOFT_RESET_SENT, NULL);
+    app_evt_enable(APP_EVT_SLOT_COUNT);
+    CHECK_EQ(host_led_evt_cnt, 1u);
+
+    /* Instrumentation events are traced as faults */
+    app_evt_dispatch(ctx, (cy_en_pdstack_app_evt_t)(APP_TOTAL_EVENTS + 1u), NULL);
+    CHECK_EQ(trace_get_log()->rec[(trace_get_log()->count - 1u) % TRACE_BUF_DEPTH].id, TRACE_EVT_FAULT);
+    CHECK_EQ(trace_get_log()->rec[(trace_get_log()->count - 1u) % TRACE_BUF_DEPTH].arg0, APP_TOTAL_EVENTS + 1u);
+    CHECK_EQ(subscriber_cnt(APP_EVT_TABLE_SIZE - 1u), 1u);
+
+    bench_dispatch(ctx);
+
+    return TEST_RESULT("app_evt");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,262 @@
+/*******************************************************************************
+* File Name: test_batt_chg.c
+*
+* Description:
+*  Host test of direct battery charging against the simulated PPS source
+*  *  and a battery model: an open circuit voltage that rises with the charge,
+*  *  behind an internal resistance.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "pps_sim.h"
+#include "batt_chg.h"
+#include "sink_fet.h"
+#include "timestamp.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Battery internal resistance in mOhm */
+#define BATT_RES                                (200u)
+
+/* Charge (mA * ms) that raises the open circuit voltage by 1 uV */
+#define BATT_CHARGE_PER_UV                      (300u)
+
+/* Charge per uV of a battery that never fills */
+#define BATT_CHARGE_PER_UV_DEAD                 (0xFFFFFFFFu)
+
+/* Open circuit voltage at the start of the test in mV */
+#define BATT_START_VOLT                         (7000u)
+
+/* Simulation step in ms */
+#define BATT_STEP                               (100u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/* Open circuit voltage in uV */
+static uint32_t gl_batt_uv;
+
+/* Charge (mA * ms) per uV of the battery under test */
+static uint32_t gl_charge_per_uv;
+
+/* Highest voltage requested from the source in mV */
+static uint16_t gl_max_volt;
+
+/* Lowest VBUS above the open circuit voltage while charging in mV, negative
+ * when VBUS was below the battery */
+static int32_t gl_min_headroom;
+
+/*******************************************************************************
+* Function Name: batt_load
+********************************************************************************
+* Summary:
+*  Battery current at a VBUS voltage, 0 while the sink FET is latched off
+*
+* Parameters:
+*  volt - VBUS in mV
+*
+* Return:
+*  uint16_t - Current in mA
+*
+*******************************************************************************/
+static uint16_t batt_load(uint16_t volt)
+{
+    uint32_t ocv = gl_batt_uv / 1000u;
+
+    if (sink_fet_get_stat(0u)->latchedOff)
+    {
+        return 0u;
+    }
+
+    return (volt > ocv) ? (uint16_t)(((volt - ocv) * 1000u) / BATT_RES) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: batt_run
+********************************************************************************
+* Summary:
+*  Runs the charger and charges the battery with the current the source
+*  delivers. The battery voltage reads as the open circuit voltage.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  ms - Duration in ms
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void batt_run(cy_stc_pdstack_context_t *ctx, uint32_t ms)
+{
+    const stc_batt_chg_stat_t *stat = batt_chg_get_stat();
+    int32_t headroom;
+    uint16_t cur;
+
+    while (ms >= BATT_STEP)
+    {
+        host_batt_mv[0] = (uint16_t)(gl_batt_uv / 1000u);
+        pps_sim_run(ctx, BATT_STEP);
+        ms -= BATT_STEP;
+
+        cur = batt_load(pps_sim_volt);
+        if (cur > pps_sim_cur)
+        {
+            cur = pps_sim_cur;
+        }
+        gl_batt_uv += ((uint32_t)cur * BATT_STEP) / gl_charge_per_uv;
+        if (pps_sim_volt > gl_max_volt)
+        {
+            gl_max_volt = pps_sim_volt;
+        }
+        headroom = (int32_t)pps_sim_volt - (int32_t)(gl_batt_uv / 1000u);
+        if (((stat->state == BATT_CHG_CC) || (stat->state == BATT_CHG_CV)) && (headroom < gl_min_headroom))
+        {
+            gl_min_headroom = headroom;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: batt_charge
+********************************************************************************
+* Summary:
+*  Attaches the source and charges a battery until the cycle ends
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  volt - Open circuit voltage at attach in mV
+*  charge_per_uv - Charge (mA * ms) per uV of the battery
+*  max_s - Longest charge in s
+*
+* Return:
+*  uint32_t - Charge duration in s
+*
+*******************************************************************************/
+static uint32_t batt_charge(cy_stc_pdstack_context_t *ctx, uint16_t volt, uint32_t charge_per_uv, uint32_t max_s)
+{
+    const stc_batt_chg_stat_t *stat = batt_chg_get_stat();
+    uint32_t t;
+
+    gl_batt_uv = (uint32_t)volt * 1000u;
+    gl_charge_per_uv = charge_per_uv;
+    gl_max_volt = 0u;
+    gl_min_headroom = INT32_MAX;
+
+    pps_sim_attach(ctx);
+    for (t = 0u; (t < max_s) && ((stat->state == BATT_CHG_IDLE) ||
+                (stat->state == BATT_CHG_CC) || (stat->state == BATT_CHG_CV)); t++)
+    {
+        batt_run(ctx, 1000u);
+    }
+
+    return t;
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    const stc_batt_chg_stat_t *stat = batt_chg_get_stat();
+    uint32_t t;
+
+    host_reset();
+    pps_sim_load = batt_load;
+
+    t = batt_charge(ctx, BATT_START_VOLT, BATT_CHARGE_PER_UV, 3600u);
+
+    /* Charged to the termination voltage without exceeding the headroom */
+    CHECK_EQ(stat->state, BATT_CHG_DONE);
+    CHECK(t < (BATT_CHG_MAX_TIME * 60u));
+    CHECK(gl_batt_uv >= ((BATT_CHG_TERM_VOLT - ((BATT_CHG_TERM_CUR * BATT_RES) / 1000u)) * 1000u));
+    CHECK(gl_batt_uv <= (BATT_CHG_TERM_VOLT * 1000u));
+    CHECK(gl_max_volt <= (BATT_CHG_TERM_VOLT + BATT_CHG_VOLT_MARGIN));
+
+    /* The first PPS request starts above the battery and VBUS never drops
+     * below it while charging */
+    CHECK(gl_min_headroom >= 0);
+
+    /* Get_PPS_Status is never sent from the timer interrupt */
+    CHECK(pps_sim_status_cnt != 0u);
+    CHECK_EQ(pps_sim_isr_cmd_cnt, 0u);
+
+    /* Termination opens the FET through the sink disable path and the next
+     * sink enable of the stack leaves it open until detach */
+    CHECK_EQ(host_sink_disable_cnt[0], 1u);
+    CHECK(sink_fet_get_stat(0u)->latchedOff);
+    CHECK_EQ(sink_fet_get_stat(0u)->state, SINK_FET_OFF);
+    sink_fet_enable(ctx);
+    CHECK_EQ(host_sink_enable_cnt[0], 0u);
+    CHECK_EQ(sink_fet_get_stat(0u)->state, SINK_FET_OFF);
+    batt_run(ctx, 10u * PPS_REQ_TIMER);
+    CHECK_EQ(stat->state, BATT_CHG_DONE);
+    CHECK_EQ(host_sink_disable_cnt[0], 1u);
+
+    pps_sim_detach(ctx);
+    CHECK(!sink_fet_get_stat(0u)->latchedOff);
+    sink_fet_enable(ctx);
+    CHECK_EQ(host_sink_enable_cnt[0], 1u);
+
+    /* A source that does not report its output current ends CV */
+    pps_sim_cur_unsupp = true;
+    t = batt_charge(ctx, BATT_CHG_TERM_VOLT - 200u, BATT_CHARGE_PER_UV, 600u);
+    CHECK_EQ(stat->state, BATT_CHG_DONE);
+    CHECK(t < 600u);
+    CHECK(sink_fet_get_stat(0u)->latchedOff);
+    CHECK_EQ(host_sink_disable_cnt[0], 2u);
+    pps_sim_detach(ctx);
+    pps_sim_cur_unsupp = false;
+
+    /* A battery that never fills is stopped by the safety timer */
+    t = batt_charge(ctx, BATT_START_VOLT, BATT_CHARGE_PER_UV_DEAD, (BATT_CHG_MAX_TIME * 60u) + 60u);
+    CHECK_EQ(stat->state, BATT_CHG_TIMEOUT);
+    CHECK(t >= (BATT_CHG_MAX_TIME * 60u));
+    CHECK(t <= ((BATT_CHG_MAX_TIME * 60u) + (PPS_REQ_TIMER / 1000u) + 1u));
+    CHECK(TIMESTAMP_TICKS_TO_MS(stat->doneTs - stat->ccTs) >= (BATT_CHG_MAX_TIME * 60000u));
+    CHECK(sink_fet_get_stat(0u)->latchedOff);
+    CHECK_EQ(host_sink_disable_cnt[0], 3u);
+    CHECK(!host_timer_running((cy_timer_id_t)BATT_CHG_TIMER_ID));
+    CHECK(gl_min_headroom >= 0);
+    pps_sim_detach(ctx);
+
+    return TEST_RESULT("batt_chg");
+}
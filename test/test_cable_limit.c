@@ -0,0 +1,184 @@
+/*******************************************************************************
+* File Name: test_cable_limit.c
+*
+* Description:
+*  Host test of the cable current limit. Checks the default capability taken
+*  from the DPM parameters, the per port rating and the VCONN Swap requested
+*  before SOP' discovery when the source supplies VCONN, and that a hard
+*  reset or a detach does not leave an outstanding swap behind.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "app_evt.h"
+#include "cable_limit.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: attach
+********************************************************************************
+* Summary:
+*  Attaches a source with an explicit contract
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  vconn_src - Whether the sink is the VCONN source
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void attach(cy_stc_pdstack_context_t *ctx, bool vconn_src)
+{
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmConfig.vconnLogical = vconn_src;
+    ctx->dpmStat.emcaPresent = false;
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+}
+
+/*******************************************************************************
+* Function Name: vconn_swap_resp
+********************************************************************************
+* Summary:
+*  Answers the last VCONN Swap request
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  msg - Control message received in response
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void vconn_swap_resp(cy_stc_pdstack_context_t *ctx, uint8_t msg)
+{
+    cy_stc_pdstack_pd_packet_t pkt = { .msg = msg };
+
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP);
+    host_last_cmd()->cb(ctx, CY_PDSTACK_RES_RCVD, &pkt);
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint32_t cmd_cnt;
+
+    host_reset();
+
+    /* Cable without an eMarker: DPM default cable capability */
+    CHECK_EQ(cable_limit_get_max_cur(ctx), 3000u);
+    ctx->dpmStat.dpmDefCableCap = 500u;
+    CHECK_EQ(cable_limit_get_max_cur(ctx), 5000u);
+    ctx->dpmStat.dpmDefCableCap = 300u;
+
+    /* The rating is kept per port */
+    cable_limit_set_rating(0u, 2000u);
+    CHECK_EQ(cable_limit_get_max_cur(ctx), 2000u);
+    cable_limit_set_rating(NO_OF_TYPEC_PORTS, 1000u);
+    CHECK_EQ(cable_limit_get_max_cur(ctx), 2000u);
+    cable_limit_set_rating(0u, 0u);
+
+    /* VCONN source: discovery right away */
+    attach(ctx, true);
+    cable_limit_task(ctx);
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY);
+
+    /* Source supplies VCONN: swap first, then discovery */
+    attach(ctx, false);
+    cmd_cnt = host_pd_cmd_cnt;
+    cable_limit_task(ctx);
+    cable_limit_task(ctx);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt + 1u);
+    vconn_swap_resp(ctx, CY_PD_CTRL_MSG_ACCEPT);
+    ctx->dpmConfig.vconnLogical = true;
+    cable_limit_task(ctx);
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt + 2u);
+
+    /* Rejected swap: no discovery for this attach */
+    attach(ctx, false);
+    cable_limit_task(ctx);
+    vconn_swap_resp(ctx, CY_PD_CTRL_MSG_REJECT);
+    cmd_cnt = host_pd_cmd_cnt;
+    cable_limit_task(ctx);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+
+    /* Cable already discovered by the stack */
+    attach(ctx, false);
+    ctx->dpmStat.emcaPresent = true;
+    cable_limit_task(ctx);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+
+    /* Hard reset before the swap is answered: swap again with the new contract */
+    attach(ctx, false);
+    cable_limit_task(ctx);
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_SEND_VCONN_SWAP);
+    cmd_cnt = host_pd_cmd_cnt;
+    ctx->dpmConfig.contractExist = false;
+    app_evt_dispatch(ctx, APP_EVT_HARD_RESET_RCVD, NULL);
+    cable_limit_task(ctx);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+    ctx->dpmConfig.contractExist = true;
+    cable_limit_task(ctx);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt + 1u);
+    vconn_swap_resp(ctx, CY_PD_CTRL_MSG_ACCEPT);
+    ctx->dpmConfig.vconnLogical = true;
+    cable_limit_task(ctx);
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_INITIATE_CBL_DISCOVERY);
+
+    /* Detach cancels the discovery */
+    attach(ctx, false);
+    ctx->dpmConfig.contractExist = false;
+    ctx->dpmConfig.attach = false;
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+    ctx->dpmConfig.contractExist = true;
+    cmd_cnt = host_pd_cmd_cnt;
+    cable_limit_task(ctx);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+
+    return TEST_RESULT("cable_limit");
+}
+
+/* [] END OF FILE */
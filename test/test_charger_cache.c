@@ -0,0 +1,301 @@
+/*******************************************************************************
+* File Name: test_charger_cache.c
+*
+* Description:
+*  Host test of the charger fingerprint cache in src/pps.c. Learns the PPS
+*  operating point of a charger, resumes from it on the next attach, and
+*  checks that a cached operating point refused by the source or no longer
+*  valid for the sink is evicted and replaced by the 5V first contract. The
+*  charger is looked up once the SCEDB exchange is over, by its SPR source
+*  capabilities only.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "app_evt.h"
+#include "pps.h"
+#include "charger_cache.h"
+#include "src_cap_ext.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Identity reported in the SCEDB of the charger */
+#define CHARGER_VID                             (0x04B4u)
+#define CHARGER_PID                             (0x5678u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+
+static cy_stc_pdstack_pd_packet_t gl_src_cap;
+static cy_stc_pdstack_pd_packet_extd_t gl_epr_src_cap;
+
+/*******************************************************************************
+* Function Name: attach
+********************************************************************************
+* Summary:
+*  Attaches a 5 V 3 A fixed and 3.3-11 V 3 A PPS source and a sink with the
+*  same PDOs, and completes the first explicit contract
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void attach(cy_stc_pdstack_context_t *ctx)
+{
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+
+    gl_src_cap.len = 2u;
+    gl_src_cap.dat[0].val = 0x0001912Cu;
+    gl_src_cap.dat[1].val = 0xC0DC213Cu;
+    ctx->dpmStat.srcCapP = &gl_src_cap;
+    ctx->dpmStat.curSnkPdo[0].val = gl_src_cap.dat[0].val;
+    ctx->dpmStat.curSnkPdo[1].val = gl_src_cap.dat[1].val;
+    ctx->dpmStat.curSnkPdocount = 2u;
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV3;
+    ctx->dpmConfig.attach = true;
+
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    ctx->dpmConfig.contractExist = true;
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &ok);
+}
+
+/*******************************************************************************
+* Function Name: detach
+********************************************************************************
+* Summary:
+*  Detaches the source
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void detach(cy_stc_pdstack_context_t *ctx)
+{
+    ctx->dpmConfig.attach = false;
+    ctx->dpmConfig.contractExist = false;
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+}
+
+/*******************************************************************************
+* Function Name: run_pps
+********************************************************************************
+* Summary:
+*  Runs the PPS task once the PPS timer has expired
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint16_t - Voltage of the PPS request sent in mV, 0 if none was sent
+*
+*******************************************************************************/
+static uint16_t run_pps(void)
+{
+    uint32_t cmd_cnt = host_pd_cmd_cnt;
+
+    if (host_timer_running((cy_timer_id_t)PPS_TIMER_ID))
+    {
+        host_timer_fire((cy_timer_id_t)PPS_TIMER_ID);
+    }
+    pps_task();
+
+    if (host_pd_cmd_cnt == cmd_cnt)
+    {
+        return 0u;
+    }
+
+    /* PPS RDO output voltage in 20 mV units */
+    return (uint16_t)(((host_last_cmd()->buf.cmdDo[0].val >> 9u) & 0xFFFu) * 20u);
+}
+
+/*******************************************************************************
+* Function Name: complete
+********************************************************************************
+* Summary:
+*  Completes the pending contract negotiation
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  accept - true if the source accepts the request
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void complete(cy_stc_pdstack_context_t *ctx, bool accept)
+{
+    cy_stc_pdstack_pd_contract_info_t info;
+
+    info.status = accept ? CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL : CY_PDSTACK_CONTRACT_REJECT_CONTRACT_VALID;
+    info.rdo_status = 0u;
+    if (accept)
+    {
+        ctx->dpmStat.srcSelPdo = gl_src_cap.dat[1];
+    }
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &info);
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint32_t key;
+    uint32_t id_key;
+    stc_charger_entry_t exported[CHARGER_CACHE_SIZE];
+
+    host_reset();
+
+    /* Unknown charger without SCEDB: 5V first, then the sweep */
+    attach(ctx);
+    pps_set_charger_identity(ctx, 0u, 0u);
+    CHECK(!host_timer_running((cy_timer_id_t)PPS_TIMER_ID));
+    pps_timer_cb((cy_timer_id_t)PPS_TIMER_ID, ctx);
+    CHECK_EQ(run_pps(), VSAFE_5V);
+    complete(ctx, true);
+    CHECK_EQ(run_pps(), VSAFE_5V + PPS_STEP);
+    complete(ctx, true);
+    key = charger_cache_key(gl_src_cap.dat, 2u, 0u, 0u);
+    CHECK(charger_cache_lookup(key) != NULL);
+    CHECK_EQ(charger_cache_lookup(key)->volt, VSAFE_5V + PPS_STEP);
+    CHECK_EQ(charger_cache_lookup(key)->maxPpsVolt, 11000u);
+    detach(ctx);
+
+    /* Known charger: looked up once a PD 2.0 source is found to have no SCEDB, then requested at once */
+    attach(ctx);
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)PPS_TIMER_ID);
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV2;
+    src_cap_ext_task(ctx);
+    CHECK_EQ(src_cap_ext_get(ctx->port)->state, SRC_CAP_EXT_NOT_SUPP);
+    CHECK(host_timer_running((cy_timer_id_t)PPS_TIMER_ID));
+    CHECK_EQ(run_pps(), VSAFE_5V + PPS_STEP);
+    complete(ctx, true);
+    CHECK_EQ(run_pps(), VSAFE_5V + (2u * PPS_STEP));
+    complete(ctx, true);
+    detach(ctx);
+
+    /* The source rejects the cached point: evicted, then 5V without waiting for the PPS period */
+    attach(ctx);
+    pps_set_charger_identity(ctx, 0u, 0u);
+    CHECK_EQ(run_pps(), VSAFE_5V + (2u * PPS_STEP));
+    complete(ctx, false);
+    CHECK(charger_cache_lookup(key) == NULL);
+    CHECK_EQ(charger_cache_export(exported, CHARGER_CACHE_SIZE), 0u);
+    CHECK(pps_is_idle() == false);
+    CHECK_EQ(run_pps(), VSAFE_5V);
+    complete(ctx, true);
+    CHECK_EQ(run_pps(), VSAFE_5V + PPS_STEP);
+    complete(ctx, true);
+    detach(ctx);
+
+    /* The sink no longer supports the cached point: evicted before anything is sent */
+    attach(ctx);
+    pps_set_charger_identity(ctx, 0u, 0u);
+    ctx->dpmStat.curSnkPdocount = 1u;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(run_pps(), 0u);
+    CHECK(charger_cache_lookup(key) == NULL);
+    ctx->dpmStat.curSnkPdocount = 2u;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(run_pps(), VSAFE_5V);
+    detach(ctx);
+
+    /* Identified charger: the entry uses the full fingerprint */
+    attach(ctx);
+    pps_set_charger_identity(ctx, CHARGER_VID, CHARGER_PID);
+    pps_timer_cb((cy_timer_id_t)PPS_TIMER_ID, ctx);
+    CHECK_EQ(run_pps(), VSAFE_5V);
+    complete(ctx, true);
+    CHECK_EQ(run_pps(), VSAFE_5V + PPS_STEP);
+    complete(ctx, true);
+    id_key = charger_cache_key(gl_src_cap.dat, 2u, CHARGER_VID, CHARGER_PID);
+    CHECK(charger_cache_lookup(key) == NULL);
+    CHECK(charger_cache_lookup(id_key) != NULL);
+    CHECK_EQ(charger_cache_lookup(id_key)->volt, VSAFE_5V + PPS_STEP);
+    detach(ctx);
+
+    /* EPR mode entered before the SCEDB exchange: the lookup uses the SPR PDOs only */
+    attach(ctx);
+    Cy_PdUtils_SwTimer_Stop(&gl_TimerCtx, (cy_timer_id_t)PPS_TIMER_ID);
+    memset(&gl_epr_src_cap, 0, sizeof(gl_epr_src_cap));
+    gl_epr_src_cap.hdr.hdr.extd = 1u;
+    gl_epr_src_cap.hdr.hdr.dataSize = 8u * 4u;
+    gl_epr_src_cap.dat[0] = gl_src_cap.dat[0];
+    gl_epr_src_cap.dat[1] = gl_src_cap.dat[1];
+    gl_epr_src_cap.dat[7].val = 0x0008C1F4u;
+    ctx->dpmStat.srcCapP = (cy_stc_pdstack_pd_packet_t *)&gl_epr_src_cap;
+    ctx->dpmExtStat.eprActive = true;
+    pps_set_charger_identity(ctx, CHARGER_VID, CHARGER_PID);
+    CHECK(host_timer_running((cy_timer_id_t)PPS_TIMER_ID));
+    CHECK_EQ(run_pps(), VSAFE_5V + PPS_STEP);
+    ctx->dpmExtStat.eprActive = false;
+    ctx->dpmStat.srcCapP = &gl_src_cap;
+    complete(ctx, true);
+    CHECK_EQ(charger_cache_export(exported, CHARGER_CACHE_SIZE), 1u);
+    detach(ctx);
+
+    /* The PPS timer expires before the SCEDB exchange is over: the 5V contract is not remembered
+     * and nothing is looked up, the next contract is remembered under the full fingerprint */
+    attach(ctx);
+    pps_timer_cb((cy_timer_id_t)PPS_TIMER_ID, ctx);
+    CHECK_EQ(run_pps(), VSAFE_5V);
+    complete(ctx, true);
+    CHECK_EQ(charger_cache_export(exported, CHARGER_CACHE_SIZE), 1u);
+    pps_set_charger_identity(ctx, CHARGER_VID, CHARGER_PID + 1u);
+    id_key = charger_cache_key(gl_src_cap.dat, 2u, CHARGER_VID, CHARGER_PID + 1u);
+    CHECK(charger_cache_lookup(id_key) == NULL);
+    CHECK_EQ(run_pps(), VSAFE_5V + PPS_STEP);
+    complete(ctx, true);
+    CHECK_EQ(charger_cache_lookup(id_key)->volt, VSAFE_5V + PPS_STEP);
+    CHECK_EQ(charger_cache_export(exported, CHARGER_CACHE_SIZE), 2u);
+    detach(ctx);
+
+    return TEST_RESULT("charger_cache");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: test_cur_probe.c
+*
+* Description:
+*  Host test of the PPS current probing against the simulated PPS source.
+*  *  The load draws the requested current and the source enters current limit
+*  *  above its real capability; the probe must find that capability and only
+*  *  send Get_PPS_Status from the main loop.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "pps_sim.h"
+#include "cur_probe.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Current the simulated source really delivers in mA */
+#define SRC_CUR_MAX                             (2230u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: load_cur
+********************************************************************************
+* Summary:
+*  Load drawing the operating current of the contract
+*
+* Parameters:
+*  volt - Input voltage in mV
+*
+* Return:
+*  uint16_t - Input current in mA
+*
+*******************************************************************************/
+static uint16_t load_cur(uint16_t volt)
+{
+    (void)volt;
+    return pps_sim_cur;
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint16_t cur;
+
+    host_reset();
+    pps_sim_load = load_cur;
+    pps_sim_cur_max = SRC_CUR_MAX;
+
+    pps_sim_attach(ctx);
+    pps_sim_run(ctx, 60u * PPS_REQ_TIMER);
+
+    /* The probed current holds and is within the resolution of the real one */
+    cur = cur_probe_get(pps_sim_volt);
+    CHECK(cur <= SRC_CUR_MAX);
+    CHECK((cur + CUR_PROBE_RES) > SRC_CUR_MAX);
+    CHECK_EQ(pps_sim_cur, cur);
+
+    /* Get_PPS_Status is never sent from the timer interrupt */
+    CHECK(pps_sim_status_cnt != 0u);
+    CHECK_EQ(pps_sim_isr_cmd_cnt, 0u);
+
+    pps_sim_detach(ctx);
+    CHECK_EQ(cur_probe_get(pps_sim_volt), 0u);
+
+    return TEST_RESULT("cur_probe");
+}
@@ -0,0 +1,127 @@
+/*******************************************************************************
+* File Name: test_eff_search.c
+*
+* Description:
+*  Host test of the efficiency search against a plant model. The converter
+*  input power rises 6 mW per mV away from its most efficient input voltage;
+*  the search must converge to that voltage, follow it when it moves, and
+*  only send Get_PPS_Status from the main loop.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "pps_sim.h"
+#include "eff_search.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Converter input power at its most efficient input voltage in mW */
+#define PLANT_MIN_PWR                           (1500u)
+
+/* Input power increase per mV away from the most efficient voltage in mW */
+#define PLANT_SLOPE                             (6u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/* Most efficient input voltage of the plant in mV */
+static uint16_t gl_plant_opt_volt;
+
+/*******************************************************************************
+* Function Name: plant_load
+********************************************************************************
+* Summary:
+*  Converter input current
+*
+* Parameters:
+*  volt - Input voltage in mV
+*
+* Return:
+*  uint16_t - Input current in mA
+*
+*******************************************************************************/
+static uint16_t plant_load(uint16_t volt)
+{
+    uint32_t dist = (volt > gl_plant_opt_volt) ? (volt - gl_plant_opt_volt) : (gl_plant_opt_volt - volt);
+    uint32_t pwr = PLANT_MIN_PWR + (PLANT_SLOPE * dist);
+
+    return (uint16_t)((pwr * 1000u) / volt);
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    const stc_eff_search_stat_t *stat = eff_search_get_stat();
+
+    host_reset();
+    pps_sim_load = plant_load;
+    gl_plant_opt_volt = 5400u;
+
+    /* First run: up from 5 V */
+    pps_sim_attach(ctx);
+    pps_sim_run(ctx, 30000u);
+    CHECK_EQ(stat->state, EFF_SEARCH_HOLD);
+    CHECK_EQ(stat->runCnt, 1u);
+    CHECK_EQ(stat->bestVolt, 5400u);
+    CHECK_EQ(pps_sim_volt, 5400u);
+    CHECK(stat->bestPwr < stat->startPwr);
+    CHECK(pps_sim_status_cnt > stat->steps);
+
+    /* The optimum moves with the load: the next run follows it */
+    gl_plant_opt_volt = 5700u;
+    pps_sim_run(ctx, EFF_SEARCH_PERIOD + 30000u);
+    CHECK_EQ(stat->runCnt, 2u);
+    CHECK_EQ(stat->bestVolt, 5700u);
+    CHECK_EQ(pps_sim_volt, 5700u);
+
+    /* Get_PPS_Status is never sent from the timer interrupt */
+    CHECK_EQ(pps_sim_isr_cmd_cnt, 0u);
+
+    /* Detach drops the posted request */
+    pps_sim_detach(ctx);
+    CHECK_EQ(stat->state, EFF_SEARCH_IDLE);
+
+    return TEST_RESULT("eff_search");
+}
+
+/* [] END OF FILE */
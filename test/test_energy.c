@@ -0,0 +1,200 @@
+/*******************************************************************************
+* File Name: test_energy.c
+*
+* Description:
+*  Host test of the energy accounting. The Q32 conversion is checked against
+*  *  an exact reference, and the accounting is run against the simulated PPS
+*  *  source: the VBUS ADC is read from the main loop only, the PPS_Status current
+*  *  is polled at the sample rate and a stale reading falls back to the contract
+*  *  current.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "pps_sim.h"
+
+/* The static conversion and accumulators are checked directly */
+#include "../src/energy.c"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Sink current reported by the source in mA */
+#define LOAD_CUR                                (600u)
+
+/* Operating current of the contract in 10 mA units */
+#define CONTRACT_CUR                            (300u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: load_cur
+********************************************************************************
+* Summary:
+*  Constant current load
+*
+* Parameters:
+*  volt - Input voltage in mV
+*
+* Return:
+*  uint16_t - Input current in mA
+*
+*******************************************************************************/
+static uint16_t load_cur(uint16_t volt)
+{
+    (void)volt;
+    return LOAD_CUR;
+}
+
+/*******************************************************************************
+* Function Name: check_scale
+********************************************************************************
+* Summary:
+*  Compares energy_scale with the exact quotient. The Q32 factors are rounded
+*  to the nearest integer, which bounds their relative error to 1e-4, and the
+*  result is rounded as well.
+*
+* Parameters:
+*  acc - Accumulator
+*  scale - Q32 scale factor
+*  div - Exact divisor of the accumulator
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void check_scale(uint64_t acc, uint64_t scale, double div)
+{
+    double exact = (double)acc / div;
+    double got = (double)energy_scale(acc, scale);
+
+    CHECK((got <= (exact * 1.0001) + 1.0) && (got >= (exact * 0.9999) - 1.0));
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    stc_energy_snapshot_t snap;
+    uint64_t energy;
+    uint64_t charge;
+    uint64_t ref;
+    uint32_t i;
+
+    /* Q32 conversion: mV * mA samples to mWh, mA samples to mAh */
+    check_scale(0u, ENERGY_MWH_SCALE, 3600000.0);
+    check_scale(3599999u, ENERGY_MWH_SCALE, 3600000.0);
+    check_scale(3600000u, ENERGY_MWH_SCALE, 3600000.0);
+    check_scale(0xFFFFFFFFu, ENERGY_MWH_SCALE, 3600000.0);
+    check_scale(0x100000000u, ENERGY_MWH_SCALE, 3600000.0);
+    /* 48 V, 5 A for a week */
+    check_scale(48000ull * 5000u * 604800u, ENERGY_MWH_SCALE, 3600000.0);
+    check_scale(10000000000000000ull, ENERGY_MWH_SCALE, 3600000.0);
+    check_scale(3599u, ENERGY_MAH_SCALE, 3600.0);
+    check_scale(3600u, ENERGY_MAH_SCALE, 3600.0);
+    /* 5 A for a year */
+    check_scale(5000ull * 31536000u, ENERGY_MAH_SCALE, 3600.0);
+    CHECK_EQ(energy_scale(3600000u, ENERGY_MWH_SCALE), 1u);
+    CHECK_EQ(energy_scale(1799999u, ENERGY_MWH_SCALE), 0u);
+    CHECK_EQ(energy_scale(3600u, ENERGY_MAH_SCALE), 1u);
+
+    host_reset();
+    pps_sim_load = load_cur;
+    ctx->dpmStat.contract.curPwr = CONTRACT_CUR;
+
+    /* One hour under a PPS contract. The PPS module keeps moving the
+     * voltage, so the reference integrates VBUS as seen at each sample. */
+    pps_sim_attach(ctx);
+    pps_sim_run(ctx, 10u * ENERGY_SAMPLE_PERIOD);
+    CHECK_EQ(ctx->dpmStat.srcSelPdo.pps_src.apdoType, CY_PDSTACK_APDO_PPS);
+    energy = gl_energy_acc;
+    charge = gl_charge_acc;
+    ref = 0u;
+    for (i = 0u; i < 3600u; i++)
+    {
+        pps_sim_run(ctx, ENERGY_SAMPLE_PERIOD - 1u);
+        ref += (uint64_t)host_vbus_mv[0] * LOAD_CUR;
+        pps_sim_run(ctx, 1u);
+    }
+    CHECK_EQ(gl_energy_acc - energy, ref);
+    CHECK_EQ(gl_charge_acc - charge, (uint64_t)LOAD_CUR * 3600u);
+    check_scale(gl_energy_acc - energy, ENERGY_MWH_SCALE, 3600000.0);
+    CHECK_EQ(energy_scale(gl_charge_acc - charge, ENERGY_MAH_SCALE), LOAD_CUR);
+    energy_get_snapshot(&snap);
+    CHECK_EQ(snap.samples, 3610u);
+    CHECK(pps_sim_status_cnt >= 3610u);
+
+    /* No ADC read and no PD command from the timer interrupt */
+    CHECK_EQ(host_isr_adc_cnt, 0u);
+    CHECK_EQ(pps_sim_isr_cmd_cnt, 0u);
+
+    /* The source stops answering. A sample uses the status answered in the
+     * previous period, so the last reading is used for two more samples
+     * before the contract current takes over. */
+    pps_sim_status_mute = true;
+    charge = gl_charge_acc;
+    pps_sim_run(ctx, 2u * ENERGY_SAMPLE_PERIOD);
+    CHECK_EQ(gl_charge_acc - charge, 2u * LOAD_CUR);
+    pps_sim_run(ctx, ENERGY_SAMPLE_PERIOD);
+    CHECK_EQ(gl_charge_acc - charge, (2u * LOAD_CUR) + (CONTRACT_CUR * 10u));
+
+    /* Answers resume: the reported current is used from the next sample */
+    pps_sim_status_mute = false;
+    charge = gl_charge_acc;
+    pps_sim_run(ctx, 2u * ENERGY_SAMPLE_PERIOD);
+    CHECK_EQ(gl_charge_acc - charge, (CONTRACT_CUR * 10u) + LOAD_CUR);
+
+    /* A request without a callback, as posted by the user switch */
+    i = pps_sim_status_cnt;
+    pps_status_request(PPS_STATUS_REQ_SWITCH, NULL);
+    pps_sim_run(ctx, 1u);
+    CHECK_EQ(pps_sim_status_cnt, i + 1u);
+    CHECK(pps_get_status()->valid);
+
+    /* Detach clears the accounting */
+    pps_sim_detach(ctx);
+    energy_get_snapshot(&snap);
+    CHECK_EQ(snap.samples, 0u);
+    CHECK_EQ(snap.energy, 0u);
+
+    return TEST_RESULT("energy");
+}
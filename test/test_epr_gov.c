@@ -0,0 +1,451 @@
+/*******************************************************************************
+* File Name: test_epr_gov.c
+*
+* Description:
+*  Host test of the EPR AVS governor against a simulated EPR source. The
+*  source answers EPR mode entry by switching to its EPR capabilities, then
+*  accepts, rejects or ignores the AVS request and later exits EPR mode.
+*  Checks the AVS request, the fallbacks to SPR PPS, that the governor stays
+*  in fallback across a hard reset and that AVS contracts are not cached as
+*  PPS operating points.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "app_evt.h"
+#include "pps.h"
+#include "epr_gov.h"
+#include "charger_cache.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Object position of the AVS APDO in the EPR capabilities */
+#define SIM_AVS_POS                             (8u)
+
+/* Time taken by the simulated source to enter EPR mode in ms */
+#define SIM_ENTRY_DELAY                         (50u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/* SPR and EPR source capabilities of the simulated source */
+static cy_stc_pdstack_pd_packet_t gl_spr_cap;
+static cy_stc_pdstack_pd_packet_extd_t gl_epr_cap;
+
+/*******************************************************************************
+* Function Name: avs_pdo
+********************************************************************************
+* Summary:
+*  Builds an EPR AVS APDO
+*
+* Parameters:
+*  max_volt - Maximum voltage in mV
+*  pdp - PDP in W
+*
+* Return:
+*  uint32_t - APDO
+*
+*******************************************************************************/
+static uint32_t avs_pdo(uint16_t max_volt, uint8_t pdp)
+{
+    cy_pd_pd_do_t pdo = { .val = 0u };
+
+    pdo.epr_avs_src.supplyType = CY_PDSTACK_PDO_AUGMENTED;
+    pdo.epr_avs_src.apdoType = CY_PDSTACK_APDO_AVS;
+    pdo.epr_avs_src.minVolt = 150u;
+    pdo.epr_avs_src.maxVolt = max_volt / 100u;
+    pdo.epr_avs_src.pdp = pdp;
+    return pdo.val;
+}
+
+/*******************************************************************************
+* Function Name: sim_attach
+********************************************************************************
+* Summary:
+*  Attaches the simulated source with a 5 V 3 A fixed and a 3.3-11 V 3 A PPS
+*  PDO, and completes the first explicit contract at 5 V
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  epr_capable - Value of the EPR Mode Capable bit of the source
+*  avs_max_volt - Maximum voltage of the AVS APDO of the EPR capabilities in mV
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_attach(cy_stc_pdstack_context_t *ctx, bool epr_capable, uint16_t avs_max_volt)
+{
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+
+    memset(&gl_spr_cap, 0, sizeof(gl_spr_cap));
+    memset(&gl_epr_cap, 0, sizeof(gl_epr_cap));
+    gl_spr_cap.len = 2u;
+    gl_spr_cap.dat[0].val = 0x0001912Cu;
+    gl_spr_cap.dat[0].fixed_src.eprModeCapable = epr_capable;
+    gl_spr_cap.dat[1].val = 0xC0DC213Cu;
+
+    /* EPR capabilities: the SPR PDOs in positions 1 to 7, then the EPR PDOs */
+    gl_epr_cap.hdr.hdr.extd = 1u;
+    gl_epr_cap.hdr.hdr.dataSize = SIM_AVS_POS * 4u;
+    gl_epr_cap.dat[0] = gl_spr_cap.dat[0];
+    gl_epr_cap.dat[1] = gl_spr_cap.dat[1];
+    gl_epr_cap.dat[SIM_AVS_POS - 1u].val = avs_pdo(avs_max_volt, 140u);
+
+    ctx->dpmStat.srcCapP = &gl_spr_cap;
+    ctx->dpmStat.curSnkPdo[0].val = gl_spr_cap.dat[0].val;
+    ctx->dpmStat.curSnkPdo[1].val = gl_spr_cap.dat[1].val;
+    ctx->dpmStat.curSnkPdocount = 2u;
+    ctx->dpmExtStat.curEprSnkPdo[0].val = avs_pdo(48000u, 140u);
+    ctx->dpmExtStat.curEprSnkPdoCount = 1u;
+    ctx->dpmExtStat.epr.snkEnable = true;
+    ctx->dpmExtStat.eprActive = false;
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV3;
+    ctx->dpmConfig.attach = true;
+
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmStat.srcSelPdo = gl_spr_cap.dat[0];
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &ok);
+}
+
+/*******************************************************************************
+* Function Name: sim_epr_mode
+********************************************************************************
+* Summary:
+*  Enters or exits EPR mode on the simulated source. On entry the source sends
+*  its EPR capabilities.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  active - true to enter EPR mode
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_epr_mode(cy_stc_pdstack_context_t *ctx, bool active)
+{
+    ctx->dpmExtStat.eprActive = active;
+    ctx->dpmStat.srcCapP = active ? (cy_stc_pdstack_pd_packet_t *)&gl_epr_cap : &gl_spr_cap;
+}
+
+/*******************************************************************************
+* Function Name: sim_accept
+********************************************************************************
+* Summary:
+*  Accepts the last request sent to the simulated source
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_accept(cy_stc_pdstack_context_t *ctx)
+{
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+    uint8_t pos = (uint8_t)(host_last_cmd()->buf.cmdDo[0].val >> 28u);
+
+    ctx->dpmStat.srcSelPdo = ctx->dpmStat.srcCapP->dat[pos - 1u];
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &ok);
+}
+
+/*******************************************************************************
+* Function Name: sim_reject
+********************************************************************************
+* Summary:
+*  Rejects the last request sent to the simulated source; the previous
+*  contract stays valid
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_reject(cy_stc_pdstack_context_t *ctx)
+{
+    cy_stc_pdstack_pd_contract_info_t rej = { .status = CY_PDSTACK_CONTRACT_REJECT_CONTRACT_VALID };
+
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &rej);
+}
+
+/*******************************************************************************
+* Function Name: sim_enter_avs
+********************************************************************************
+* Summary:
+*  Attaches the simulated source, enters EPR mode and lets the governor send
+*  the AVS request
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_enter_avs(cy_stc_pdstack_context_t *ctx)
+{
+    sim_attach(ctx, true, 48000u);
+    epr_gov_task(ctx);
+    sim_epr_mode(ctx, true);
+    epr_gov_task(ctx);
+}
+
+/*******************************************************************************
+* Function Name: pps_sweep_sends
+********************************************************************************
+* Summary:
+*  Runs one PPS sweep step and checks whether it sent a request. The PPS
+*  timer runs from boot in the application.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  true if the PPS sweep sent a PD command
+*
+*******************************************************************************/
+static bool pps_sweep_sends(void)
+{
+    uint32_t cmd_cnt = host_pd_cmd_cnt;
+
+    if (host_timer_running((cy_timer_id_t)PPS_TIMER_ID))
+    {
+        host_timer_fire((cy_timer_id_t)PPS_TIMER_ID);
+    }
+    else
+    {
+        pps_timer_cb((cy_timer_id_t)PPS_TIMER_ID, &gl_PdStackPort0Ctx);
+    }
+    pps_task();
+    return (host_pd_cmd_cnt != cmd_cnt);
+}
+
+/*******************************************************************************
+* Function Name: sim_detach
+********************************************************************************
+* Summary:
+*  Detaches the simulated source
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void sim_detach(cy_stc_pdstack_context_t *ctx)
+{
+    sim_epr_mode(ctx, false);
+    ctx->dpmConfig.attach = false;
+    ctx->dpmConfig.contractExist = false;
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+}
+
+/*******************************************************************************
+* Function Name: max_cached_volt
+********************************************************************************
+* Summary:
+*  Returns the highest voltage held in the charger cache
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint16_t - Voltage in mV, 0 if the cache is empty
+*
+*******************************************************************************/
+static uint16_t max_cached_volt(void)
+{
+    stc_charger_entry_t entries[CHARGER_CACHE_SIZE];
+    uint8_t cnt = charger_cache_export(entries, CHARGER_CACHE_SIZE);
+    uint16_t volt = 0u;
+    uint8_t idx;
+
+    for (idx = 0u; idx < cnt; idx++)
+    {
+        if (entries[idx].volt > volt)
+        {
+            volt = entries[idx].volt;
+        }
+    }
+    return volt;
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    cy_stc_pdstack_pd_contract_info_t ok = { .status = CY_PDSTACK_CONTRACT_NEGOTIATION_SUCCESSFUL };
+    const host_pd_cmd_t *cmd;
+    uint32_t cmd_cnt;
+    uint32_t ms;
+
+    host_reset();
+
+    /* EPR capable source: entry, then the AVS request */
+    sim_attach(ctx, true, 48000u);
+    epr_gov_task(ctx);
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_SNK_EPR_MODE_ENTRY);
+    CHECK(epr_gov_is_active());
+    host_advance_ms(SIM_ENTRY_DELAY);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_ENTRY_PENDING);
+
+    sim_epr_mode(ctx, true);
+    epr_gov_task(ctx);
+    cmd = host_last_cmd();
+    CHECK_EQ(cmd->cmd, CY_PDSTACK_DPM_CMD_SEND_EPR_REQUEST);
+    CHECK_EQ(cmd->buf.noOfCmdDo, 2u);
+    CHECK_EQ(cmd->buf.cmdDo[0].val >> 28u, SIM_AVS_POS);
+    /* AVS output voltage in 25 mV units and operating current in 50 mA units */
+    CHECK_EQ((cmd->buf.cmdDo[0].val >> 9u) & 0xFFFu, EPR_GOV_TARGET_VOLT / 25u);
+    CHECK_EQ(cmd->buf.cmdDo[0].val & 0x7Fu, EPR_GOV_TARGET_CUR / 50u);
+    CHECK_EQ(cmd->buf.cmdDo[1].val, gl_epr_cap.dat[SIM_AVS_POS - 1u].val);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_AVS_REQUESTED);
+    CHECK_EQ(epr_gov_get_stat()->entryLatency, SIM_ENTRY_DELAY * TIMESTAMP_TICKS_PER_MS);
+    CHECK(epr_gov_is_active());
+
+    /* The AVS contract is in use only once the source has accepted it */
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_AVS_REQUESTED);
+    sim_accept(ctx);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_AVS_ACTIVE);
+
+    /* The AVS contract is not cached as a PPS operating point */
+    CHECK(max_cached_volt() <= 11000u);
+
+    /* The PPS sweep stays suspended while the AVS contract is held */
+    CHECK(!pps_sweep_sends());
+
+    /* EPR mode exit hands the contract back to the PPS sweep */
+    sim_epr_mode(ctx, false);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    CHECK_EQ(epr_gov_get_stat()->fallbackCnt, 1u);
+    CHECK(!epr_gov_is_active());
+    sim_detach(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_IDLE);
+
+    /* Source that never enters EPR mode */
+    sim_attach(ctx, true, 48000u);
+    epr_gov_task(ctx);
+    cmd_cnt = host_pd_cmd_cnt;
+    for (ms = 0u; ms < EPR_GOV_ENTRY_TIMEOUT; ms += 10u)
+    {
+        host_advance_ms(10u);
+        epr_gov_task(ctx);
+    }
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    CHECK_EQ(epr_gov_get_stat()->fallbackCnt, 2u);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+    sim_detach(ctx);
+
+    /* Source without the EPR Mode Capable bit: no entry attempt */
+    sim_attach(ctx, false, 48000u);
+    cmd_cnt = host_pd_cmd_cnt;
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+    sim_detach(ctx);
+
+    /* AVS APDO below the target voltage */
+    sim_attach(ctx, true, 30000u);
+    epr_gov_task(ctx);
+    sim_epr_mode(ctx, true);
+    cmd_cnt = host_pd_cmd_cnt;
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+    sim_detach(ctx);
+
+    /* Rejected AVS request: fall back and resume the PPS sweep */
+    sim_enter_avs(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_AVS_REQUESTED);
+    CHECK(!pps_sweep_sends());
+    sim_reject(ctx);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    CHECK(!epr_gov_is_active());
+    CHECK(pps_sweep_sends());
+    sim_detach(ctx);
+
+    /* AVS request answered with Wait: fall back on the timeout */
+    sim_enter_avs(ctx);
+    for (ms = 0u; ms < EPR_GOV_AVS_TIMEOUT; ms += 10u)
+    {
+        CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_AVS_REQUESTED);
+        host_advance_ms(10u);
+        epr_gov_task(ctx);
+    }
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    sim_detach(ctx);
+
+    /* Hard reset: EPR mode is exited and the governor stays in fallback */
+    sim_enter_avs(ctx);
+    sim_accept(ctx);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_AVS_ACTIVE);
+    sim_epr_mode(ctx, false);
+    app_evt_dispatch(ctx, APP_EVT_HARD_RESET_RCVD, NULL);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+
+    /* The SPR contract after the hard reset does not retry EPR mode entry */
+    cmd_cnt = host_pd_cmd_cnt;
+    ctx->dpmStat.srcSelPdo = gl_spr_cap.dat[0];
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &ok);
+    epr_gov_task(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_FALLBACK);
+    CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+    sim_detach(ctx);
+    CHECK_EQ(epr_gov_get_stat()->state, EPR_GOV_IDLE);
+
+    return TEST_RESULT("epr_gov");
+}
+
+/* [] END OF FILE */
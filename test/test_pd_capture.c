@@ -0,0 +1,454 @@
+/*******************************************************************************
+* File Name: test_pd_capture.c
+*
+* Description:
+*  Host test of the PD capture. Runs scripted sink sessions through the
+*  contract request path of src/pps.c and checks that every input of each
+*  evaluation is recorded: source and sink capabilities, cable limit, PDP
+*  limit, the selected object, the DPM status and the RDO. The capture is
+*  written to a file for the golden replay of test/capture_replay.c.
+*  
+*  Usage: test_pd_capture <capture output>
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "app_evt.h"
+#include "pps.h"
+#include "pd_capture.h"
+#include "cable_limit.h"
+#include "src_cap_ext.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+static cy_stc_pdstack_pd_packet_t gl_src_cap;
+static cy_stc_pdstack_pd_packet_extd_t gl_epr_src_cap;
+
+/*******************************************************************************
+* Function Name: fixed_pdo
+********************************************************************************
+* Summary:
+*  Builds a fixed supply source PDO
+*
+* Parameters:
+*  volt - Voltage in mV
+*  cur - Maximum current in mA
+*
+* Return:
+*  uint32_t - PDO
+*
+*******************************************************************************/
+static uint32_t fixed_pdo(uint16_t volt, uint16_t cur)
+{
+    cy_pd_pd_do_t pdo = { .val = 0u };
+
+    pdo.fixed_src.supplyType = CY_PDSTACK_PDO_FIXED_SUPPLY;
+    pdo.fixed_src.voltage = volt / 50u;
+    pdo.fixed_src.maxCurrent = cur / 10u;
+    return pdo.val;
+}
+
+/*******************************************************************************
+* Function Name: pps_pdo
+********************************************************************************
+* Summary:
+*  Builds a PPS APDO
+*
+* Parameters:
+*  min_volt - Minimum voltage in mV
+*  max_volt - Maximum voltage in mV
+*  cur - Maximum current in mA
+*
+* Return:
+*  uint32_t - APDO
+*
+*******************************************************************************/
+static uint32_t pps_pdo(uint16_t min_volt, uint16_t max_volt, uint16_t cur)
+{
+    cy_pd_pd_do_t pdo = { .val = 0u };
+
+    pdo.pps_src.supplyType = CY_PDSTACK_PDO_AUGMENTED;
+    pdo.pps_src.apdoType = CY_PDSTACK_APDO_PPS;
+    pdo.pps_src.minVolt = min_volt / 100u;
+    pdo.pps_src.maxVolt = max_volt / 100u;
+    pdo.pps_src.maxCur = cur / 50u;
+    return pdo.val;
+}
+
+/*******************************************************************************
+* Function Name: epr_avs_pdo
+********************************************************************************
+* Summary:
+*  Builds an EPR AVS APDO
+*
+* Parameters:
+*  min_volt - Minimum voltage in mV
+*  max_volt - Maximum voltage in mV
+*  pdp - PDP in W
+*
+* Return:
+*  uint32_t - APDO
+*
+*******************************************************************************/
+static uint32_t epr_avs_pdo(uint16_t min_volt, uint16_t max_volt, uint8_t pdp)
+{
+    cy_pd_pd_do_t pdo = { .val = 0u };
+
+    pdo.epr_avs_src.supplyType = CY_PDSTACK_PDO_AUGMENTED;
+    pdo.epr_avs_src.apdoType = CY_PDSTACK_APDO_AVS;
+    pdo.epr_avs_src.minVolt = min_volt / 100u;
+    pdo.epr_avs_src.maxVolt = max_volt / 100u;
+    pdo.epr_avs_src.pdp = pdp;
+    return pdo.val;
+}
+
+/*******************************************************************************
+* Function Name: last_request
+********************************************************************************
+* Summary:
+*  Returns the payload of the last request record in the capture, which may
+*  be followed by its repeat record
+*
+* Parameters:
+*  None
+*
+* Return:
+*  const uint8_t* - Payload, NULL if the last record is not a request
+*
+*******************************************************************************/
+static const uint8_t *last_request(void)
+{
+    const stc_pd_capture_t *cap = pd_capture_get();
+    uint16_t end = cap->len;
+
+    if ((end >= 4u) && (cap->buf[end - 4u] == PD_CAPTURE_REC_REPEAT))
+    {
+        end -= 4u;
+    }
+    if ((end < (2u + PD_CAPTURE_REQ_SIZE)) || (cap->buf[end - (2u + PD_CAPTURE_REQ_SIZE)] != PD_CAPTURE_REC_REQUEST))
+    {
+        return NULL;
+    }
+    return &cap->buf[end - PD_CAPTURE_REQ_SIZE];
+}
+
+/*******************************************************************************
+* Function Name: count_records
+********************************************************************************
+* Summary:
+*  Counts the records of one type in the capture
+*
+* Parameters:
+*  type - Record type
+*
+* Return:
+*  uint32_t - Number of records
+*
+*******************************************************************************/
+static uint32_t count_records(en_pd_capture_rec_t type)
+{
+    const stc_pd_capture_t *cap = pd_capture_get();
+    uint32_t count = 0u;
+    uint32_t pos;
+
+    for (pos = 0u; (pos + 2u) <= cap->len; pos += 2u + cap->buf[pos + 1u])
+    {
+        if (cap->buf[pos] == (uint8_t)type)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: request
+********************************************************************************
+* Summary:
+*  Requests a contract and checks the recorded limits and outcome
+*
+* Parameters:
+*  type - Supply type
+*  volt - Voltage in mV
+*  cur - Current in mA
+*  cable_cur - Expected cable limit in mA
+*  obj_pos - Expected object position
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void request(en_supply_type_t type, uint16_t volt, uint16_t cur, uint16_t cable_cur, uint8_t obj_pos)
+{
+    cy_en_pdstack_status_t status = pps_request_contract(type, volt, cur);
+    const uint8_t *rec = last_request();
+
+    CHECK(rec != NULL);
+    if (rec != NULL)
+    {
+        CHECK_EQ(rec[0] | (rec[1] << 8u), volt);
+        CHECK_EQ(rec[2] | (rec[3] << 8u), cur);
+        CHECK_EQ(rec[4] | (rec[5] << 8u), cable_cur);
+        CHECK_EQ(rec[8], (uint8_t)type);
+        CHECK_EQ(rec[9], obj_pos);
+        CHECK_EQ((int8_t)rec[10], (int8_t)status);
+    }
+}
+
+/*******************************************************************************
+* Function Name: deliver_scedb
+********************************************************************************
+* Summary:
+*  Answers the pending Get_Source_Cap_Extended with a source of the given PDP
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  pdp - SPR PDP in W
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void deliver_scedb(cy_stc_pdstack_context_t *ctx, uint8_t pdp)
+{
+    cy_stc_pdstack_pd_packet_t pkt;
+    uint8_t *scedb = (uint8_t *)&pkt.dat[0];
+    const host_pd_cmd_t *cmd;
+
+    src_cap_ext_task(ctx);
+    cmd = host_last_cmd();
+    CHECK((cmd != NULL) && (cmd->cmd == CY_PDSTACK_DPM_CMD_GET_SRC_CAP_EXTENDED));
+    if ((cmd == NULL) || (cmd->cb == NULL))
+    {
+        return;
+    }
+
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.hdr.hdr.extd = 1u;
+    pkt.hdr.hdr.dataSize = SRC_CAP_EXT_SCEDB_SIZE;
+    scedb[0] = 0xB4u;
+    scedb[1] = 0x04u;
+    scedb[2] = 0x34u;
+    scedb[3] = 0x12u;
+    scedb[23] = pdp;
+    cmd->cb(ctx, CY_PDSTACK_RES_RCVD, &pkt);
+    CHECK_EQ(src_cap_ext_get(ctx->port)->state, SRC_CAP_EXT_VALID);
+}
+
+/*******************************************************************************
+* Function Name: spr_session
+********************************************************************************
+* Summary:
+*  SPR session covering the cable limit, the PDP limit, an invalid request,
+*  a busy stack, a sink capabilities change and the PPS keepalive
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void spr_session(cy_stc_pdstack_context_t *ctx)
+{
+    const stc_pd_capture_t *cap = pd_capture_get();
+    const uint8_t *rec;
+    uint16_t len;
+    uint32_t idx;
+
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV3;
+    ctx->dpmStat.snkUsbCommEn = true;
+
+    ctx->dpmStat.curSnkPdo[0].val = fixed_pdo(5000u, 3000u);
+    ctx->dpmStat.curSnkPdo[1].val = pps_pdo(3300u, 21000u, 3000u);
+    ctx->dpmStat.curSnkPdocount = 2u;
+
+    gl_src_cap.len = 6u;
+    gl_src_cap.dat[0].val = fixed_pdo(5000u, 3000u);
+    gl_src_cap.dat[1].val = fixed_pdo(9000u, 3000u);
+    gl_src_cap.dat[2].val = fixed_pdo(15000u, 3000u);
+    gl_src_cap.dat[3].val = fixed_pdo(20000u, 2250u);
+    gl_src_cap.dat[4].val = pps_pdo(3300u, 11000u, 5000u);
+    gl_src_cap.dat[5].val = pps_pdo(3300u, 21000u, 3000u);
+    ctx->dpmStat.srcCapP = &gl_src_cap;
+
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+
+    request(FIXED_SUPPLY, 9000u, 3000u, 3000u, 2u);
+    request(PROGRAMMABLE_POWER_SUPPLY, 5000u, 2000u, 3000u, 6u);
+    request(PROGRAMMABLE_POWER_SUPPLY, 20000u, 3000u, 3000u, 6u);
+
+    /* Beyond every APDO of the source */
+    request(PROGRAMMABLE_POWER_SUPPLY, 25000u, 1000u, 3000u, 0u);
+
+    /* Identical capabilities are implied, not repeated */
+    CHECK_EQ(count_records(PD_CAPTURE_REC_SRC_CAP), 1u);
+    CHECK_EQ(count_records(PD_CAPTURE_REC_SNK_CAP), 1u);
+
+    /* 2 A cable */
+    cable_limit_set_rating(0u, 2000u);
+    request(PROGRAMMABLE_POWER_SUPPLY, 9000u, 3000u, 2000u, 6u);
+    cable_limit_set_rating(0u, 0u);
+
+    /* 27 W source */
+    deliver_scedb(ctx, 27u);
+    request(FIXED_SUPPLY, 15000u, 3000u, 3000u, 3u);
+    rec = last_request();
+    if (rec != NULL)
+    {
+        CHECK_EQ(rec[6] | (rec[7] << 8u), 1620u);
+    }
+
+    /* Stack busy */
+    host_send_status = CY_PDSTACK_STAT_BUSY;
+    request(FIXED_SUPPLY, 5000u, 1000u, 3000u, 1u);
+    host_send_status = CY_PDSTACK_STAT_SUCCESS;
+
+    /* Sink capabilities lowered at runtime */
+    ctx->dpmStat.curSnkPdo[1].val = pps_pdo(3300u, 11000u, 2000u);
+    pps_snk_cap_changed(ctx);
+    request(PROGRAMMABLE_POWER_SUPPLY, 9000u, 2000u, 3000u, 6u);
+
+    /* Half an hour of PPS keepalive requests costs one repeat record */
+    len = cap->len;
+    for (idx = 0u; idx < ((30u * 60u) / 2u); idx++)
+    {
+        request(PROGRAMMABLE_POWER_SUPPLY, 9000u, 2000u, 3000u, 6u);
+    }
+    CHECK_EQ(cap->len, len + 4u);
+    CHECK_EQ(cap->buf[cap->len - 4u], PD_CAPTURE_REC_REPEAT);
+    CHECK_EQ(cap->buf[cap->len - 2u] | (cap->buf[cap->len - 1u] << 8u), 900u);
+    CHECK_EQ(count_records(PD_CAPTURE_REC_SRC_CAP), 1u);
+    CHECK_EQ(count_records(PD_CAPTURE_REC_SNK_CAP), 2u);
+
+    request(PROGRAMMABLE_POWER_SUPPLY, 15000u, 2000u, 3000u, 0u);
+
+    ctx->dpmConfig.attach = false;
+    ctx->dpmConfig.contractExist = false;
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+}
+
+/*******************************************************************************
+* Function Name: epr_session
+********************************************************************************
+* Summary:
+*  EPR session with extended source capabilities and EPR sink PDOs
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void epr_session(cy_stc_pdstack_context_t *ctx)
+{
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV3;
+    ctx->dpmExtStat.epr.snkEnable = true;
+    ctx->dpmStat.emcaPresent = true;
+    ctx->dpmStat.cblVdo.std_cbl_vdo.vbusCur = CABLE_VDO_VBUS_CUR_5A;
+
+    ctx->dpmStat.curSnkPdo[0].val = fixed_pdo(5000u, 3000u);
+    ctx->dpmStat.curSnkPdo[1].val = fixed_pdo(20000u, 5000u);
+    ctx->dpmStat.curSnkPdocount = 2u;
+    ctx->dpmExtStat.curEprSnkPdo[0].val = fixed_pdo(28000u, 5000u);
+    ctx->dpmExtStat.curEprSnkPdo[1].val = epr_avs_pdo(15000u, 28000u, 140u);
+    ctx->dpmExtStat.curEprSnkPdoCount = 2u;
+
+    memset(&gl_epr_src_cap, 0, sizeof(gl_epr_src_cap));
+    gl_epr_src_cap.hdr.hdr.extd = 1u;
+    gl_epr_src_cap.hdr.hdr.dataSize = 10u * 4u;
+    gl_epr_src_cap.dat[0].val = fixed_pdo(5000u, 3000u);
+    gl_epr_src_cap.dat[1].val = fixed_pdo(9000u, 3000u);
+    gl_epr_src_cap.dat[2].val = fixed_pdo(15000u, 3000u);
+    gl_epr_src_cap.dat[3].val = fixed_pdo(20000u, 5000u);
+    gl_epr_src_cap.dat[7].val = fixed_pdo(28000u, 5000u);
+    gl_epr_src_cap.dat[8].val = epr_avs_pdo(15000u, 28000u, 140u);
+    ctx->dpmStat.srcCapP = (cy_stc_pdstack_pd_packet_t *)&gl_epr_src_cap;
+
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    ctx->dpmExtStat.eprActive = true;
+
+    request(FIXED_SUPPLY, 20000u, 5000u, 5000u, 4u);
+    request(FIXED_SUPPLY, 28000u, 5000u, 5000u, 8u);
+    request(EPR_ADJUSTABLE_VOLTAGE_SUPPLY, 24000u, 5000u, 5000u, 9u);
+
+    ctx->dpmExtStat.eprActive = false;
+    ctx->dpmConfig.attach = false;
+    ctx->dpmConfig.contractExist = false;
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    const stc_pd_capture_t *cap = pd_capture_get();
+    FILE *f;
+
+    host_reset();
+
+    spr_session(ctx);
+    epr_session(ctx);
+
+    CHECK_EQ(cap->magic, PD_CAPTURE_MAGIC);
+    CHECK_EQ(cap->dropped, 0u);
+
+    if (argc > 1)
+    {
+        f = fopen(argv[1], "wb");
+        CHECK(f != NULL);
+        if (f != NULL)
+        {
+            (void)fwrite(cap, 1u, sizeof(*cap), f);
+            fclose(f);
+        }
+    }
+
+    return TEST_RESULT("pd_capture");
+}
+
+/* [] END OF FILE */
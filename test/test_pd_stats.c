@@ -0,0 +1,135 @@
+/*******************************************************************************
+* File Name: test_pd_stats.c
+*
+* Description:
+*  Host test of the PD statistics counters: Requests of the stack and of
+*  the application, and keepalives detected from the full RDO.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "pps_sim.h"
+#include "pps.h"
+#include "app_evt.h"
+#include "pd_stats.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: request
+********************************************************************************
+* Summary:
+*  Requests a PPS operating point and lets the simulated source accept it
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  volt - Voltage in mV
+*  cur - Current in mA
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void request(cy_stc_pdstack_context_t *ctx, uint16_t volt, uint16_t cur)
+{
+    updatePPScontract((int16_t)volt, (int16_t)cur);
+    pps_sim_run(ctx, 1u);
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    cy_stc_pdstack_pd_contract_info_t reject = { .status = CY_PDSTACK_CONTRACT_REJECT_CONTRACT_VALID };
+    stc_pd_stats_t snap;
+    uint32_t keepalive;
+
+    host_reset();
+    pd_stats_clear(0u);
+
+    /* The Request of the stack to the first Source_Capabilities is counted */
+    pps_sim_attach(ctx);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.reqSent, 1u);
+    CHECK_EQ(snap.accept, 1u);
+    CHECK_EQ(snap.ppsKeepalive, 0u);
+
+    /* First PPS request of the PPS task */
+    pps_sim_run(ctx, 1u);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.reqSent, 2u);
+    CHECK_EQ(snap.accept, 2u);
+
+    /* Only a Request repeating the full RDO of the contract is a keepalive */
+    request(ctx, 9000u, 2000u);
+    pd_stats_get_snapshot(0u, &snap);
+    keepalive = snap.ppsKeepalive;
+    request(ctx, 9000u, 2000u);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.ppsKeepalive, keepalive + 1u);
+    request(ctx, 9000u, 1500u);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.ppsKeepalive, keepalive + 1u);
+    request(ctx, 9000u, 1500u);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.ppsKeepalive, keepalive + 2u);
+    CHECK_EQ(snap.reqSent, 6u);
+    CHECK_EQ(snap.accept, 6u);
+
+    /* A rejected Request is counted once and leaves the contract unchanged */
+    app_evt_dispatch(ctx, APP_EVT_PD_CONTRACT_NEGOTIATION_COMPLETE, &reject);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.reqSent, 7u);
+    CHECK_EQ(snap.reject, 1u);
+    request(ctx, 9000u, 1500u);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.ppsKeepalive, keepalive + 3u);
+
+    /* No contract after a detach: the first Request is not a keepalive */
+    pps_sim_detach(ctx);
+    pps_sim_attach(ctx);
+    request(ctx, 9000u, 1500u);
+    pd_stats_get_snapshot(0u, &snap);
+    CHECK_EQ(snap.ppsKeepalive, keepalive + 3u);
+    CHECK_EQ(snap.reqSent, 10u);
+
+    return TEST_RESULT("pd_stats");
+}
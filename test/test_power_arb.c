@@ -0,0 +1,117 @@
+/*******************************************************************************
+* File Name: test_power_arb.c
+*
+* Description:
+*  Host test of the power arbitration. Checks that a legacy charger is only
+*  detected once the battery charging block reports it connected, and the
+*  nominal power assumed for each charging mode.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "app_evt.h"
+#include "power_arb.h"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: detect
+********************************************************************************
+* Summary:
+*  Attaches a legacy charger and runs the arbitration task once
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  state - Battery charging state machine state
+*  connected - Whether a charger has been detected
+*  mode - Charging mode
+*  volt - Operating voltage in mV
+*  cur - Operating current in 10mA units
+*
+* Return:
+*  uint32_t - Legacy charging power in mW, 0 if no charger was detected
+*
+*******************************************************************************/
+static uint32_t detect(cy_stc_pdstack_context_t *ctx, cy_en_bc_fsm_state_t state, bool connected,
+        cy_en_bc_charge_mode_t mode, uint16_t volt, uint16_t cur)
+{
+    host_bc_status[0].bc_fsm_state = state;
+    host_bc_status[0].connected = connected;
+    host_bc_status[0].cur_mode = mode;
+    host_bc_status[0].cur_volt = volt;
+    host_bc_status[0].cur_amp = cur;
+
+    ctx->dpmConfig.attach = true;
+    host_advance_ms(1u);
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    host_advance_ms(5u);
+    power_arb_task(ctx);
+
+    return (power_arb_get_stat(0u)->legacyTtp != 0u) ? power_arb_get_stat(0u)->legacyPwr : 0u;
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+
+    host_reset();
+
+    /* Apple brick ID detection is still in progress */
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_APPLE_BRICK_ID_DETECT, false, BC_CHARGE_NONE, 0u, 0u), 0u);
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_SDP_CONNECTED, true, BC_CHARGE_NONE, 5000u, 50u), 0u);
+
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_DCP_CONNECTED, true, BC_CHARGE_DCP, 5000u, 150u), 7500u);
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_CDP_CONNECTED, true, BC_CHARGE_CDP, 5000u, 150u), 7500u);
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_DCP_CONNECTED, true, BC_CHARGE_APPLE, 5000u, 100u), 5000u);
+    CHECK_EQ(power_arb_get_stat(0u)->legacyMode, BC_CHARGE_APPLE);
+    CHECK_EQ(power_arb_get_stat(0u)->legacyTtp, 5u * TIMESTAMP_TICKS_PER_MS);
+
+    /* QC and AFC chargers are rated at their negotiated operating point */
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_QC_CHARGER_DETECTED, true, BC_CHARGE_QC2, 9000u, 200u), 18000u);
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_QC_CHARGER_DETECTED, true, BC_CHARGE_QC3, 7200u, 250u), 18000u);
+    CHECK_EQ(detect(ctx, BC_FSM_SINK_AFC_CHARGER_DETECT, true, BC_CHARGE_AFC, 0u, 0u), 7500u);
+
+    return TEST_RESULT("power_arb");
+}
+
+/* [] END OF FILE */
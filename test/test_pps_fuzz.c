@@ -0,0 +1,656 @@
+/*******************************************************************************
+* File Name: test_pps_fuzz.c
+*
+* Description:
+*  Host fuzz and boundary test of the contract request path of src/pps.c.
+*  Feeds source capabilities, SPR and EPR sink capabilities and requests of
+*  arbitrary content and length through pps_request_contract() and checks
+*  that every request sent stays within the received PDOs and matches the
+*  requested supply type. Built with the address and undefined behaviour
+*  sanitizers so that any out of bounds access aborts the test.
+*  
+*  Reports the inputs per second and which supply type, outcome and object
+*  position classes the run reached. Line coverage of src/pps.c is reported
+*  by "make -C test fuzz-cov".
+*
+*  The same input decoder is exposed as LLVMFuzzerTestOneInput when built
+*  with -DHOST_LIBFUZZER, which "make -C test fuzz" does with clang.
+*        test_pps_fuzz.c <all sources of src/> stubs/host_sdk.c
+*  
+*  Usage: test_pps_fuzz [iterations]
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "pps.h"
+#include "cable_limit.h"
+#include "snk_cap.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Default number of random inputs */
+#define FUZZ_ITER_CNT                           (100000u)
+
+/* Input layout: flags, source count, SPR and EPR sink counts, supply type,
+ * volt (2), cur (2), 13 source PDOs, 7 SPR and 6 EPR sink PDOs */
+#define FUZZ_HDR_SIZE                           (9u)
+#define FUZZ_INPUT_SIZE                         (FUZZ_HDR_SIZE + ((PPS_MAX_EPR_SRC_PDO_CNT + CY_PD_MAX_NO_OF_PDO + \
+                                                 CY_PD_MAX_NO_OF_EPR_PDO) * 4u))
+
+/* Flags byte of the input */
+#define FUZZ_FLAG_EPR_ACTIVE                    (0x01u)
+#define FUZZ_FLAG_EXTD                          (0x02u)
+#define FUZZ_FLAG_REV3                          (0x04u)
+#define FUZZ_FLAG_USB_COMM                      (0x08u)
+#define FUZZ_FLAG_BUSY                          (0x10u)
+
+/* Outcome classes reached per supply type: bit 0 rejected, bit 1 busy,
+ * bit 2 sent */
+#define FUZZ_COV_REJECTED                       (0x01u)
+#define FUZZ_COV_BUSY                           (0x02u)
+#define FUZZ_COV_SENT                           (0x04u)
+#define FUZZ_COV_OUTCOME_CNT                    (3u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+static cy_stc_pdstack_pd_packet_extd_t gl_src_cap;
+
+/* Supply types a request may ask for */
+static const en_supply_type_t gl_supply_types[] = {
+    FIXED_SUPPLY, BATTERY_SUPPLY, VARIABLE_SUPPLY, PROGRAMMABLE_POWER_SUPPLY,
+    EPR_ADJUSTABLE_VOLTAGE_SUPPLY, SPR_ADJUSTABLE_VOLTAGE_SUPPLY
+};
+
+#define FUZZ_SUPPLY_TYPE_CNT                    (sizeof(gl_supply_types) / sizeof(gl_supply_types[0]))
+
+/* Outcome classes reached per supply type and object positions sent */
+static uint8_t gl_cov_outcome[FUZZ_SUPPLY_TYPE_CNT];
+static uint16_t gl_cov_pos;
+
+/*******************************************************************************
+* Function Name: fuzz_byte
+********************************************************************************
+* Summary:
+*  Returns an input byte, zero beyond the end of a short input
+*
+* Parameters:
+*  data - Input
+*  size - Input length
+*  pos - Byte offset
+*
+* Return:
+*  uint8_t - Byte
+*
+*******************************************************************************/
+static uint8_t fuzz_byte(const uint8_t *data, size_t size, size_t pos)
+{
+    return (pos < size) ? data[pos] : 0u;
+}
+
+/*******************************************************************************
+* Function Name: fuzz_word
+********************************************************************************
+* Summary:
+*  Returns a little endian 32-bit input word
+*
+* Parameters:
+*  data - Input
+*  size - Input length
+*  pos - Byte offset
+*
+* Return:
+*  uint32_t - Word
+*
+*******************************************************************************/
+static uint32_t fuzz_word(const uint8_t *data, size_t size, size_t pos)
+{
+    return (uint32_t)fuzz_byte(data, size, pos) | ((uint32_t)fuzz_byte(data, size, pos + 1u) << 8u) |
+           ((uint32_t)fuzz_byte(data, size, pos + 2u) << 16u) | ((uint32_t)fuzz_byte(data, size, pos + 3u) << 24u);
+}
+
+/*******************************************************************************
+* Function Name: fuzz_one
+********************************************************************************
+* Summary:
+*  Runs one request built from the input and checks the request sent
+*
+* Parameters:
+*  data - Input, see FUZZ_INPUT_SIZE
+*  size - Input length
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void fuzz_one(const uint8_t *data, size_t size)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint8_t flags = fuzz_byte(data, size, 0u);
+    uint8_t src_cnt = fuzz_byte(data, size, 1u);
+    uint8_t type_idx = (uint8_t)(fuzz_byte(data, size, 4u) % FUZZ_SUPPLY_TYPE_CNT);
+    en_supply_type_t type = gl_supply_types[type_idx];
+    uint16_t volt = (uint16_t)(fuzz_byte(data, size, 5u) | (fuzz_byte(data, size, 6u) << 8u));
+    uint16_t cur = (uint16_t)(fuzz_byte(data, size, 7u) | (fuzz_byte(data, size, 8u) << 8u));
+    size_t pos = FUZZ_HDR_SIZE;
+    uint32_t cmd_cnt = host_pd_cmd_cnt;
+    uint8_t max_pos;
+    uint8_t idx;
+    cy_en_pdstack_status_t status;
+
+    memset(&gl_src_cap, 0, sizeof(gl_src_cap));
+    for (idx = 0u; idx < PPS_MAX_EPR_SRC_PDO_CNT; idx++, pos += 4u)
+    {
+        gl_src_cap.dat[idx].val = fuzz_word(data, size, pos);
+    }
+    for (idx = 0u; idx < CY_PD_MAX_NO_OF_PDO; idx++, pos += 4u)
+    {
+        ctx->dpmStat.curSnkPdo[idx].val = fuzz_word(data, size, pos);
+    }
+    for (idx = 0u; idx < CY_PD_MAX_NO_OF_EPR_PDO; idx++, pos += 4u)
+    {
+        ctx->dpmExtStat.curEprSnkPdo[idx].val = fuzz_word(data, size, pos);
+    }
+
+    /* Counts are taken as received, including values beyond the buffers */
+    gl_src_cap.len = src_cnt;
+    gl_src_cap.hdr.hdr.extd = ((flags & FUZZ_FLAG_EXTD) != 0u);
+    gl_src_cap.hdr.hdr.dataSize = (uint32_t)src_cnt * 4u;
+    ctx->dpmStat.curSnkPdocount = fuzz_byte(data, size, 2u);
+    ctx->dpmExtStat.curEprSnkPdoCount = fuzz_byte(data, size, 3u);
+    ctx->dpmExtStat.eprActive = ((flags & FUZZ_FLAG_EPR_ACTIVE) != 0u);
+    pps_snk_cap_changed(ctx);
+    ctx->dpmConfig.specRevSopLive = ((flags & FUZZ_FLAG_REV3) != 0u) ? CY_PD_REV3 : CY_PD_REV2;
+    ctx->dpmStat.snkUsbCommEn = ((flags & FUZZ_FLAG_USB_COMM) != 0u);
+    ctx->dpmStat.srcCapP = (cy_stc_pdstack_pd_packet_t *)&gl_src_cap;
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    host_send_status = ((flags & FUZZ_FLAG_BUSY) != 0u) ? CY_PDSTACK_STAT_BUSY : CY_PDSTACK_STAT_SUCCESS;
+
+    status = pps_request_contract(type, volt, cur);
+    host_send_status = CY_PDSTACK_STAT_SUCCESS;
+
+    if (status == CY_PDSTACK_STAT_SUCCESS)
+    {
+        gl_cov_outcome[type_idx] |= FUZZ_COV_SENT;
+    }
+    else if (status == CY_PDSTACK_STAT_BUSY)
+    {
+        gl_cov_outcome[type_idx] |= FUZZ_COV_BUSY;
+    }
+    else
+    {
+        gl_cov_outcome[type_idx] |= FUZZ_COV_REJECTED;
+    }
+
+    /* Highest object position the received message can hold */
+    max_pos = CY_PD_MAX_NO_OF_PDO;
+    if (ctx->dpmExtStat.eprActive && gl_src_cap.hdr.hdr.extd)
+    {
+        max_pos = PPS_MAX_EPR_SRC_PDO_CNT;
+    }
+    if (src_cnt < max_pos)
+    {
+        max_pos = src_cnt;
+    }
+
+    if (status != CY_PDSTACK_STAT_SUCCESS)
+    {
+        CHECK_EQ(host_pd_cmd_cnt, cmd_cnt);
+    }
+    else
+    {
+        const host_pd_cmd_t *cmd = host_last_cmd();
+        const cy_pd_pd_do_t *pdo;
+        uint8_t obj_pos;
+
+        CHECK_EQ(host_pd_cmd_cnt, cmd_cnt + 1u);
+        CHECK_EQ(cmd->cmd, ctx->dpmExtStat.eprActive ? CY_PDSTACK_DPM_CMD_SEND_EPR_REQUEST :
+                CY_PDSTACK_DPM_CMD_SEND_REQUEST);
+
+        obj_pos = (uint8_t)(cmd->buf.cmdDo[0].val >> 28u);
+        CHECK((obj_pos >= 1u) && (obj_pos <= max_pos));
+        if ((obj_pos >= 1u) && (obj_pos <= max_pos))
+        {
+            gl_cov_pos |= (uint16_t)(1u << (obj_pos - 1u));
+            pdo = &gl_src_cap.dat[obj_pos - 1u];
+            CHECK_EQ(pdo->fixed_src.supplyType, (uint32_t)type & PDO_MASK);
+            if (pdo->fixed_src.supplyType == CY_PDSTACK_PDO_AUGMENTED)
+            {
+                CHECK_EQ(pdo->pps_src.apdoType, (uint32_t)type >> 4u);
+            }
+            if (ctx->dpmExtStat.eprActive)
+            {
+                /* The EPR request carries a copy of the selected PDO */
+                CHECK_EQ(cmd->buf.cmdDo[1].val, pdo->val);
+            }
+        }
+    }
+}
+
+#if defined(HOST_LIBFUZZER)
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz_one(data, size);
+    if (gl_test_fail != 0u)
+    {
+        abort();
+    }
+    return 0;
+}
+#else
+
+/* State of the pseudo random sequence */
+static uint32_t gl_rand = 0x6C8E9CF5u;
+
+/*******************************************************************************
+* Function Name: next_rand
+********************************************************************************
+* Summary:
+*  Returns the next value of a fixed xorshift sequence
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Pseudo random value
+*
+*******************************************************************************/
+static uint32_t next_rand(void)
+{
+    gl_rand ^= gl_rand << 13u;
+    gl_rand ^= gl_rand >> 17u;
+    gl_rand ^= gl_rand << 5u;
+    return gl_rand;
+}
+
+/*******************************************************************************
+* Function Name: fixed_pdo
+********************************************************************************
+* Summary:
+*  Builds a fixed supply PDO
+*
+* Parameters:
+*  volt - Voltage in mV
+*  cur - Current in mA
+*
+* Return:
+*  uint32_t - PDO
+*
+*******************************************************************************/
+static uint32_t fixed_pdo(uint16_t volt, uint16_t cur)
+{
+    cy_pd_pd_do_t pdo = { .val = 0u };
+
+    pdo.fixed_src.supplyType = CY_PDSTACK_PDO_FIXED_SUPPLY;
+    pdo.fixed_src.voltage = volt / 50u;
+    pdo.fixed_src.maxCurrent = cur / 10u;
+    return pdo.val;
+}
+
+/*******************************************************************************
+* Function Name: pps_pdo
+********************************************************************************
+* Summary:
+*  Builds a PPS APDO
+*
+* Parameters:
+*  min_volt - Minimum voltage in mV
+*  max_volt - Maximum voltage in mV
+*  cur - Current in mA
+*
+* Return:
+*  uint32_t - APDO
+*
+*******************************************************************************/
+static uint32_t pps_pdo(uint16_t min_volt, uint16_t max_volt, uint16_t cur)
+{
+    cy_pd_pd_do_t pdo = { .val = 0u };
+
+    pdo.pps_src.supplyType = CY_PDSTACK_PDO_AUGMENTED;
+    pdo.pps_src.apdoType = CY_PDSTACK_APDO_PPS;
+    pdo.pps_src.minVolt = min_volt / 100u;
+    pdo.pps_src.maxVolt = max_volt / 100u;
+    pdo.pps_src.maxCur = cur / 50u;
+    return pdo.val;
+}
+
+/*******************************************************************************
+* Function Name: request_pos
+********************************************************************************
+* Summary:
+*  Requests a contract and returns the object position that was requested
+*
+* Parameters:
+*  type - Supply type
+*  volt - Voltage in mV
+*  cur - Current in mA
+*
+* Return:
+*  uint8_t - Object position, 0 if no request was sent
+*
+*******************************************************************************/
+static uint8_t request_pos(en_supply_type_t type, uint16_t volt, uint16_t cur)
+{
+    if (pps_request_contract(type, volt, cur) != CY_PDSTACK_STAT_SUCCESS)
+    {
+        return 0u;
+    }
+    return (uint8_t)(host_last_cmd()->buf.cmdDo[0].val >> 28u);
+}
+
+/*******************************************************************************
+* Function Name: setup
+********************************************************************************
+* Summary:
+*  Starts a boundary case from a 5 V / 20 V fixed and 3.3-21 V PPS source
+*  and a sink with the same PDOs
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void setup(cy_stc_pdstack_context_t *ctx)
+{
+    memset(&gl_src_cap, 0, sizeof(gl_src_cap));
+    memset(&ctx->dpmStat, 0, sizeof(ctx->dpmStat));
+    memset(&ctx->dpmExtStat, 0, sizeof(ctx->dpmExtStat));
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmConfig.specRevSopLive = CY_PD_REV3;
+
+    gl_src_cap.len = 3u;
+    gl_src_cap.dat[0].val = fixed_pdo(5000u, 3000u);
+    gl_src_cap.dat[1].val = fixed_pdo(20000u, 5000u);
+    gl_src_cap.dat[2].val = pps_pdo(3300u, 21000u, 5000u);
+    ctx->dpmStat.srcCapP = (cy_stc_pdstack_pd_packet_t *)&gl_src_cap;
+
+    ctx->dpmStat.curSnkPdo[0].val = fixed_pdo(5000u, 3000u);
+    ctx->dpmStat.curSnkPdo[1].val = fixed_pdo(20000u, 5000u);
+    ctx->dpmStat.curSnkPdo[2].val = pps_pdo(3300u, 21000u, 3000u);
+    ctx->dpmStat.curSnkPdocount = 3u;
+    pps_snk_cap_changed(ctx);
+}
+
+/*******************************************************************************
+* Function Name: test_boundaries
+********************************************************************************
+* Summary:
+*  Checks the PDO count clamps and the voltage and current bounds
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void test_boundaries(cy_stc_pdstack_context_t *ctx)
+{
+    cy_pd_pd_do_t pdo;
+    uint8_t idx;
+
+    /* 5 A cable so that the sink PDOs are the current limit */
+    cable_limit_set_rating(0u, 5000u);
+
+    /* No sink PDOs */
+    setup(ctx);
+    ctx->dpmStat.curSnkPdocount = 0u;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 5000u, 1000u), 0u);
+
+    /* Sink PDO count beyond the buffer clamps to the last SPR PDO */
+    setup(ctx);
+    ctx->dpmStat.curSnkPdo[6].val = fixed_pdo(20000u, 5000u);
+    ctx->dpmStat.curSnkPdo[1].val = 0u;
+    ctx->dpmStat.curSnkPdocount = 0xFFu;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 20000u, 5000u), 2u);
+
+    /* PPS voltage and current bounds are inclusive */
+    setup(ctx);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 3300u, 3000u), 3u);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 3250u, 3000u), 0u);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 21000u, 3000u), 3u);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 21050u, 3000u), 0u);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 9000u, 3010u), 0u);
+
+    /* A sink capability update applies to the next request */
+    setup(ctx);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 9000u, 3000u), 3u);
+    pdo.val = pps_pdo(3300u, 11000u, 2000u);
+    CHECK_EQ(snk_cap_begin(ctx), CY_PDSTACK_STAT_SUCCESS);
+    CHECK_EQ(snk_cap_set_pdo(ctx, 2u, pdo), CY_PDSTACK_STAT_SUCCESS);
+    CHECK_EQ(snk_cap_commit(ctx), CY_PDSTACK_STAT_SUCCESS);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 9000u, 3000u), 0u);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 9000u, 2000u), 3u);
+    CHECK_EQ(request_pos(PROGRAMMABLE_POWER_SUPPLY, 15000u, 2000u), 0u);
+
+    /* Source PDO counts */
+    setup(ctx);
+    gl_src_cap.len = 0u;
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 5000u, 1000u), 0u);
+    gl_src_cap.len = 0xFFu;
+    gl_src_cap.dat[6].val = fixed_pdo(20000u, 5000u);
+    gl_src_cap.dat[1].val = 0u;
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 20000u, 5000u), 7u);
+    gl_src_cap.dat[7].val = fixed_pdo(5000u, 3000u);
+    gl_src_cap.dat[0].val = 0u;
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 5000u, 1000u), 0u);
+
+    /* EPR sink PDOs are only used in EPR mode */
+    setup(ctx);
+    gl_src_cap.hdr.hdr.extd = 1u;
+    gl_src_cap.hdr.hdr.dataSize = PPS_MAX_EPR_SRC_PDO_CNT * 4u;
+    for (idx = 7u; idx < PPS_MAX_EPR_SRC_PDO_CNT; idx++)
+    {
+        gl_src_cap.dat[idx].val = fixed_pdo((uint16_t)(28000u + ((idx - 7u) * 4000u)), 5000u);
+    }
+    for (idx = 0u; idx < CY_PD_MAX_NO_OF_EPR_PDO; idx++)
+    {
+        ctx->dpmExtStat.curEprSnkPdo[idx].val = gl_src_cap.dat[7u + idx].val;
+    }
+    ctx->dpmExtStat.curEprSnkPdoCount = CY_PD_MAX_NO_OF_EPR_PDO;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 28000u, 5000u), 0u);
+
+    ctx->dpmExtStat.eprActive = true;
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 20000u, 5000u), 2u);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 28000u, 5000u), 8u);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 48000u, 5000u), 13u);
+    CHECK_EQ(host_last_cmd()->cmd, CY_PDSTACK_DPM_CMD_SEND_EPR_REQUEST);
+
+    /* EPR sink PDO count beyond the buffer clamps to the last EPR PDO */
+    ctx->dpmExtStat.curEprSnkPdoCount = 0xFFu;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 48000u, 5000u), 13u);
+    ctx->dpmExtStat.curEprSnkPdoCount = CY_PD_MAX_NO_OF_EPR_PDO - 1u;
+    pps_snk_cap_changed(ctx);
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 48000u, 5000u), 0u);
+
+    /* EPR source PDO count beyond the buffer clamps to 13 */
+    ctx->dpmExtStat.curEprSnkPdoCount = CY_PD_MAX_NO_OF_EPR_PDO;
+    pps_snk_cap_changed(ctx);
+    gl_src_cap.hdr.hdr.dataSize = 0x1FFu;
+    CHECK_EQ(request_pos(FIXED_SUPPLY, 48000u, 5000u), 13u);
+
+    cable_limit_set_rating(0u, 0u);
+}
+
+/*******************************************************************************
+* Function Name: report_coverage
+********************************************************************************
+* Summary:
+*  Prints the supply type and outcome classes and the object positions the
+*  run reached. A run of the default length must have both rejected and sent
+*  a request for every supply type.
+*
+* Parameters:
+*  iter_cnt - Number of inputs of the run
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void report_coverage(uint32_t iter_cnt)
+{
+    uint32_t classes = 0u;
+    uint32_t pos_cnt = 0u;
+    uint8_t idx;
+
+    for (idx = 0u; idx < FUZZ_SUPPLY_TYPE_CNT; idx++)
+    {
+        uint8_t bit;
+
+        for (bit = 0u; bit < FUZZ_COV_OUTCOME_CNT; bit++)
+        {
+            classes += ((gl_cov_outcome[idx] >> bit) & 1u);
+        }
+        if (iter_cnt >= FUZZ_ITER_CNT)
+        {
+            CHECK((gl_cov_outcome[idx] & (FUZZ_COV_REJECTED | FUZZ_COV_SENT)) == (FUZZ_COV_REJECTED | FUZZ_COV_SENT));
+        }
+    }
+    for (idx = 0u; idx < PPS_MAX_EPR_SRC_PDO_CNT; idx++)
+    {
+        pos_cnt += ((gl_cov_pos >> idx) & 1u);
+    }
+
+    printf("coverage: %u of %u supply type outcomes, %u of %u object positions\n", (unsigned)classes,
+            (unsigned)(FUZZ_SUPPLY_TYPE_CNT * FUZZ_COV_OUTCOME_CNT), (unsigned)pos_cnt,
+            (unsigned)PPS_MAX_EPR_SRC_PDO_CNT);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t input[FUZZ_INPUT_SIZE];
+    uint32_t iter_cnt = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : FUZZ_ITER_CNT;
+    uint32_t iter;
+    uint32_t sent = 0u;
+    uint64_t start;
+    uint64_t ns;
+    size_t idx;
+
+    host_reset();
+
+    test_boundaries(&gl_PdStackPort0Ctx);
+
+    start = host_time_ns();
+    for (iter = 0u; (iter < iter_cnt) && (gl_test_fail == 0u); iter++)
+    {
+        uint32_t cmd_cnt = host_pd_cmd_cnt;
+        size_t size = next_rand() % (sizeof(input) + 1u);
+
+        for (idx = 0u; idx < size; idx++)
+        {
+            input[idx] = (uint8_t)next_rand();
+        }
+
+        /* Bias half of the inputs towards small counts, mostly fixed PDOs and
+         * sink PDOs copied from the source so that requests are also
+         * accepted, not only rejected */
+        if ((iter & 1u) != 0u)
+        {
+            uint8_t src_cnt = (uint8_t)(1u + (next_rand() % PPS_MAX_EPR_SRC_PDO_CNT));
+            uint8_t snk_cnt = (uint8_t)(1u + (next_rand() % CY_PD_MAX_NO_OF_PDO));
+            uint8_t epr_cnt = (uint8_t)(next_rand() % (CY_PD_MAX_NO_OF_EPR_PDO + 1u));
+            uint8_t snk_idx;
+            size_t snk;
+            uint16_t volt;
+
+            size = sizeof(input);
+            input[1] = src_cnt;
+            input[2] = snk_cnt;
+            input[3] = epr_cnt;
+            for (idx = 0u; idx < PPS_MAX_EPR_SRC_PDO_CNT; idx++)
+            {
+                if ((next_rand() % 4u) != 0u)
+                {
+                    input[FUZZ_HDR_SIZE + (idx * 4u) + 3u] &= 0x3Fu;
+                }
+            }
+            for (idx = PPS_MAX_EPR_SRC_PDO_CNT; idx < (PPS_MAX_EPR_SRC_PDO_CNT + 13u); idx++)
+            {
+                memcpy(&input[FUZZ_HDR_SIZE + (idx * 4u)],
+                        &input[FUZZ_HDR_SIZE + ((next_rand() % src_cnt) * 4u)], 4u);
+            }
+
+            /* Request the voltage of a sink PDO at a low current */
+            snk_idx = (uint8_t)(next_rand() % (snk_cnt + epr_cnt));
+            if (snk_idx >= snk_cnt)
+            {
+                snk_idx = (uint8_t)(CY_PD_MAX_NO_OF_PDO + (snk_idx - snk_cnt));
+            }
+            snk = FUZZ_HDR_SIZE + ((PPS_MAX_EPR_SRC_PDO_CNT + snk_idx) * 4u);
+            volt = (uint16_t)((((uint32_t)input[snk + 1u] >> 2u) | (((uint32_t)input[snk + 2u] & 0x0Fu) << 6u)) * 50u);
+            input[4] = 0u;
+            input[5] = (uint8_t)volt;
+            input[6] = (uint8_t)(volt >> 8u);
+            input[7] = 10u;
+            input[8] = 0u;
+        }
+
+        fuzz_one(input, size);
+        if (host_pd_cmd_cnt != cmd_cnt)
+        {
+            sent++;
+        }
+    }
+
+    ns = host_time_ns() - start;
+    printf("%u inputs in %u ms, %u execs/s\n", (unsigned)iter, (unsigned)(ns / 1000000u),
+            (unsigned)(((uint64_t)iter * 1000000000u) / ((ns != 0u) ? ns : 1u)));
+
+    /* The run must have exercised the accepting path as well */
+    CHECK(sent > (iter_cnt / 20u));
+    report_coverage(iter_cnt);
+
+    return TEST_RESULT("pps_fuzz");
+}
+#endif /* HOST_LIBFUZZER */
+
+/* [] END OF FILE */
@@ -0,0 +1,335 @@
+/*******************************************************************************
+* File Name: test_profile_store.c
+*
+* Description:
+*  Host test of the profile store on an emulated flash. Checks that the
+*  snapshot is written while the PD stack is idle, also during a contract,
+*  that the dirty state survives a failed write, that rows are used round
+*  robin, and that a torn or corrupted row falls back to the previous
+*  snapshot. When a file is given, the flash is backed by it and the store is
+*  restored across a simulated power cycle. Also reports the flash wear of a
+*  day long session and the time taken by profile_store_init.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "profile_store.h"
+#include "charger_cache.h"
+#include "timestamp.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* First row of the store, as placed by profile_store.c */
+#define STORE_ADDR                              (CY_FLASH_BASE + CY_FLASH_SIZE - \
+                                                 (PROFILE_STORE_ROW_COUNT * CY_FLASH_SIZEOF_ROW))
+
+/* Number of snapshots written by the wear levelling check */
+#define WEAR_WRITE_CNT                          (4u * PROFILE_STORE_ROW_COUNT)
+
+/* Erase cycles guaranteed per flash row */
+#define FLASH_ENDURANCE                         (100000u)
+
+/* Length of the simulated endurance session in s */
+#define SESSION_TIME                            (24u * 3600u)
+
+/* Number of profile_store_init calls timed by the boot time benchmark */
+#define BOOT_RUNS                               (10000u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: row_seq
+********************************************************************************
+* Summary:
+*  Returns the sequence number stored in a row of the store
+*
+* Parameters:
+*  row - Row index
+*
+* Return:
+*  uint32_t - Sequence number, 0 for an erased row
+*
+*******************************************************************************/
+static uint32_t row_seq(uint8_t row)
+{
+    const uint8_t *p = (const uint8_t *)(uintptr_t)(STORE_ADDR + ((uint32_t)row * CY_FLASH_SIZEOF_ROW));
+
+    return (uint32_t)p[4] | ((uint32_t)p[5] << 8u) | ((uint32_t)p[6] << 16u) | ((uint32_t)p[7] << 24u);
+}
+
+/*******************************************************************************
+* Function Name: wait_interval
+********************************************************************************
+* Summary:
+*  Lets the write interval of the store elapse
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void wait_interval(void)
+{
+    uint32_t ms;
+
+    /* Read the timestamp at least once per WDT counter period */
+    for (ms = 0u; ms <= PROFILE_STORE_WRITE_INTERVAL; ms += 1000u)
+    {
+        host_advance_ms(1000u);
+        (void)timestamp_get_ticks();
+    }
+}
+
+/*******************************************************************************
+* Function Name: learn
+********************************************************************************
+* Summary:
+*  Stores an operating point for a charger and marks the cache dirty
+*
+* Parameters:
+*  key - Charger fingerprint
+*  volt - Voltage in mV
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void learn(uint32_t key, uint16_t volt)
+{
+    stc_charger_entry_t *entry = charger_cache_insert(key);
+
+    entry->volt = volt;
+    entry->cur = 2000u;
+    profile_store_mark_dirty();
+}
+
+/*******************************************************************************
+* Function Name: bench_endurance
+********************************************************************************
+* Summary:
+*  Changes the cache every second of a day long contract and reports the
+*  resulting row writes and the flash lifetime they leave
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void bench_endurance(cy_stc_pdstack_context_t *ctx)
+{
+    uint32_t writes = host_flash_write_cnt;
+    uint32_t per_row;
+    uint32_t s;
+
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    for (s = 0u; s < SESSION_TIME; s++)
+    {
+        learn(0x4444u, (uint16_t)(5000u + ((s % 100u) * 20u)));
+        host_advance_ms(1000u);
+        profile_store_task(ctx);
+    }
+    writes = host_flash_write_cnt - writes;
+    per_row = (writes + PROFILE_STORE_ROW_COUNT - 1u) / PROFILE_STORE_ROW_COUNT;
+
+    /* Bounded by the write interval whatever the rate of changes */
+    CHECK(writes <= (((SESSION_TIME * 1000u) / PROFILE_STORE_WRITE_INTERVAL) + 1u));
+    CHECK(writes != 0u);
+    printf("endurance: %u row writes in %u h, %u per row, %u days to %u cycles\n",
+            (unsigned)writes, SESSION_TIME / 3600u, (unsigned)per_row,
+            (unsigned)(FLASH_ENDURANCE / per_row), FLASH_ENDURANCE);
+}
+
+/*******************************************************************************
+* Function Name: bench_boot
+********************************************************************************
+* Summary:
+*  Reports the time taken by profile_store_init with every row valid
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void bench_boot(void)
+{
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+
+    start = host_time_ns();
+    for (i = 0u; i < BOOT_RUNS; i++)
+    {
+        profile_store_init();
+    }
+    ns = (host_time_ns() - start) / BOOT_RUNS;
+    printf("boot: profile_store_init checks %u rows of %u bytes in %u ns on the host\n",
+            PROFILE_STORE_ROW_COUNT, CY_FLASH_SIZEOF_ROW, (unsigned)ns);
+}
+
+int main(int argc, char **argv)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    stc_charger_entry_t entries[CHARGER_CACHE_SIZE];
+    uint32_t hits[PROFILE_STORE_ROW_COUNT] = { 0u };
+    uint32_t seq;
+    uint32_t i;
+    uint8_t row;
+
+    host_reset();
+    if (argc > 1)
+    {
+        host_flash_open(argv[1]);
+    }
+    host_flash_init();
+    profile_store_init();
+    CHECK_EQ(charger_cache_export(entries, CHARGER_CACHE_SIZE), 0u);
+
+    /* Busy stack during a contract: deferred */
+    ctx->dpmConfig.attach = true;
+    ctx->dpmConfig.contractExist = true;
+    host_dpm_idle = false;
+    learn(0x1111u, 9000u);
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 0u);
+
+    /* Idle between AMSs: written once, without waiting for detach */
+    host_dpm_idle = true;
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 1u);
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 1u);
+
+    /* A failed write stays pending and is retried after the interval */
+    learn(0x2222u, 15000u);
+    host_flash_fail_at = 2u;
+    wait_interval();
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 2u);
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 2u);
+    wait_interval();
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 3u);
+    host_flash_fail_at = 0u;
+
+    /* An unchanged cache is not written again */
+    profile_store_mark_dirty();
+    wait_interval();
+    profile_store_task(ctx);
+    CHECK_EQ(host_flash_write_cnt, 3u);
+
+    /* Restored after a reset */
+    charger_cache_import(NULL, 0u);
+    profile_store_init();
+    CHECK_EQ(charger_cache_export(entries, CHARGER_CACHE_SIZE), 2u);
+    CHECK(charger_cache_lookup(0x2222u) != NULL);
+
+    /* Round robin over the rows */
+    for (i = 0u; i < WEAR_WRITE_CNT; i++)
+    {
+        learn(0x3333u, (uint16_t)(5000u + (i * 100u)));
+        wait_interval();
+        profile_store_task(ctx);
+    }
+    CHECK_EQ(host_flash_write_cnt, 3u + WEAR_WRITE_CNT);
+    seq = 0u;
+    for (row = 0u; row < PROFILE_STORE_ROW_COUNT; row++)
+    {
+        hits[row] = row_seq(row);
+        if (hits[row] > seq)
+        {
+            seq = hits[row];
+        }
+    }
+    for (row = 0u; row < PROFILE_STORE_ROW_COUNT; row++)
+    {
+        /* The rows hold the last PROFILE_STORE_ROW_COUNT sequence numbers */
+        CHECK((seq - hits[row]) < PROFILE_STORE_ROW_COUNT);
+    }
+
+    /* A torn newest row falls back to the previous snapshot */
+    for (row = 0u; row < PROFILE_STORE_ROW_COUNT; row++)
+    {
+        if (row_seq(row) == seq)
+        {
+            uint8_t *p = (uint8_t *)(uintptr_t)(STORE_ADDR + ((uint32_t)row * CY_FLASH_SIZEOF_ROW));
+
+            p[CY_FLASH_SIZEOF_ROW / 2u] ^= 0x5Au;
+        }
+    }
+    profile_store_init();
+    CHECK_EQ(charger_cache_lookup(0x3333u)->volt, 5000u + ((WEAR_WRITE_CNT - 2u) * 100u));
+
+    /* The next snapshot goes after the newest valid one and outranks the torn row */
+    learn(0x3333u, 20000u);
+    wait_interval();
+    profile_store_task(ctx);
+    charger_cache_import(NULL, 0u);
+    profile_store_init();
+    CHECK_EQ(charger_cache_lookup(0x3333u)->volt, 20000u);
+
+    /* Power cycle: the store is read back from the flash file */
+    if (argc > 1)
+    {
+        charger_cache_import(NULL, 0u);
+        host_flash_open(argv[1]);
+        profile_store_init();
+        CHECK_EQ(charger_cache_lookup(0x3333u)->volt, 20000u);
+        CHECK(charger_cache_lookup(0x2222u) != NULL);
+    }
+
+    bench_endurance(ctx);
+    bench_boot();
+
+    return TEST_RESULT("profile_store");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,434 @@
+/*******************************************************************************
+* File Name: test_rdo.c
+*
+* Description:
+*  Host test of the RDO encoding in pps_build_rdo(). Checks a table of known
+*  source PDO / voltage / current vectors, and compares randomized requests
+*  against a reference encoder written from the bit positions of the spec
+*  and against the encoder as it was before the AVS voltage fix. Reports the
+*  number of randomized vectors checked per second.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "pps.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Number of randomized requests */
+#define RDO_RANDOM_CNT                          (200000u)
+
+/* Output voltage field of the PPS and AVS RDOs */
+#define RDO_OUT_VOLT_POS                        (9u)
+#define RDO_OUT_VOLT_MASK                       (0xFFFu)
+
+/* Source PDOs: 5 V 3 A, 9 V 3 A and 28 V 5 A fixed, 15-21 V 15 W battery,
+ * PPS 3.3-21 V 3 A, SPR AVS 3 A, EPR AVS 15-28 V 140 W and 9-20 V 2 A variable */
+#define PDO_FIXED_5V                            (0x0001912Cu)
+#define PDO_FIXED_9V                            (0x0002D12Cu)
+#define PDO_FIXED_28V                           (0x0008C1F4u)
+#define PDO_BATTERY                             (0x5A44B03Cu)
+#define PDO_PPS                                 (0xC1A4213Cu)
+#define PDO_SPR_AVS                             (0xE004B12Cu)
+#define PDO_EPR_AVS                             (0xD230968Cu)
+#define PDO_VARIABLE                            (0x9902D0C8u)
+
+/*****************************************************************************
+ * Data struct definition
+ ****************************************************************************/
+/* Known encoding vector */
+typedef struct {
+    uint32_t pdo;                            /* Selected source PDO */
+    uint8_t objPos;                          /* Object position, 1 based */
+    uint16_t volt;                           /* Voltage in 50 mV */
+    uint16_t cur;                            /* Current in 10 mA */
+    uint8_t rev;                             /* Spec revision of the contract */
+    bool usbComm;                            /* USB communication capable */
+    bool noUsbSusp;                          /* No USB suspend */
+    bool eprCapable;                         /* EPR mode capable */
+    uint32_t rdo;                            /* Expected RDO */
+} stc_rdo_vector_t;
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+static const stc_rdo_vector_t gl_rdo_vectors[] = {
+    /* Fixed 5 V 3 A, PD 2.0 */
+    { PDO_FIXED_5V,   1u, 100u, 300u, CY_PD_REV2, false, false, false, 0x1004B12Cu },
+    /* Fixed 9 V 2 A with the USB flags */
+    { PDO_FIXED_9V,   2u, 180u, 200u, CY_PD_REV3, true,  true,  false, 0x238320C8u },
+    /* Battery 15 V 1 A is 15 W, 60 in 250 mW units */
+    { PDO_BATTERY,    3u, 300u, 100u, CY_PD_REV3, false, false, false, 0x3080F03Cu },
+    /* PPS 5 V 2 A */
+    { PDO_PPS,        6u, 100u, 200u, CY_PD_REV3, true,  false, false, 0x6281F428u },
+    /* PPS 9.05 V encodes 9.04 V in 20 mV units */
+    { PDO_PPS,        6u, 181u, 300u, CY_PD_REV3, false, false, false, 0x6083883Cu },
+    /* SPR AVS 12 V 3 A */
+    { PDO_SPR_AVS,    5u, 240u, 300u, CY_PD_REV3, false, false, false, 0x5083C03Cu },
+    /* SPR AVS 12.05 V rounds down to 12 V */
+    { PDO_SPR_AVS,    5u, 241u, 300u, CY_PD_REV3, false, false, false, 0x5083C03Cu },
+    /* EPR AVS 24 V 5 A, object position 9 */
+    { PDO_EPR_AVS,    9u, 480u, 500u, CY_PD_REV3, false, false, true,  0x90C78064u },
+    /* EPR AVS 24.15 V rounds down to 24.1 V */
+    { PDO_EPR_AVS,    9u, 483u, 500u, CY_PD_REV3, false, false, true,  0x90C78864u },
+    /* EPR fixed 28 V 5 A, object position 8 */
+    { PDO_FIXED_28V,  8u, 560u, 500u, CY_PD_REV3, true,  false, true,  0x82C7D1F4u },
+};
+
+/* State of the pseudo random sequence */
+static uint32_t gl_rand = 0x2545F491u;
+
+/*******************************************************************************
+* Function Name: next_rand
+********************************************************************************
+* Summary:
+*  Returns the next value of a fixed xorshift sequence
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Pseudo random value
+*
+*******************************************************************************/
+static uint32_t next_rand(void)
+{
+    gl_rand ^= gl_rand << 13u;
+    gl_rand ^= gl_rand >> 17u;
+    gl_rand ^= gl_rand << 5u;
+    return gl_rand;
+}
+
+/*******************************************************************************
+* Function Name: is_avs
+********************************************************************************
+* Summary:
+*  Checks for an SPR or EPR AVS APDO
+*
+* Parameters:
+*  pdo - Source PDO
+*
+* Return:
+*  true for an AVS APDO
+*
+*******************************************************************************/
+static bool is_avs(uint32_t pdo)
+{
+    return ((pdo >> 30u) == CY_PDSTACK_PDO_AUGMENTED) &&
+           ((((pdo >> 28u) & 0x3u) == CY_PDSTACK_APDO_AVS) || (((pdo >> 28u) & 0x3u) == CY_PDSTACK_APDO_SPR_AVS));
+}
+
+/*******************************************************************************
+* Function Name: ref_build_rdo
+********************************************************************************
+* Summary:
+*  Reference encoder written from the RDO bit positions of the PD 3.1 spec
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  pdo - Selected source PDO
+*  obj_pos - Object position, 1 based
+*  volt - Voltage in 50 mV
+*  cur - Current in 10 mA
+*
+* Return:
+*  uint32_t - RDO
+*
+*******************************************************************************/
+static uint32_t ref_build_rdo(const cy_stc_pdstack_context_t *ctx, uint32_t pdo, uint8_t obj_pos,
+                              uint16_t volt, uint16_t cur)
+{
+    uint32_t rdo = (uint32_t)obj_pos << 28u;
+    uint32_t power;
+
+    rdo |= (uint32_t)ctx->dpmStat.snkUsbCommEn << 25u;
+    rdo |= (uint32_t)ctx->dpmStat.snkUsbSuspEn << 24u;
+    if (ctx->dpmConfig.specRevSopLive >= CY_PD_REV3)
+    {
+        rdo |= 1uL << 23u;
+        rdo |= (uint32_t)ctx->dpmExtStat.epr.snkEnable << 22u;
+    }
+
+    switch (pdo >> 30u)
+    {
+        case CY_PDSTACK_PDO_BATTERY:
+            /* Operating and maximum power in 250 mW */
+            power = (((uint32_t)volt * cur) + 499u) / 500u;
+            rdo |= (power << 10u) | power;
+            break;
+        case CY_PDSTACK_PDO_AUGMENTED:
+            if (is_avs(pdo))
+            {
+                /* Output voltage in 25 mV with bits 1:0 zero, current in 50 mA */
+                rdo |= ((((uint32_t)volt * 2u) & 0xFFCu) << 9u) | (cur / 5u);
+            }
+            else
+            {
+                /* Output voltage in 20 mV, current in 50 mA */
+                rdo |= ((((uint32_t)volt * 5u) / 2u) << 9u) | (cur / 5u);
+            }
+            break;
+        default:
+            /* Operating and maximum current in 10 mA */
+            rdo |= ((uint32_t)cur << 10u) | cur;
+            break;
+    }
+
+    return rdo;
+}
+
+/*******************************************************************************
+* Function Name: legacy_build_rdo
+********************************************************************************
+* Summary:
+*  The RDO encoding of send_request before the AVS voltage fix, which wrote
+*  the 25 mV AVS output voltage without clearing its two low bits
+*
+* Parameters:
+*  context - PD Stack Context
+*  pdo_src - Selected source PDO
+*  pdo_no - Object position, 1 based
+*  volt - Voltage in 50 mV
+*  cur - Current in 10 mA
+*
+* Return:
+*  cy_pd_pd_do_t - RDO
+*
+*******************************************************************************/
+static cy_pd_pd_do_t legacy_build_rdo(const cy_stc_pdstack_context_t *context, const cy_pd_pd_do_t *pdo_src,
+                                      uint8_t pdo_no, uint16_t volt, uint16_t cur)
+{
+    cy_pd_pd_do_t snkRdo;
+
+    snkRdo.val = 0u;
+    snkRdo.rdo_gen.noUsbSuspend = context->dpmStat.snkUsbSuspEn;
+    snkRdo.rdo_gen.usbCommCap = context->dpmStat.snkUsbCommEn;
+    snkRdo.rdo_gen.capMismatch = 0u;
+    if(pdo_no > CY_PD_MAX_NO_OF_PDO)
+    {
+        snkRdo.rdo_gen.eprPdo = true;
+    }
+    snkRdo.rdo_gen.objPos = (pdo_no & CY_PD_MAX_NO_OF_PDO);
+
+    if(pdo_src->fixed_src.supplyType != CY_PDSTACK_PDO_AUGMENTED)
+    {
+        snkRdo.rdo_gen.giveBackFlag = false;
+        if(pdo_src->fixed_src.supplyType == CY_PDSTACK_PDO_BATTERY)
+        {
+            uint16_t power = CY_PDUTILS_DIV_ROUND_UP(volt * cur, 500);
+            snkRdo.rdo_gen.opPowerCur = power;
+            snkRdo.rdo_gen.minMaxPowerCur = power;
+        }
+        else
+        {
+            snkRdo.rdo_gen.opPowerCur = cur;
+            snkRdo.rdo_gen.minMaxPowerCur = cur;
+        }
+    }
+    else
+    {
+        if((pdo_src->spr_avs_src.apdoType == CY_PDSTACK_APDO_SPR_AVS) ||
+           (pdo_src->epr_avs_src.apdoType == CY_PDSTACK_APDO_AVS))
+        {
+            snkRdo.rdo_spr_avs.outVolt = volt * 2u;
+            snkRdo.rdo_spr_avs.opCur = cur / 5u;
+        }
+        else if(pdo_src->pps_src.apdoType == CY_PDSTACK_APDO_PPS)
+        {
+            snkRdo.rdo_pps.outVolt = (uint16_t)(volt * 25)/10;
+            snkRdo.rdo_pps.opCur = cur / 5u;
+        }
+    }
+
+    if (context->dpmConfig.specRevSopLive >= CY_PD_REV3)
+    {
+        snkRdo.rdo_gen.unchunkSup = true;
+        snkRdo.rdo_gen.eprModeCapable = context->dpmExtStat.epr.snkEnable;
+    }
+
+    return snkRdo;
+}
+
+/*******************************************************************************
+* Function Name: set_flags
+********************************************************************************
+* Summary:
+*  Sets the context fields that the encoder reads
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  rev - Spec revision
+*  usb_comm - USB communication capable
+*  no_usb_susp - No USB suspend
+*  epr_capable - EPR mode capable
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void set_flags(cy_stc_pdstack_context_t *ctx, uint8_t rev, bool usb_comm, bool no_usb_susp, bool epr_capable)
+{
+    ctx->dpmConfig.specRevSopLive = rev;
+    ctx->dpmStat.snkUsbCommEn = usb_comm;
+    ctx->dpmStat.snkUsbSuspEn = no_usb_susp;
+    ctx->dpmExtStat.epr.snkEnable = epr_capable;
+}
+
+/*******************************************************************************
+* Function Name: test_vectors
+********************************************************************************
+* Summary:
+*  Checks the known vectors against the encoder and the reference encoder
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void test_vectors(cy_stc_pdstack_context_t *ctx)
+{
+    uint32_t idx;
+
+    for (idx = 0u; idx < (sizeof(gl_rdo_vectors) / sizeof(gl_rdo_vectors[0])); idx++)
+    {
+        const stc_rdo_vector_t *vec = &gl_rdo_vectors[idx];
+        cy_pd_pd_do_t pdo;
+
+        pdo.val = vec->pdo;
+        set_flags(ctx, vec->rev, vec->usbComm, vec->noUsbSusp, vec->eprCapable);
+        CHECK_EQ(pps_build_rdo(ctx, &pdo, vec->objPos, vec->volt, vec->cur).val, vec->rdo);
+        CHECK_EQ(ref_build_rdo(ctx, vec->pdo, vec->objPos, vec->volt, vec->cur), vec->rdo);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_differential
+********************************************************************************
+* Summary:
+*  Compares randomized requests against the reference and legacy encoders.
+*  The legacy encoder must agree everywhere except in the two low bits of
+*  the AVS output voltage.
+*
+* Parameters:
+*  ctx - PD Stack Context
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void test_differential(cy_stc_pdstack_context_t *ctx)
+{
+    static const uint32_t pdos[] = {
+        PDO_FIXED_5V, PDO_FIXED_9V, PDO_FIXED_28V, PDO_BATTERY, PDO_PPS, PDO_SPR_AVS, PDO_EPR_AVS,
+        PDO_VARIABLE
+    };
+    uint32_t avs_changed = 0u;
+    uint64_t start = host_time_ns();
+    uint64_t ns;
+    uint32_t iter;
+
+    for (iter = 0u; iter < RDO_RANDOM_CNT; iter++)
+    {
+        uint32_t rnd = next_rand();
+        cy_pd_pd_do_t pdo;
+        uint8_t obj_pos = (uint8_t)(1u + (rnd % 13u));
+        uint16_t volt = (uint16_t)((rnd >> 4u) % 1024u);
+        uint16_t cur = (uint16_t)((rnd >> 14u) % 501u);
+        uint32_t rdo;
+        uint32_t ref;
+        uint32_t legacy;
+
+        pdo.val = pdos[(rnd >> 24u) % (sizeof(pdos) / sizeof(pdos[0]))];
+        set_flags(ctx, ((rnd >> 27u) & 1u) ? CY_PD_REV3 : CY_PD_REV2, ((rnd >> 28u) & 1u) != 0u,
+                ((rnd >> 29u) & 1u) != 0u, ((rnd >> 30u) & 1u) != 0u);
+
+        rdo = pps_build_rdo(ctx, &pdo, obj_pos, volt, cur).val;
+        ref = ref_build_rdo(ctx, pdo.val, obj_pos, volt, cur);
+        legacy = legacy_build_rdo(ctx, &pdo, obj_pos, volt, cur).val;
+
+        CHECK_EQ(rdo, ref);
+        if (is_avs(pdo.val))
+        {
+            /* Only the AVS voltage changed, and only below the 100 mV step */
+            uint32_t legacy_volt = (legacy >> RDO_OUT_VOLT_POS) & RDO_OUT_VOLT_MASK;
+
+            CHECK_EQ(rdo & ~(RDO_OUT_VOLT_MASK << RDO_OUT_VOLT_POS), legacy & ~(RDO_OUT_VOLT_MASK << RDO_OUT_VOLT_POS));
+            CHECK_EQ((rdo >> RDO_OUT_VOLT_POS) & RDO_OUT_VOLT_MASK, legacy_volt & 0xFFCu);
+            if (rdo != legacy)
+            {
+                avs_changed++;
+            }
+            CHECK_EQ(rdo == legacy, (volt % 2u) == 0u);
+        }
+        else
+        {
+            CHECK_EQ(rdo, legacy);
+        }
+
+        if (gl_test_fail > 10u)
+        {
+            break;
+        }
+    }
+
+    ns = host_time_ns() - start;
+    CHECK(avs_changed != 0u);
+    printf("%u random vectors in %u ms, %u vectors/s\n", (unsigned)iter, (unsigned)(ns / 1000000u),
+            (unsigned)(((uint64_t)iter * 1000000000u) / ((ns != 0u) ? ns : 1u)));
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+
+    host_reset();
+
+    test_vectors(ctx);
+    test_differential(ctx);
+
+    return TEST_RESULT("rdo");
+}
+
+/* [] END OF FILE */
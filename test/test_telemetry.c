@@ -0,0 +1,314 @@
+/*******************************************************************************
+* File Name: test_telemetry.c
+*
+* Description:
+*  Host test of the telemetry link: CRC check value, frame layout, whole
+*  frame drops on a full ring and ring wrap. Writes a UART capture with
+*  injected line errors for the decoder, see tools/telemetry_decode.c.
+*  Reports the link load of telemetry_task and streams frames through a
+*  pseudo terminal standing in for the UART to measure the throughput of
+*  the ring and its interrupt handler in bytes/s.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "host_test.h"
+
+/* The static UART interrupt handler is run directly */
+#include "../src/telemetry.c"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Bytes streamed through the pseudo terminal */
+#define BENCH_PTY_BYTES                         (1024u * 1024u)
+
+/* Size of a frame of the bench */
+#define BENCH_FRAME_SIZE                        (TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: check_frame
+********************************************************************************
+* Summary:
+*  Checks the layout of a frame in the UART output
+*
+* Parameters:
+*  fr - Frame
+*  type - Expected frame type
+*  payload - Expected payload
+*  len - Expected payload length
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void check_frame(const uint8_t *fr, uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    uint16_t crc = crc16_update(CRC16_INIT, &fr[1], (uint32_t)len + 2u);
+
+    CHECK_EQ(fr[0], TELEMETRY_SYNC);
+    CHECK_EQ(fr[1], len);
+    CHECK_EQ(fr[2], type);
+    CHECK(memcmp(&fr[3], payload, len) == 0);
+    CHECK_EQ(fr[3u + len], (uint8_t)crc);
+    CHECK_EQ(fr[4u + len], (uint8_t)(crc >> 8u));
+}
+
+/*******************************************************************************
+* Function Name: write_capture
+********************************************************************************
+* Summary:
+*  Writes the UART output with line errors: noise with a stray sync byte
+*  first, a frame with a corrupted payload byte, and a truncated frame last
+*
+* Parameters:
+*  path - Output file
+*  start - Offset of the frames to write in the UART output
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void write_capture(const char *path, uint32_t start)
+{
+    static const uint8_t noise[6] = { 0x00u, TELEMETRY_SYNC, 0x40u, 0x13u, TELEMETRY_SYNC, 0xFFu };
+    uint8_t bad[TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD];
+    uint32_t size = (uint32_t)host_uart_tx[start + 1u] + TELEMETRY_FRAME_OVERHEAD;
+    FILE *f = fopen(path, "wb");
+
+    CHECK(f != NULL);
+    if (f != NULL)
+    {
+        memcpy(bad, &host_uart_tx[start], size);
+        bad[4] ^= 0x10u;
+
+        (void)fwrite(noise, 1u, sizeof(noise), f);
+        (void)fwrite(bad, 1u, size, f);
+        (void)fwrite(&host_uart_tx[start], 1u, host_uart_tx_len - start, f);
+        (void)fwrite(&host_uart_tx[start], 1u, size - 1u, f);
+        fclose(f);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_pty
+********************************************************************************
+* Summary:
+*  Streams full frames through a pseudo terminal standing in for the UART.
+*  The main loop side fills the ring, the interrupt handler moves it into
+*  the pseudo terminal, whose buffer limit acts as the TX FIFO, and the
+*  reader checks every frame.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void bench_pty(void)
+{
+    static uint8_t rx[TELEMETRY_RING_SIZE * 4u];
+    const stc_telemetry_stat_t *stat = telemetry_get_stat();
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    uint32_t sent = stat->bytesSent;
+    uint32_t queued = 0u;
+    uint32_t received = 0u;
+    uint32_t have = 0u;
+    uint8_t seq = 0u;
+    uint64_t start;
+    uint64_t ns;
+    char name[64];
+    ssize_t len;
+    int fd;
+
+    if (host_uart_open_pty(name, sizeof(name)) < 0)
+    {
+        printf("pty: not available on this host, throughput not measured\n");
+        return;
+    }
+    fd = open(name, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+    CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        host_uart_close_pty();
+        return;
+    }
+
+    memset(payload, 0x5A, sizeof(payload));
+    start = host_time_ns();
+    while ((received < BENCH_PTY_BYTES) && (gl_test_fail == 0u))
+    {
+        /* Main loop: queue frames while the ring has room for them */
+        while ((queued < BENCH_PTY_BYTES) &&
+                (((gl_tlm_tail - gl_tlm_head - 1u) & TELEMETRY_RING_MASK) >= BENCH_FRAME_SIZE))
+        {
+            payload[0] = (uint8_t)(queued / BENCH_FRAME_SIZE);
+            CHECK(telemetry_send(TELEMETRY_FRAME_VBUS, payload, TELEMETRY_MAX_PAYLOAD));
+            queued += BENCH_FRAME_SIZE;
+        }
+
+        /* TX FIFO level interrupt */
+        telemetry_uart_isr();
+
+        len = read(fd, &rx[have], sizeof(rx) - have);
+        if (len <= 0)
+        {
+            continue;
+        }
+        have += (uint32_t)len;
+        received += (uint32_t)len;
+        while (have >= BENCH_FRAME_SIZE)
+        {
+            payload[0] = seq++;
+            check_frame(rx, TELEMETRY_FRAME_VBUS, payload, TELEMETRY_MAX_PAYLOAD);
+            have -= BENCH_FRAME_SIZE;
+            memmove(rx, &rx[BENCH_FRAME_SIZE], have);
+        }
+    }
+    ns = host_time_ns() - start;
+
+    CHECK_EQ(received, queued);
+    CHECK_EQ(have, 0u);
+    CHECK_EQ(stat->bytesSent - sent, received);
+    CHECK(telemetry_is_idle());
+    printf("pty: %u frames, %u bytes in %u ms, %u bytes/s through the ring on the host\n",
+            (unsigned)(received / BENCH_FRAME_SIZE), (unsigned)received, (unsigned)(ns / 1000000u),
+            (unsigned)(((uint64_t)received * 1000000000u) / ((ns != 0u) ? ns : 1u)));
+
+    (void)close(fd);
+    host_uart_close_pty();
+}
+
+int main(int argc, char **argv)
+{
+    static const uint8_t check[9] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    const stc_telemetry_stat_t *stat = telemetry_get_stat();
+    cy_stc_pdstack_pd_packet_t pkt;
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD + 1u];
+    uint32_t start;
+    uint32_t i;
+
+    host_reset();
+    telemetry_init();
+
+    /* CRC-16/CCITT-FALSE check value */
+    CHECK_EQ(crc16_update(CRC16_INIT, check, sizeof(check)), 0x29B1u);
+
+    /* Frame layout */
+    for (i = 0u; i < sizeof(payload); i++)
+    {
+        payload[i] = (uint8_t)(i * 7u);
+    }
+    CHECK(telemetry_send(TELEMETRY_FRAME_CONTRACT, payload, 7u));
+    CHECK(telemetry_send(TELEMETRY_FRAME_PPS_STATUS, payload, 0u));
+    CHECK(!telemetry_send(TELEMETRY_FRAME_VBUS, payload, TELEMETRY_MAX_PAYLOAD + 1u));
+    telemetry_uart_isr();
+    CHECK_EQ(host_uart_tx_len, 7u + 0u + (2u * TELEMETRY_FRAME_OVERHEAD));
+    check_frame(&host_uart_tx[0], TELEMETRY_FRAME_CONTRACT, payload, 7u);
+    check_frame(&host_uart_tx[12], TELEMETRY_FRAME_PPS_STATUS, payload, 0u);
+    CHECK(telemetry_is_idle());
+
+    /* A full ring drops whole frames and keeps the queued ones intact */
+    host_uart_tx_len = 0u;
+    i = 0u;
+    while (telemetry_send(TELEMETRY_FRAME_VBUS, payload, TELEMETRY_MAX_PAYLOAD))
+    {
+        i++;
+    }
+    CHECK_EQ(i, (TELEMETRY_RING_SIZE - 1u) / (TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD));
+    CHECK_EQ(stat->framesDropped, 1u);
+    CHECK(!telemetry_is_idle());
+    telemetry_uart_isr();
+    CHECK_EQ(host_uart_tx_len, i * (TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD));
+    check_frame(&host_uart_tx[host_uart_tx_len - (TELEMETRY_MAX_PAYLOAD + TELEMETRY_FRAME_OVERHEAD)],
+            TELEMETRY_FRAME_VBUS, payload, TELEMETRY_MAX_PAYLOAD);
+
+    /* Frames that wrap around the end of the ring arrive in one piece */
+    host_uart_tx_len = 0u;
+    for (i = 0u; i < 40u; i++)
+    {
+        CHECK(telemetry_send(TELEMETRY_FRAME_CONTRACT, payload, (uint8_t)(i % 8u)));
+        telemetry_uart_isr();
+        check_frame(&host_uart_tx[host_uart_tx_len - ((i % 8u) + TELEMETRY_FRAME_OVERHEAD)],
+                TELEMETRY_FRAME_CONTRACT, payload, (uint8_t)(i % 8u));
+    }
+    CHECK_EQ(stat->bytesSent, stat->bytesQueued);
+
+    /* Reports from telemetry_task: contract, PPS status, then VBUS */
+    start = host_uart_tx_len;
+    ctx->dpmConfig.contractExist = true;
+    ctx->dpmStat.contract.curPwr = 300u;
+    ctx->dpmStat.contract.maxVolt = 9000u;
+    ctx->dpmStat.snkRdo.rdo_gen.objPos = 2u;
+    ctx->dpmStat.srcSelPdo.val = 0xC0DC213Cu;
+    memset(&pkt, 0, sizeof(pkt));
+    pkt.hdr.hdr.dataSize = 4u;
+    pkt.dat[0].val = 450u | (60uL << 16u) | ((uint32_t)PPS_STATUS_OMF_MASK << 24u);
+    pps_status_cb(ctx, CY_PDSTACK_RES_RCVD, &pkt);
+    host_vbus_mv[0] = 8980u;
+    vbus_evt_handler(ctx, APP_EVT_CONNECT, NULL);
+    for (i = 0u; i < TELEMETRY_PERIOD; i++)
+    {
+        host_advance_ms(1u);
+        vbus_meas_task(ctx);
+    }
+    telemetry_task(ctx);
+    telemetry_uart_isr();
+    CHECK_EQ(host_uart_tx_len - start, 7u + 4u + 10u + (3u * TELEMETRY_FRAME_OVERHEAD));
+    printf("telemetry_task: %u bytes every %u ms, %u bytes/s of link load\n", (unsigned)(host_uart_tx_len - start),
+            (unsigned)TELEMETRY_PERIOD, (unsigned)(((host_uart_tx_len - start) * 1000u) / TELEMETRY_PERIOD));
+
+    if (argc > 1)
+    {
+        write_capture(argv[1], start);
+    }
+
+    bench_pty();
+
+    return TEST_RESULT("telemetry");
+}
@@ -0,0 +1,206 @@
+/*******************************************************************************
+* File Name: test_timestamp.c
+*
+* Description:
+*  Host test of the extended timestamp across WDT counter wraps. Only a
+*  timer with a period beyond the wrap runs, like the PPS timer while nothing
+*  else is active. Checks that the refresh timer only runs while it is held,
+*  and reports the WDT interrupts and the longest WDT interrupt of a detached
+*  hour with the refresh timer always running and with it released.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "timestamp.h"
+#include "app_evt.h"
+#include "cy_pdutils_sw_timer.h"
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Length of the standby measurement in ms */
+#define STANDBY_TIME                            (3600u * 1000u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdutils_sw_timer_t gl_TimerCtx;
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/* Timestamp read from the long timer callback */
+static uint32_t gl_long_ts;
+
+/*******************************************************************************
+* Function Name: long_timer_cb
+********************************************************************************
+* Summary:
+*  Reads the timestamp every PPS_REQ_TIMER
+*
+* Parameters:
+*  id - Timer ID
+*  callbackContext - Not used
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void long_timer_cb(cy_timer_id_t id, void *callbackContext)
+{
+    gl_long_ts = timestamp_get_ticks();
+    Cy_PdUtils_SwTimer_Start(&gl_TimerCtx, callbackContext, id, PPS_REQ_TIMER, long_timer_cb);
+}
+
+/*******************************************************************************
+* Function Name: measure
+********************************************************************************
+* Summary:
+*  Measures PPS_REQ_TIMER periods with the timestamp
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint32_t - Shortest measured period in ms
+*
+*******************************************************************************/
+static uint32_t measure(void)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t prev = gl_long_ts;
+    uint32_t i;
+
+    for (i = 0u; i < 4u; i++)
+    {
+        host_advance_ms(PPS_REQ_TIMER);
+        if (TIMESTAMP_TICKS_TO_MS(gl_long_ts - prev) < min)
+        {
+            min = TIMESTAMP_TICKS_TO_MS(gl_long_ts - prev);
+        }
+        prev = gl_long_ts;
+    }
+
+    return min;
+}
+
+/*******************************************************************************
+* Function Name: standby
+********************************************************************************
+* Summary:
+*  Runs a detached hour with only the PPS timer besides the refresh timer
+*
+* Parameters:
+*  isr_cnt - Number of WDT interrupts
+*  isr_max_ns - Longest WDT interrupt in ns of host time
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void standby(uint32_t *isr_cnt, uint64_t *isr_max_ns)
+{
+    host_wdt_isr_cnt = 0u;
+    host_wdt_isr_max_ns = 0u;
+    host_advance_ms(STANDBY_TIME);
+    *isr_cnt = host_wdt_isr_cnt;
+    *isr_max_ns = host_wdt_isr_max_ns;
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    uint32_t before;
+    uint32_t after;
+    uint32_t isr_before;
+    uint32_t isr_after;
+    uint64_t ns_before;
+    uint64_t ns_after;
+
+    host_reset();
+    CHECK(PPS_REQ_TIMER > (0x10000u / TIMESTAMP_TICKS_PER_MS));
+
+    long_timer_cb((cy_timer_id_t)PPS_TIMER_ID, NULL);
+
+    /* Without the refresh timer, every wrap in between is lost */
+    before = measure();
+    CHECK_EQ(before, TIMESTAMP_TICKS_TO_MS((PPS_REQ_TIMER * TIMESTAMP_TICKS_PER_MS) - 0x10000u));
+
+    /* Nothing holds the refresh timer after init */
+    timestamp_init();
+    CHECK(!host_timer_running((cy_timer_id_t)TIMESTAMP_TIMER_ID));
+
+    /* An attached port holds it */
+    app_evt_dispatch(ctx, APP_EVT_CONNECT, NULL);
+    CHECK(host_timer_running((cy_timer_id_t)TIMESTAMP_TIMER_ID));
+    host_advance_ms(PPS_REQ_TIMER);
+    after = measure();
+    CHECK_EQ(after, PPS_REQ_TIMER);
+    printf("%u ms period measured as %u ms before, %u ms after\n", PPS_REQ_TIMER, (unsigned)before,
+            (unsigned)after);
+
+    /* The timer runs as long as any holder needs it */
+    timestamp_hold(TIMESTAMP_HOLD_STORE, true);
+    app_evt_dispatch(ctx, APP_EVT_DISCONNECT, NULL);
+    host_advance_ms(TIMESTAMP_REFRESH_PERIOD);
+    CHECK(host_timer_running((cy_timer_id_t)TIMESTAMP_TIMER_ID));
+    CHECK_EQ(measure(), PPS_REQ_TIMER);
+
+    /* Standby with the refresh timer always running, as before */
+    standby(&isr_before, &ns_before);
+
+    /* Released: stopped at its next expiry */
+    timestamp_hold(TIMESTAMP_HOLD_STORE, false);
+    host_advance_ms(TIMESTAMP_REFRESH_PERIOD);
+    CHECK(!host_timer_running((cy_timer_id_t)TIMESTAMP_TIMER_ID));
+    standby(&isr_after, &ns_after);
+    CHECK_EQ(isr_after, STANDBY_TIME / PPS_REQ_TIMER);
+    CHECK(isr_after < isr_before);
+
+    /* Held again: the wraps are tracked from the next read on */
+    timestamp_hold(TIMESTAMP_HOLD_BOOT, true);
+    CHECK(host_timer_running((cy_timer_id_t)TIMESTAMP_TIMER_ID));
+    CHECK_EQ(measure(), PPS_REQ_TIMER);
+
+    /* The WDT interrupt has the highest priority, so a USBPD interrupt waits for at most one of them */
+    printf("detached hour: %u WDT interrupts before, %u after; longest WDT interrupt %u ns before, %u ns after "
+            "on the host, which bounds the added USBPD latency\n", (unsigned)isr_before, (unsigned)isr_after,
+            (unsigned)ns_before, (unsigned)ns_after);
+
+    return TEST_RESULT("timestamp");
+}
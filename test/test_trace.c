@@ -0,0 +1,153 @@
+/*******************************************************************************
+* File Name: test_trace.c
+*
+* Description:
+*  Host test of the binary trace log. Records a known event sequence,
+*  checks the ring and the coalescing of repeated events and writes the
+*  log into a RAM dump image for the golden test of tools/trace_decode.
+*  
+*  Usage: test_trace <ram dump output>
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdio.h>
+#include "host_test.h"
+#include "trace.h"
+
+/*******************************************************************************
+* Function Name: write_dump
+********************************************************************************
+* Summary:
+*  Writes the trace log surrounded by unrelated RAM contents
+*
+* Parameters:
+*  path - Output file
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void write_dump(const char *path)
+{
+    static const uint8_t filler[36] = { 0x54u, 0x52u, 0x43u, 0x31u, 0xAAu, 0x55u };
+    FILE *f = fopen(path, "wb");
+
+    CHECK(f != NULL);
+    if (f != NULL)
+    {
+        /* The filler starts with a stray marker which the decoder must skip */
+        (void)fwrite(filler, 1u, sizeof(filler), f);
+        (void)fwrite(trace_get_log(), 1u, sizeof(stc_trace_log_t), f);
+        (void)fwrite(filler, 1u, sizeof(filler), f);
+        fclose(f);
+    }
+}
+
+/*******************************************************************************
+* Function Name: newest
+********************************************************************************
+* Summary:
+*  Returns the newest record of the trace log
+*
+* Parameters:
+*  None
+*
+* Return:
+*  stc_trace_record_t - Newest record
+*
+*******************************************************************************/
+static const stc_trace_record_t *newest(void)
+{
+    const stc_trace_log_t *log = trace_get_log();
+
+    return &log->rec[(log->count - 1u) % TRACE_BUF_DEPTH];
+}
+
+int main(int argc, char **argv)
+{
+    const stc_trace_log_t *log = trace_get_log();
+    uint32_t i;
+
+    host_reset();
+
+    CHECK_EQ(log->magic, TRACE_LOG_MAGIC);
+    CHECK_EQ(log->recSize, 12u);
+    CHECK_EQ(log->depth, TRACE_BUF_DEPTH);
+
+    /* Fill the ring once so that the sequence below overwrites the oldest records */
+    for (i = 0u; i < TRACE_BUF_DEPTH; i++)
+    {
+        host_advance_ms(1u);
+        trace_log(TRACE_EVT_CONTRACT_REQ, 0u, (uint16_t)(5000u + (i * 20u)), 2000u);
+    }
+    CHECK_EQ(log->count, TRACE_BUF_DEPTH);
+    CHECK_EQ(newest()->arg0, 5000u + ((TRACE_BUF_DEPTH - 1u) * 20u));
+
+    /* A request sequence as pps.c records it */
+    host_advance_ms(5u);
+    trace_log(TRACE_EVT_CONTRACT_REQ, 0u, 9000u, 3000u);
+    trace_log(TRACE_EVT_PDO_SELECT, 0u, 4u, 3u);
+    trace_log(TRACE_EVT_REQ_SENT, 0u, 0u, 0x4804B43Cu);
+    host_advance_ms(120u);
+    trace_log(TRACE_EVT_PPS_STATUS, 0u, 450u, 60u | (0x08u << 8u));
+
+    /* Repeated sleep entries collapse into one record */
+    trace_log_coalesce(TRACE_EVT_SLEEP, 0u, 0u);
+    trace_log_coalesce(TRACE_EVT_SLEEP, 0u, 0u);
+    trace_log_coalesce(TRACE_EVT_SLEEP, 0u, 0u);
+    CHECK_EQ(log->count, TRACE_BUF_DEPTH + 5u);
+    CHECK_EQ(newest()->id, TRACE_EVT_SLEEP);
+    CHECK_EQ(newest()->arg1, 3u);
+
+    /* A different event in between starts a new sleep record */
+    host_advance_ms(2u);
+    trace_log(TRACE_EVT_FAULT, 1u, 23u, 0u);
+    trace_log_coalesce(TRACE_EVT_SLEEP, 0u, 0u);
+    CHECK_EQ(log->count, TRACE_BUF_DEPTH + 7u);
+    CHECK_EQ(newest()->arg1, 1u);
+
+    if (argc > 1)
+    {
+        write_dump(argv[1]);
+    }
+
+    return TEST_RESULT("trace");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* File Name: test_vbus_meas.c
+*
+* Description:
+*  Host test of the VBUS measurement pipeline: median of three, IIR step
+*  *  response, spike rejection, block min/max, and sampling from the main loop
+*  *  rather than the timer interrupt.
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include "host_test.h"
+
+/* The static filters and their state are checked directly */
+#include "../src/vbus_meas.c"
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+extern cy_stc_pdstack_context_t gl_PdStackPort0Ctx;
+
+/*******************************************************************************
+* Function Name: median
+********************************************************************************
+* Summary:
+*  Loads the median filter history and returns its median
+*
+* Parameters:
+*  a, b, c - History, newest first
+*
+* Return:
+*  uint16_t - Median
+*
+*******************************************************************************/
+static uint16_t median(uint16_t a, uint16_t b, uint16_t c)
+{
+    gl_vbus_hist[0] = a;
+    gl_vbus_hist[1] = b;
+    gl_vbus_hist[2] = c;
+    return vbus_median3();
+}
+
+/*******************************************************************************
+* Function Name: run
+********************************************************************************
+* Summary:
+*  Runs the soft timers and the main loop task
+*
+* Parameters:
+*  ctx - PD Stack Context
+*  ms - Duration in ms
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void run(cy_stc_pdstack_context_t *ctx, uint32_t ms)
+{
+    while (ms-- != 0u)
+    {
+        host_advance_ms(1u);
+        vbus_meas_task(ctx);
+    }
+}
+
+int main(void)
+{
+    cy_stc_pdstack_context_t *ctx = &gl_PdStackPort0Ctx;
+    const uint32_t block = VBUS_MEAS_PERIOD * VBUS_MEAS_DECIMATION;
+    const stc_vbus_meas_t *meas;
+    double ref;
+    uint32_t i;
+
+    /* Median of three in every order */
+    CHECK_EQ(median(1u, 2u, 3u), 2u);
+    CHECK_EQ(median(1u, 3u, 2u), 2u);
+    CHECK_EQ(median(2u, 1u, 3u), 2u);
+    CHECK_EQ(median(2u, 3u, 1u), 2u);
+    CHECK_EQ(median(3u, 1u, 2u), 2u);
+    CHECK_EQ(median(3u, 2u, 1u), 2u);
+    CHECK_EQ(median(5u, 5u, 1u), 5u);
+    CHECK_EQ(median(1u, 5u, 5u), 5u);
+    CHECK_EQ(median(5u, 1u, 5u), 5u);
+
+    host_reset();
+    host_vbus_mv[0] = 5000u;
+    vbus_evt_handler(ctx, APP_EVT_CONNECT, NULL);
+
+    /* Nothing is published before the first block */
+    run(ctx, block - 1u);
+    CHECK_EQ(vbus_meas_get()->seq, 0u);
+    run(ctx, 1u);
+    meas = vbus_meas_get();
+    CHECK_EQ(meas->seq, 1u);
+    CHECK_EQ(meas->volt, 5000u);
+    CHECK_EQ(meas->minVolt, 5000u);
+    CHECK_EQ(meas->maxVolt, 5000u);
+
+    /* A single spike is removed by the median but shows in the block maximum */
+    host_vbus_mv[0] = 20000u;
+    run(ctx, VBUS_MEAS_PERIOD);
+    host_vbus_mv[0] = 4900u;
+    run(ctx, block - VBUS_MEAS_PERIOD);
+    meas = vbus_meas_get();
+    CHECK_EQ(meas->seq, 2u);
+    CHECK_EQ(meas->maxVolt, 20000u);
+    CHECK_EQ(meas->minVolt, 4900u);
+    CHECK(meas->volt <= 5000u);
+
+    /* Step response: the median delays the step by one sample, then the IIR
+     * approaches it by 1 / 2^VBUS_MEAS_IIR_SHIFT per sample */
+    host_vbus_mv[0] = 5000u;
+    run(ctx, 8u * block);
+    CHECK_EQ(vbus_meas_get()->volt, 5000u);
+    host_vbus_mv[0] = 9000u;
+    run(ctx, 2u * block);
+    ref = 5000.0;
+    for (i = 1u; i < (2u * VBUS_MEAS_DECIMATION); i++)
+    {
+        ref += (9000.0 - ref) / (1u << VBUS_MEAS_IIR_SHIFT);
+    }
+    meas = vbus_meas_get();
+    CHECK((meas->volt >= (ref - 2.0)) && (meas->volt <= (ref + 2.0)));
+    CHECK_EQ(meas->minVolt, 9000u);
+    run(ctx, 20u * block);
+    CHECK(vbus_meas_get()->volt >= 8998u);
+
+    /* Conversions are made from the main loop only */
+    CHECK_EQ(host_isr_adc_cnt, 0u);
+
+    /* Samples posted while the main loop was busy are dropped, not queued */
+    gl_vbus_decim = 0u;
+    host_advance_ms(5u * VBUS_MEAS_PERIOD);
+    CHECK_EQ(host_isr_adc_cnt, 0u);
+    vbus_meas_task(ctx);
+    vbus_meas_task(ctx);
+    CHECK_EQ(gl_vbus_decim, 1u);
+
+    /* Detach stops the pipeline */
+    vbus_evt_handler(ctx, APP_EVT_DISCONNECT, NULL);
+    run(ctx, 2u * block);
+    CHECK_EQ(gl_vbus_decim, 0u);
+
+    return TEST_RESULT("vbus_meas");
+}
@@ -0,0 +1,277 @@
+/*******************************************************************************
+* File Name: telemetry_decode.c
+*
+* Description:
+*  Host decoder for the binary UART telemetry link (see src/telemetry.h).
+*  *  Reads a capture of the UART stream, resynchronizes on the sync byte and
+*  *  prints the frames whose CRC matches. Bytes that do not belong to a valid
+*  *  frame are skipped and counted.
+*  *  
+*  *  Usage: telemetry_decode <capture> [ticks per ms]
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Frame format, must match src/telemetry.h */
+#define TLM_SYNC                                (0xA5u)
+#define TLM_MAX_PAYLOAD                         (32u)
+#define TLM_FRAME_OVERHEAD                      (5u)
+
+/* CRC-16 of src/crc16.c */
+#define TLM_CRC_POLY                            (0x1021u)
+#define TLM_CRC_INIT                            (0xFFFFu)
+
+/* Default TIMESTAMP_TICKS_PER_MS of the firmware */
+#define TLM_DEF_TICKS_PER_MS                    (40u)
+
+/* Largest capture accepted */
+#define TLM_MAX_CAPTURE                         (1024u * 1024u)
+
+/*******************************************************************************
+* Function Name: rd16
+********************************************************************************
+* Summary:
+*  Reads a little endian 16-bit value from a payload
+*
+* Parameters:
+*  p - Location in the payload
+*
+* Return:
+*  uint16_t - Value
+*
+*******************************************************************************/
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+/*******************************************************************************
+* Function Name: rd32
+********************************************************************************
+* Summary:
+*  Reads a little endian 32-bit value from a payload
+*
+* Parameters:
+*  p - Location in the payload
+*
+* Return:
+*  uint32_t - Value
+*
+*******************************************************************************/
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+* Function Name: crc16
+********************************************************************************
+* Summary:
+*  Computes the frame CRC
+*
+* Parameters:
+*  data - Data
+*  len - Length of data in bytes
+*
+* Return:
+*  uint16_t - CRC value
+*
+*******************************************************************************/
+static uint16_t crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = TLM_CRC_INIT;
+    uint8_t bit;
+
+    while (len-- != 0u)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+        for (bit = 0u; bit < 8u; bit++)
+        {
+            crc = ((crc & 0x8000u) != 0u) ? (uint16_t)((crc << 1) ^ TLM_CRC_POLY) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: print_frame
+********************************************************************************
+* Summary:
+*  Prints a frame in the units of its type
+*
+* Parameters:
+*  type - Frame type
+*  p - Payload
+*  len - Payload length
+*  ticks_per_ms - Timestamp ticks per ms
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void print_frame(uint8_t type, const uint8_t *p, uint8_t len, uint32_t ticks_per_ms)
+{
+    uint32_t ts;
+
+    if ((type == 1u) && (len == 7u))
+    {
+        printf("CONTRACT    P%u pdo=%u supply type %u volt=%u mV cur=%u mA", p[0], p[1], p[2],
+                rd16(&p[3]), rd16(&p[5]));
+    }
+    else if ((type == 2u) && (len == 10u))
+    {
+        ts = rd32(&p[0]);
+        printf("VBUS        %10u.%03u ms volt=%u mV min=%u mV max=%u mV", (unsigned)(ts / ticks_per_ms),
+                (unsigned)(((ts % ticks_per_ms) * 1000u) / ticks_per_ms), rd16(&p[4]), rd16(&p[6]), rd16(&p[8]));
+    }
+    else if ((type == 3u) && (len == 4u))
+    {
+        printf("PPS_STATUS  ");
+        if (rd16(&p[0]) == 0xFFFFu)
+        {
+            printf("volt=n/a");
+        }
+        else
+        {
+            printf("volt=%u mV", rd16(&p[0]) * 20u);
+        }
+        if (p[2] == 0xFFu)
+        {
+            printf(" cur=n/a");
+        }
+        else
+        {
+            printf(" cur=%u mA", p[2] * 50u);
+        }
+        printf(" flags=0x%02x%s", p[3], ((p[3] & 0x08u) != 0u) ? " CL" : "");
+    }
+    else
+    {
+        printf("TYPE %-6u len=%u", type, len);
+    }
+    printf("\n");
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Decodes all frames of a UART capture
+*
+* Parameters:
+*  argc, argv - Command line, see the file description
+*
+* Return:
+*  0 if the capture could be read, 1 otherwise
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static uint8_t cap[TLM_MAX_CAPTURE];
+    uint32_t ticks_per_ms = TLM_DEF_TICKS_PER_MS;
+    uint32_t frames = 0u;
+    uint32_t skipped = 0u;
+    uint32_t crc_err = 0u;
+    size_t len;
+    size_t off = 0u;
+    FILE *f;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "usage: %s <capture> [ticks per ms]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 3)
+    {
+        ticks_per_ms = (uint32_t)strtoul(argv[2], NULL, 0);
+        if (ticks_per_ms == 0u)
+        {
+            ticks_per_ms = TLM_DEF_TICKS_PER_MS;
+        }
+    }
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    len = fread(cap, 1u, sizeof(cap), f);
+    fclose(f);
+
+    while (off < len)
+    {
+        const uint8_t *fr = &cap[off];
+        size_t size;
+
+        /* A frame starts at a sync byte with a valid length, is complete and
+         * has a matching CRC. Anything else moves on by one byte. */
+        if ((fr[0] != TLM_SYNC) || ((off + 2u) > len) || (fr[1] > TLM_MAX_PAYLOAD) ||
+            ((off + fr[1] + TLM_FRAME_OVERHEAD) > len))
+        {
+            skipped++;
+            off++;
+            continue;
+        }
+
+        size = (size_t)fr[1] + TLM_FRAME_OVERHEAD;
+        if (crc16(&fr[1], (size_t)fr[1] + 2u) != rd16(&fr[size - 2u]))
+        {
+            crc_err++;
+            skipped++;
+            off++;
+            continue;
+        }
+
+        printf("%8zu  ", off);
+        print_frame(fr[2], &fr[3], fr[1], ticks_per_ms);
+        frames++;
+        off += size;
+    }
+
+    printf("%u frames, %u bytes skipped, %u CRC errors\n", (unsigned)frames, (unsigned)skipped, (unsigned)crc_err);
+    return 0;
+}
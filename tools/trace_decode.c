@@ -0,0 +1,271 @@
+/*******************************************************************************
+* File Name: trace_decode.c
+*
+* Description:
+*  Host decoder for the binary trace log (see src/trace.h). Locates the log
+*  in a RAM dump by its marker and prints the records oldest first.
+*  
+*  Usage: trace_decode <ram dump> [ticks per ms]
+*
+* Related Document: See README.md
+*
+*******************************************************************************
+* Copyright 2023-2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+ * Header files
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * Macro definitions
+ ******************************************************************************/
+/* Record format, must match stc_trace_log_t and stc_trace_record_t */
+#define TRACE_LOG_MAGIC                         (0x31435254u)
+#define TRACE_HDR_SIZE                          (12u)
+#define TRACE_REC_SIZE                          (12u)
+
+/* Default TIMESTAMP_TICKS_PER_MS of the firmware */
+#define TRACE_DEF_TICKS_PER_MS                  (40u)
+
+/* Largest RAM dump accepted */
+#define TRACE_MAX_DUMP                          (1024u * 1024u)
+
+/******************************************************************************
+ * Global variables declaration
+ ******************************************************************************/
+/* Event names, indexed by en_trace_evt_t */
+static const char *const gl_evt_names[] =
+{
+    "NONE",
+    "CONTRACT_REQ",
+    "PDO_SELECT",
+    "REQ_SENT",
+    "PPS_STATUS",
+    "PD_EVENT",
+    "FAULT",
+    "SLEEP",
+};
+
+/*******************************************************************************
+* Function Name: rd16
+********************************************************************************
+* Summary:
+*  Reads a little endian 16-bit value from the dump
+*
+* Parameters:
+*  p - Location in the dump
+*
+* Return:
+*  uint16_t - Value
+*
+*******************************************************************************/
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+/*******************************************************************************
+* Function Name: rd32
+********************************************************************************
+* Summary:
+*  Reads a little endian 32-bit value from the dump
+*
+* Parameters:
+*  p - Location in the dump
+*
+* Return:
+*  uint32_t - Value
+*
+*******************************************************************************/
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+* Function Name: print_args
+********************************************************************************
+* Summary:
+*  Prints the arguments of a record in the units of its event
+*
+* Parameters:
+*  id - Event ID
+*  arg0 - First event argument
+*  arg1 - Second event argument
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void print_args(uint8_t id, uint16_t arg0, uint32_t arg1)
+{
+    switch (id)
+    {
+        case 0x01:
+            printf("volt=%u mV cur=%u mA", arg0, (unsigned)arg1);
+            break;
+        case 0x02:
+            if (arg0 == 0u)
+            {
+                printf("no match, supply type %u", (unsigned)arg1);
+            }
+            else
+            {
+                printf("pdo=%u supply type %u", arg0, (unsigned)arg1);
+            }
+            break;
+        case 0x03:
+            printf("status=%d rdo=0x%08x", (int)(int16_t)arg0, (unsigned)arg1);
+            break;
+        case 0x04:
+            if (arg0 == 0xFFFFu)
+            {
+                printf("volt=n/a");
+            }
+            else
+            {
+                printf("volt=%u mV", arg0 * 20u);
+            }
+            if ((arg1 & 0xFFu) == 0xFFu)
+            {
+                printf(" cur=n/a");
+            }
+            else
+            {
+                printf(" cur=%u mA", (unsigned)(arg1 & 0xFFu) * 50u);
+            }
+            printf(" flags=0x%02x%s", (unsigned)((arg1 >> 8) & 0xFFu), (((arg1 >> 8) & 0x08u) != 0u) ? " CL" : "");
+            break;
+        case 0x05:
+        case 0x06:
+            printf("app evt %u", arg0);
+            break;
+        case 0x07:
+            printf("x%u", (unsigned)arg1);
+            break;
+        default:
+            printf("arg0=0x%04x arg1=0x%08x", arg0, (unsigned)arg1);
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Decodes the first trace log found in a RAM dump
+*
+* Parameters:
+*  argc, argv - Command line, see the file description
+*
+* Return:
+*  0 if a log was found, 1 otherwise
+*
+*******************************************************************************/
+int main(int argc, char **argv)
+{
+    static uint8_t dump[TRACE_MAX_DUMP];
+    uint32_t ticks_per_ms = TRACE_DEF_TICKS_PER_MS;
+    size_t len;
+    size_t off;
+    FILE *f;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "usage: %s <ram dump> [ticks per ms]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 3)
+    {
+        ticks_per_ms = (uint32_t)strtoul(argv[2], NULL, 0);
+        if (ticks_per_ms == 0u)
+        {
+            ticks_per_ms = TRACE_DEF_TICKS_PER_MS;
+        }
+    }
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    len = fread(dump, 1u, sizeof(dump), f);
+    fclose(f);
+
+    for (off = 0u; (off + TRACE_HDR_SIZE) <= len; off += 4u)
+    {
+        uint16_t depth;
+        uint32_t count;
+        uint32_t first;
+        uint32_t n;
+
+        if ((rd32(&dump[off]) != TRACE_LOG_MAGIC) || (rd16(&dump[off + 6u]) != TRACE_REC_SIZE))
+        {
+            continue;
+        }
+
+        depth = rd16(&dump[off + 4u]);
+        count = rd32(&dump[off + 8u]);
+        if ((depth == 0u) || ((depth & (depth - 1u)) != 0u) ||
+            ((off + TRACE_HDR_SIZE + ((size_t)depth * TRACE_REC_SIZE)) > len))
+        {
+            continue;
+        }
+
+        first = (count > depth) ? (count - depth) : 0u;
+        printf("trace log at 0x%zx: %u records, %u lost\n", off, (unsigned)count, (unsigned)first);
+
+        for (n = first; n < count; n++)
+        {
+            const uint8_t *rec = &dump[off + TRACE_HDR_SIZE + ((size_t)(n & (depth - 1u)) * TRACE_REC_SIZE)];
+            uint32_t ts = rd32(rec);
+            uint8_t id = rec[4];
+
+            printf("%10u.%03u ms  P%u  %-12s ", (unsigned)(ts / ticks_per_ms),
+                    (unsigned)(((ts % ticks_per_ms) * 1000u) / ticks_per_ms), rec[5],
+                    (id < (sizeof(gl_evt_names) / sizeof(gl_evt_names[0]))) ? gl_evt_names[id] : "?");
+            print_args(id, rd16(&rec[6]), rd32(&rec[8]));
+            printf("\n");
+        }
+        return 0;
+    }
+
+    fprintf(stderr, "no trace log found\n");
+    return 1;
+}
+
+/* [] END OF FILE */